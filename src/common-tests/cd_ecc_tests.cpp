@@ -0,0 +1,173 @@
+#include "util/cd_ecc.h"
+#include "util/cd_image.h"
+#include <array>
+#include <cstring>
+#include <gtest/gtest.h>
+
+using Sector = std::array<u8, CDImage::RAW_SECTOR_SIZE>;
+
+// Byte at a time EDC/ECC from unecm.c, which the table driven versions have to match.
+namespace Reference {
+
+static u8 MultiplyAlpha(u8 value)
+{
+  return static_cast<u8>((value << 1) ^ ((value & 0x80) ? 0x1D : 0));
+}
+
+static u8 DivideAlphaPlusOne(u8 value)
+{
+  for (u32 i = 0; i < 256; i++)
+  {
+    if ((i ^ MultiplyAlpha(static_cast<u8>(i))) == value)
+      return static_cast<u8>(i);
+  }
+  return 0;
+}
+
+static void ComputeEDC(const u8* src, u32 size, u8* dest)
+{
+  u32 edc = 0;
+  for (u32 i = 0; i < size; i++)
+  {
+    edc ^= src[i];
+    for (u32 bit = 0; bit < 8; bit++)
+      edc = (edc >> 1) ^ ((edc & 1) ? 0xD8018001 : 0);
+  }
+  for (u32 i = 0; i < 4; i++)
+    dest[i] = static_cast<u8>(edc >> (i * 8));
+}
+
+static void ComputeECC(const u8* src, u32 major_count, u32 minor_count, u32 major_mult, u32 minor_inc, u8* dest)
+{
+  const u32 size = major_count * minor_count;
+  for (u32 major = 0; major < major_count; major++)
+  {
+    u32 index = (major >> 1) * major_mult + (major & 1);
+    u8 ecc_a = 0;
+    u8 ecc_b = 0;
+    for (u32 minor = 0; minor < minor_count; minor++)
+    {
+      const u8 temp = src[index];
+      index += minor_inc;
+      if (index >= size)
+        index -= size;
+      ecc_a = MultiplyAlpha(ecc_a ^ temp);
+      ecc_b ^= temp;
+    }
+    ecc_a = DivideAlphaPlusOne(MultiplyAlpha(ecc_a) ^ ecc_b);
+    dest[major] = ecc_a;
+    dest[major + major_count] = ecc_a ^ ecc_b;
+  }
+}
+
+static void GenerateECC(u8* sector, bool zero_address)
+{
+  u8 address[4];
+  std::memcpy(address, sector + 12, sizeof(address));
+  if (zero_address)
+    std::memset(sector + 12, 0, sizeof(address));
+  ComputeECC(sector + 0xC, 86, 24, 2, 86, sector + 0x81C);
+  ComputeECC(sector + 0xC, 52, 43, 86, 88, sector + 0x8C8);
+  std::memcpy(sector + 12, address, sizeof(address));
+}
+
+static void GenerateEDCECC(u8* sector, CDECC::SectorType type)
+{
+  switch (type)
+  {
+    case CDECC::SectorType::Mode1:
+      ComputeEDC(sector, 0x810, sector + 0x810);
+      std::memset(sector + 0x814, 0, 8);
+      GenerateECC(sector, false);
+      break;
+    case CDECC::SectorType::Mode2Form1:
+      ComputeEDC(sector + 0x10, 0x808, sector + 0x818);
+      GenerateECC(sector, true);
+      break;
+    case CDECC::SectorType::Mode2Form2:
+      ComputeEDC(sector + 0x10, 0x91C, sector + 0x92C);
+      break;
+  }
+}
+
+} // namespace Reference
+
+// Builds a sector with a valid sync/header and pseudo-random contents, so every byte feeds into the EDC/ECC.
+static Sector CreateSector(CDECC::SectorType type, u32 seed)
+{
+  Sector sector;
+  u32 state = seed * 2654435761u + 1;
+  for (u8& value : sector)
+  {
+    state = state * 1664525u + 1013904223u;
+    value = static_cast<u8>(state >> 24);
+  }
+
+  static constexpr u8 sync[CDImage::SECTOR_SYNC_SIZE] = {0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                                         0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00};
+  std::memcpy(sector.data(), sync, sizeof(sync));
+  sector[0x0F] = (type == CDECC::SectorType::Mode1) ? 0x01 : 0x02;
+  if (type != CDECC::SectorType::Mode1)
+  {
+    // subheader is stored twice
+    const u8 submode = (type == CDECC::SectorType::Mode2Form2) ? 0x20 : 0x08;
+    sector[0x12] = submode;
+    sector[0x16] = submode;
+  }
+
+  CDECC::ClearEDCECC(sector.data(), type);
+  return sector;
+}
+
+static void CheckAgainstReference(CDECC::SectorType type)
+{
+  for (u32 seed = 0; seed < 64; seed++)
+  {
+    Sector expected = CreateSector(type, seed);
+    Sector generated = expected;
+    Reference::GenerateEDCECC(expected.data(), type);
+    CDECC::GenerateEDCECC(generated.data(), type);
+    ASSERT_EQ(generated, expected) << "seed " << seed;
+    ASSERT_TRUE(CDECC::IsEDCECCRegenerable(generated.data(), type)) << "seed " << seed;
+  }
+}
+
+TEST(CDECC, Mode1MatchesReference)
+{
+  CheckAgainstReference(CDECC::SectorType::Mode1);
+}
+
+TEST(CDECC, Mode2Form1MatchesReference)
+{
+  CheckAgainstReference(CDECC::SectorType::Mode2Form1);
+}
+
+TEST(CDECC, Mode2Form2MatchesReference)
+{
+  CheckAgainstReference(CDECC::SectorType::Mode2Form2);
+}
+
+TEST(CDECC, GetSectorType)
+{
+  for (const CDECC::SectorType type :
+       {CDECC::SectorType::Mode1, CDECC::SectorType::Mode2Form1, CDECC::SectorType::Mode2Form2})
+  {
+    const Sector sector = CreateSector(type, 1);
+    CDECC::SectorType detected;
+    ASSERT_TRUE(CDECC::GetSectorType(sector.data(), &detected));
+    ASSERT_EQ(detected, type);
+  }
+
+  Sector audio = CreateSector(CDECC::SectorType::Mode1, 1);
+  audio[0] = 0x12;
+  CDECC::SectorType detected;
+  ASSERT_FALSE(CDECC::GetSectorType(audio.data(), &detected));
+}
+
+TEST(CDECC, CorruptedSectorIsNotRegenerable)
+{
+  Sector sector = CreateSector(CDECC::SectorType::Mode2Form1, 2);
+  CDECC::GenerateEDCECC(sector.data(), CDECC::SectorType::Mode2Form1);
+  sector[0x100] ^= 0x01;
+  ASSERT_FALSE(CDECC::IsEDCECCRegenerable(sector.data(), CDECC::SectorType::Mode2Form1));
+}
@@ -0,0 +1,66 @@
+#include "common/lru_cache.h"
+#include <gtest/gtest.h>
+
+using IntCache = LRUCache<int, int>;
+
+static IntCache CreateCache(std::size_t capacity, std::initializer_list<int> keys)
+{
+  IntCache cache(capacity);
+  for (const int key : keys)
+    cache.Insert(key, key * 10);
+  return cache;
+}
+
+TEST(LRUCache, EvictRemovesLeastRecentlyUsed)
+{
+  IntCache cache = CreateCache(4, {1, 2, 3});
+  ASSERT_NE(cache.Lookup(1), nullptr);
+
+  cache.Evict();
+  ASSERT_EQ(cache.GetSize(), 2u);
+  ASSERT_EQ(cache.Lookup(2), nullptr);
+  ASSERT_NE(cache.Lookup(1), nullptr);
+  ASSERT_NE(cache.Lookup(3), nullptr);
+}
+
+TEST(LRUCache, EvictRemovesRequestedCount)
+{
+  IntCache cache = CreateCache(8, {1, 2, 3, 4, 5});
+  ASSERT_NE(cache.Lookup(2), nullptr);
+
+  cache.Evict(3);
+  ASSERT_EQ(cache.GetSize(), 2u);
+  ASSERT_NE(cache.Lookup(2), nullptr);
+  ASSERT_NE(cache.Lookup(5), nullptr);
+}
+
+TEST(LRUCache, EvictMoreThanSizeEmptiesCache)
+{
+  IntCache cache = CreateCache(4, {1, 2});
+  cache.Evict(3);
+  ASSERT_EQ(cache.GetSize(), 0u);
+}
+
+TEST(LRUCache, InsertAtCapacityEvictsOne)
+{
+  IntCache cache = CreateCache(3, {1, 2, 3});
+  ASSERT_NE(cache.Lookup(1), nullptr);
+
+  cache.Insert(4, 40);
+  ASSERT_EQ(cache.GetSize(), 3u);
+  ASSERT_EQ(cache.Lookup(2), nullptr);
+  ASSERT_EQ(*cache.Lookup(1), 10);
+  ASSERT_EQ(*cache.Lookup(3), 30);
+  ASSERT_EQ(*cache.Lookup(4), 40);
+}
+
+TEST(LRUCache, ShrinkingCapacityEvictsOldest)
+{
+  IntCache cache = CreateCache(4, {1, 2, 3, 4});
+  ASSERT_NE(cache.Lookup(1), nullptr);
+
+  cache.SetMaxCapacity(2);
+  ASSERT_EQ(cache.GetSize(), 2u);
+  ASSERT_NE(cache.Lookup(1), nullptr);
+  ASSERT_NE(cache.Lookup(4), nullptr);
+}
@@ -69,7 +69,7 @@ public:
 
   void Evict(std::size_t count = 1)
   {
-    while (m_items.size() >= count)
+    for (std::size_t i = 0; i < count && !m_items.empty(); i++)
     {
       typename MapType::iterator lowest = m_items.end();
       for (auto iter = m_items.begin(); iter != m_items.end(); ++iter)
@@ -75,15 +75,6 @@ static bool ValidatePipelineCacheHeader(const VK_PIPELINE_CACHE_HEADER& header)
   return true;
 }
 
-static void FillPipelineCacheHeader(VK_PIPELINE_CACHE_HEADER* header)
-{
-  header->header_length = sizeof(VK_PIPELINE_CACHE_HEADER);
-  header->header_version = VK_PIPELINE_CACHE_HEADER_VERSION_ONE;
-  header->vendor_id = g_vulkan_context->GetDeviceProperties().vendorID;
-  header->device_id = g_vulkan_context->GetDeviceProperties().deviceID;
-  std::memcpy(header->uuid, g_vulkan_context->GetDeviceProperties().pipelineCacheUUID, VK_UUID_SIZE);
-}
-
 ShaderCache::ShaderCache() = default;
 
 ShaderCache::~ShaderCache()
@@ -117,6 +108,30 @@ void ShaderCache::Destroy()
   g_vulkan_shader_cache.reset();
 }
 
+std::unique_ptr<ShaderCache> ShaderCache::OpenSPIRVCache(std::string_view base_path, u32 version, bool debug)
+{
+  std::unique_ptr<ShaderCache> cache(new ShaderCache());
+  cache->m_version = version;
+  cache->m_debug = debug;
+
+  const std::string base_filename = GetShaderCacheBaseFileName(base_path, debug);
+  const std::string index_filename = base_filename + ".idx";
+  const std::string blob_filename = base_filename + ".bin";
+  if (!cache->ReadExistingShaderCache(index_filename, blob_filename) &&
+      !cache->CreateNewShaderCache(index_filename, blob_filename))
+  {
+    return {};
+  }
+
+  return cache;
+}
+
+u32 ShaderCache::GetShaderCount()
+{
+  std::unique_lock lock(m_mutex);
+  return static_cast<u32>(m_index.size());
+}
+
 void ShaderCache::Open(std::string_view base_path, u32 version, bool debug)
 {
   m_version = version;
@@ -172,12 +187,8 @@ bool ShaderCache::CreateNewShaderCache(const std::string& index_filename, const
   }
 
   const u32 index_version = FILE_VERSION;
-  VK_PIPELINE_CACHE_HEADER header;
-  FillPipelineCacheHeader(&header);
-
   if (std::fwrite(&index_version, sizeof(index_version), 1, m_index_file) != 1 ||
-      std::fwrite(&m_version, sizeof(m_version), 1, m_index_file) != 1 ||
-      std::fwrite(&header, sizeof(header), 1, m_index_file) != 1)
+      std::fwrite(&m_version, sizeof(m_version), 1, m_index_file) != 1)
   {
     Log_ErrorPrintf("Failed to write header to index file '%s'", index_filename.c_str());
     std::fclose(m_index_file);
@@ -216,15 +227,6 @@ bool ShaderCache::ReadExistingShaderCache(const std::string& index_filename, con
     return false;
   }
 
-  VK_PIPELINE_CACHE_HEADER header;
-  if (std::fread(&header, sizeof(header), 1, m_index_file) != 1 || !ValidatePipelineCacheHeader(header))
-  {
-    Log_ErrorPrintf("Mismatched pipeline cache header in '%s' (GPU/driver changed?)", index_filename.c_str());
-    std::fclose(m_index_file);
-    m_index_file = nullptr;
-    return false;
-  }
-
   m_blob_file = FileSystem::OpenCFile(blob_filename.c_str(), "a+b");
   if (!m_blob_file)
   {
@@ -430,14 +432,20 @@ std::optional<ShaderCompiler::SPIRVCodeVector> ShaderCache::GetShaderSPV(ShaderC
                                                                          std::string_view shader_code)
 {
   const auto key = GetCacheKey(type, shader_code);
+
+  std::unique_lock lock(m_mutex);
   auto iter = m_index.find(key);
   if (iter == m_index.end())
+  {
+    lock.unlock();
     return CompileAndAddShaderSPV(key, shader_code);
+  }
 
   SPIRVCodeVector spv(iter->second.blob_size);
   if (std::fseek(m_blob_file, iter->second.file_offset, SEEK_SET) != 0 ||
       std::fread(spv.data(), sizeof(SPIRVCodeType), iter->second.blob_size, m_blob_file) != iter->second.blob_size)
   {
+    lock.unlock();
     Log_ErrorPrintf("Read blob from file failed, recompiling");
     return ShaderCompiler::CompileShader(type, shader_code, m_debug);
   }
@@ -492,6 +500,12 @@ std::optional<ShaderCompiler::SPIRVCodeVector> ShaderCache::CompileAndAddShaderS
   if (!spv.has_value())
     return {};
 
+  std::unique_lock lock(m_mutex);
+
+  // another thread may have compiled the same shader in the meantime
+  if (m_index.find(key) != m_index.end())
+    return spv;
+
   if (!m_blob_file || std::fseek(m_blob_file, 0, SEEK_END) != 0)
     return spv;
 
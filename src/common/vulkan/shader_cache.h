@@ -5,6 +5,7 @@
 #include "shader_compiler.h"
 #include <cstdio>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -21,12 +22,16 @@ public:
   static void Create(std::string_view base_path, u32 version, bool debug);
   static void Destroy();
 
+  /// Opens only the SPIR-V cache, without a device or pipeline cache. Used to populate the cache offline.
+  static std::unique_ptr<ShaderCache> OpenSPIRVCache(std::string_view base_path, u32 version, bool debug);
+
   /// Returns a handle to the pipeline cache. Set set_dirty to true if you are planning on writing to it externally.
   VkPipelineCache GetPipelineCache(bool set_dirty = true);
 
   /// Writes pipeline cache to file, saving all newly compiled pipelines.
   bool FlushPipelineCache();
 
+  /// Shader lookups and compilation are thread-safe, so independent shaders can be compiled in parallel.
   std::optional<ShaderCompiler::SPIRVCodeVector> GetShaderSPV(ShaderCompiler::Type type, std::string_view shader_code);
   VkShaderModule GetShaderModule(ShaderCompiler::Type type, std::string_view shader_code);
 
@@ -35,8 +40,12 @@ public:
   VkShaderModule GetFragmentShader(std::string_view shader_code);
   VkShaderModule GetComputeShader(std::string_view shader_code);
 
+  /// Returns the number of shaders currently stored in the cache.
+  u32 GetShaderCount();
+
 private:
-  static constexpr u32 FILE_VERSION = 2;
+  // SPIR-V does not depend on the device, so the index is not tied to the device/driver like the pipeline cache.
+  static constexpr u32 FILE_VERSION = 3;
 
   struct CacheIndexKey
   {
@@ -92,6 +101,9 @@ private:
 
   CacheIndex m_index;
 
+  // Protects the index and the blob/index files. Not held while compiling.
+  std::mutex m_mutex;
+
   VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
   u32 m_version = 0;
   bool m_debug = false;
@@ -8,9 +8,11 @@
 #include "../log.h"
 #include "../string_util.h"
 #include "util.h"
+#include <atomic>
 #include <cstring>
 #include <fstream>
 #include <memory>
+#include <mutex>
 Log_SetChannel(Vulkan::ShaderCompiler);
 
 // glslang includes
@@ -22,9 +24,10 @@ namespace Vulkan::ShaderCompiler {
 // Registers itself for cleanup via atexit
 bool InitializeGlslang();
 
-static unsigned s_next_bad_shader_id = 1;
+static std::atomic<unsigned> s_next_bad_shader_id{1};
 
-static bool glslang_initialized = false;
+static std::mutex glslang_init_mutex;
+static std::atomic_bool glslang_initialized{false};
 
 static std::optional<SPIRVCodeVector> CompileShaderToSPV(EShLanguage stage, const char* stage_filename,
                                                          std::string_view source)
@@ -45,7 +48,7 @@ static std::optional<SPIRVCodeVector> CompileShaderToSPV(EShLanguage stage, cons
   shader->setStringsWithLengths(&pass_source_code, &pass_source_code_length, 1);
 
   auto DumpBadShader = [&](const char* msg) {
-    std::string filename = StringUtil::StdStringFromFormat("bad_shader_%u.txt", s_next_bad_shader_id++);
+    std::string filename = StringUtil::StdStringFromFormat("bad_shader_%u.txt", s_next_bad_shader_id.fetch_add(1));
     Log::Writef("Vulkan", "CompileShaderToSPV", LOGLEVEL_ERROR, "%s, writing to %s", msg, filename.c_str());
 
     std::ofstream ofs(filename.c_str(), std::ofstream::out | std::ofstream::binary);
@@ -115,7 +118,11 @@ static std::optional<SPIRVCodeVector> CompileShaderToSPV(EShLanguage stage, cons
 
 bool InitializeGlslang()
 {
-  if (glslang_initialized)
+  if (glslang_initialized.load(std::memory_order_acquire))
+    return true;
+
+  std::unique_lock lock(glslang_init_mutex);
+  if (glslang_initialized.load(std::memory_order_relaxed))
     return true;
 
   if (!glslang::InitializeProcess())
@@ -126,17 +133,18 @@ bool InitializeGlslang()
 
   std::atexit([]() { glslang::FinalizeProcess(); });
 
-  glslang_initialized = true;
+  glslang_initialized.store(true, std::memory_order_release);
   return true;
 }
 
 void DeinitializeGlslang()
 {
-  if (!glslang_initialized)
+  std::unique_lock lock(glslang_init_mutex);
+  if (!glslang_initialized.load(std::memory_order_relaxed))
     return;
 
   glslang::FinalizeProcess();
-  glslang_initialized = false;
+  glslang_initialized.store(false, std::memory_order_relaxed);
 }
 
 std::optional<SPIRVCodeVector> CompileVertexShader(std::string_view source_code)
@@ -0,0 +1,122 @@
+#include "core/cpu_core.h"
+#include "core/settings.h"
+#include "core/spu.h"
+#include "core/system.h"
+#include "core/timing_event.h"
+#include "util/audio_stream.h"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+namespace {
+// Collects everything the SPU mixes, in the order it reaches the stream.
+class CaptureAudioStream final : public AudioStream
+{
+public:
+  explicit CaptureAudioStream(std::vector<s16>* output) : m_output(output) {}
+
+protected:
+  bool OpenDevice() override
+  {
+    m_read_buffer.resize(MaxSamples);
+    return true;
+  }
+  void PauseDevice(bool paused) override {}
+  void CloseDevice() override {}
+  void FramesAvailable() override
+  {
+    u32 num_samples;
+    while ((num_samples = PopSamples(m_read_buffer.data(), static_cast<u32>(m_read_buffer.size()))) > 0)
+      m_output->insert(m_output->end(), m_read_buffer.begin(), m_read_buffer.begin() + num_samples);
+  }
+
+private:
+  std::vector<s16>* m_output;
+  std::vector<SampleType> m_read_buffer;
+};
+} // namespace
+
+static constexpr u32 SPU_BASE = 0x1F801C00;
+static constexpr u32 SAMPLE_ADDRESS = 0x1000;
+static constexpr u32 NUM_SAMPLE_BLOCKS = 64;
+static constexpr TickCount TICKS_PER_SAMPLE = System::MASTER_CLOCK / 44100;
+
+static void WriteSPU(u32 address, u16 value)
+{
+  g_spu.WriteRegister(address - SPU_BASE, value);
+}
+
+static void RunTicks(TickCount ticks)
+{
+  CPU::AddPendingTicks(ticks);
+  TimingEvents::RunEvents();
+}
+
+// Plays a looping voice while another voice's registers are written and the RAM IRQ is toggled, which switches the
+// SPU between mixing on the worker thread and on the CPU thread.
+static std::vector<s16> RenderIRQToggleSequence(bool use_worker_thread)
+{
+  std::vector<s16> output;
+
+  g_settings = Settings();
+  g_settings.audio_backend = AudioBackend::Null;
+  g_settings.audio_use_spu_thread = use_worker_thread;
+  TimingEvents::Initialize();
+  g_spu.Initialize();
+  g_spu.SetOutputStream(std::make_unique<CaptureAudioStream>(&output));
+
+  // Random ADPCM blocks, looping back to the start.
+  std::mt19937 rng(1234);
+  auto& ram = g_spu.GetRAM();
+  for (u32 block = 0; block < NUM_SAMPLE_BLOCKS; block++)
+  {
+    u8* data = &ram[SAMPLE_ADDRESS + block * 16];
+    data[0] = static_cast<u8>(rng() % 5);
+    data[1] = (block == 0) ? 0x04 : ((block == NUM_SAMPLE_BLOCKS - 1) ? 0x03 : 0x00);
+    for (u32 i = 2; i < 16; i++)
+      data[i] = static_cast<u8>(rng());
+  }
+
+  WriteSPU(0x1F801D80, 0x3FFF);             // main volume
+  WriteSPU(0x1F801D82, 0x3FFF);
+  WriteSPU(0x1F801DA4, 0xFFFF);             // IRQ address, never reached
+  WriteSPU(0x1F801DAA, 0xC000);             // enable, unmute
+  WriteSPU(0x1F801C00, 0x3FFF);             // voice 0 volume
+  WriteSPU(0x1F801C02, 0x3FFF);
+  WriteSPU(0x1F801C04, 0x0F3D);             // voice 0 pitch
+  WriteSPU(0x1F801C06, SAMPLE_ADDRESS / 8); // voice 0 start address
+  WriteSPU(0x1F801C08, 0x000F);             // voice 0 ADSR, fastest attack, full sustain
+  WriteSPU(0x1F801C0A, 0x0000);
+  WriteSPU(0x1F801D88, 0x0001);             // key on voice 0
+
+  for (u32 i = 0; i < 200; i++)
+  {
+    // Voice 0's volume changes what the following frames sound like, so frames mixed on the wrong side of this
+    // write show up in the output.
+    RunTicks(TICKS_PER_SAMPLE * (37 + (i % 11)));
+    WriteSPU(0x1F801C00, static_cast<u16>(0x1000 + (i % 7) * 0x800));
+    RunTicks(TICKS_PER_SAMPLE * (20 + (i % 5)));
+
+    // Voice 1 is off, so the frames before this write are held back by the worker. The control write follows it
+    // without a sample in between.
+    WriteSPU(0x1F801C14, static_cast<u16>(0x1000 + i));
+    WriteSPU(0x1F801DAA, (i & 1) ? 0xC000 : 0xC040);
+  }
+
+  RunTicks(TICKS_PER_SAMPLE * 100);
+  g_spu.Shutdown();
+  TimingEvents::Shutdown();
+  return output;
+}
+
+TEST(SPU, WorkerThreadMatchesWhenTogglingIRQ)
+{
+  const std::vector<s16> expected = RenderIRQToggleSequence(false);
+  const std::vector<s16> actual = RenderIRQToggleSequence(true);
+
+  ASSERT_FALSE(expected.empty());
+  ASSERT_NE(std::count(expected.begin(), expected.end(), 0), static_cast<std::ptrdiff_t>(expected.size()));
+  ASSERT_EQ(expected.size(), actual.size());
+  ASSERT_TRUE(expected == actual);
+}
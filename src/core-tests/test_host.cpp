@@ -0,0 +1,131 @@
+#include "common/log.h"
+#include "core/host.h"
+#include "core/host_display.h"
+#include "core/host_settings.h"
+#include "core/system.h"
+#include "frontend-common/achievements.h"
+#include "frontend-common/game_list.h"
+#include "frontend-common/input_manager.h"
+Log_SetChannel(TestHost);
+
+// The tests drive individual components directly, so the host does nothing beyond what the core needs to link.
+
+std::optional<std::vector<u8>> Host::ReadResourceFile(const char* filename)
+{
+  return std::nullopt;
+}
+
+std::optional<std::string> Host::ReadResourceFileToString(const char* filename)
+{
+  return std::nullopt;
+}
+
+std::optional<std::time_t> Host::GetResourceFileTimestamp(const char* filename)
+{
+  return std::nullopt;
+}
+
+TinyString Host::TranslateString(const char* context, const char* str, const char* disambiguation /*= nullptr*/,
+                                 int n /*= -1*/)
+{
+  return str;
+}
+
+std::string Host::TranslateStdString(const char* context, const char* str, const char* disambiguation /*= nullptr*/,
+                                     int n /*= -1*/)
+{
+  return str;
+}
+
+void Host::ReportErrorAsync(const std::string_view& title, const std::string_view& message)
+{
+  Log_ErrorPrintf("%.*s: %.*s", static_cast<int>(title.size()), title.data(), static_cast<int>(message.size()),
+                  message.data());
+}
+
+bool Host::ConfirmMessage(const std::string_view& title, const std::string_view& message)
+{
+  return false;
+}
+
+void Host::ReportDebuggerMessage(const std::string_view& message) {}
+
+void Host::SetMouseMode(bool relative, bool hide_cursor) {}
+
+void Host::RunOnCPUThread(std::function<void()> function, bool block /* = false */)
+{
+  function();
+}
+
+void Host::SetBaseStringSettingValue(const char* section, const char* key, const char* value) {}
+
+void Host::DeleteBaseSettingValue(const char* section, const char* key) {}
+
+void Host::CommitBaseSettingChanges() {}
+
+void Host::LoadSettings(SettingsInterface& si, std::unique_lock<std::mutex>& lock) {}
+
+void Host::CheckForSettingsChanges(const Settings& old_settings) {}
+
+bool Host::AcquireHostDisplay(HostDisplay::RenderAPI api)
+{
+  return false;
+}
+
+void Host::ReleaseHostDisplay() {}
+
+void Host::RenderDisplay() {}
+
+void Host::InvalidateDisplay() {}
+
+void Host::OnSystemStarting() {}
+
+void Host::OnSystemStarted() {}
+
+void Host::OnSystemDestroyed() {}
+
+void Host::OnSystemPaused() {}
+
+void Host::OnSystemResumed() {}
+
+void Host::OnPerformanceCountersUpdated() {}
+
+void Host::OnGameChanged(const std::string& disc_path, const std::string& game_serial, const std::string& game_name)
+{
+}
+
+void Host::PumpMessagesOnCPUThread() {}
+
+void Host::RequestResizeHostDisplay(s32 width, s32 height) {}
+
+void Host::RequestExit(bool save_state_if_running) {}
+
+void Host::RequestSystemShutdown(bool allow_confirm, bool allow_save_state) {}
+
+bool Host::IsFullscreen()
+{
+  return false;
+}
+
+void Host::SetFullscreen(bool enabled) {}
+
+void Host::RefreshGameListAsync(bool invalidate_cache) {}
+
+void Host::CancelGameListRefresh() {}
+
+void Host::OnAchievementsRefreshed() {}
+
+void Host::OnAchievementsChallengeModeChanged() {}
+
+std::optional<u32> InputManager::ConvertHostKeyboardStringToCode(const std::string_view& str)
+{
+  return std::nullopt;
+}
+
+std::optional<std::string> InputManager::ConvertHostKeyboardCodeToString(u32 code)
+{
+  return std::nullopt;
+}
+
+BEGIN_HOTKEY_LIST(g_host_hotkeys)
+END_HOTKEY_LIST()
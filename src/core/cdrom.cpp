@@ -11,13 +11,24 @@
 #include "system.h"
 #include "util/cd_image.h"
 #include "util/state_wrapper.h"
+#include <cinttypes>
 #include <cmath>
 Log_SetChannel(CDROM);
 
 #if defined(CPU_X64)
 #include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
 #endif
 
+// ReadS is used for streaming XA audio and FMVs. The first second of the stream stays in the sector cache, so data
+// reads in between don't push it out, and looping or restarting the stream doesn't have to read it from the image.
+static constexpr u32 STREAM_PIN_SECTORS = 150;
+
 static constexpr std::array<const char*, 15> s_drive_state_names = {
   {"Idle", "Opening Shell", "Resetting", "Seeking (Physical)", "Seeking (Logical)", "Reading ID", "Reading TOC",
    "Reading", "Playing", "Pausing", "Stopping", "Changing Session", "Spinning Up", "Seeking (Implicit)",
@@ -109,6 +120,7 @@ void CDROM::Shutdown()
   m_command_event.reset();
   m_command_second_response_event.reset();
   m_drive_event.reset();
+  UnpinStreamSectors();
   m_reader.StopThread();
   m_reader.RemoveMedia();
 }
@@ -132,6 +144,8 @@ void CDROM::Reset()
   m_seek_start_lba = 0;
   m_seek_end_lba = 0;
   m_setloc_pending = false;
+  m_stream_read = false;
+  UnpinStreamSectors();
   m_read_after_seek = false;
   m_play_after_seek = false;
   m_muted = false;
@@ -368,6 +382,7 @@ std::unique_ptr<CDImage> CDROM::RemoveMedia(bool force /* = false */)
   const TickCount stop_ticks = GetTicksForStop(true);
 
   Log_InfoPrintf("Removing CD...");
+  UnpinStreamSectors();
   std::unique_ptr<CDImage> image = m_reader.RemoveMedia();
 
   m_last_sector_header_valid = false;
@@ -1108,6 +1123,10 @@ void CDROM::ExecuteCommand(TickCount ticks_late)
         m_setloc_position.second = PackedBCDToBinary(ss);
         m_setloc_position.frame = PackedBCDToBinary(ff);
         m_setloc_pending = true;
+
+        // a seek to this position is almost certainly coming, so start reading it while the drive has nothing to do
+        if (IsDriveIdle() && m_reader.HasMedia())
+          m_reader.QueueReadSector(m_setloc_position.ToLBA(), true);
       }
 
       EndCommand();
@@ -1191,6 +1210,7 @@ void CDROM::ExecuteCommand(TickCount ticks_late)
           if (IsSeeking())
             UpdatePositionWhileSeeking();
 
+          m_stream_read = (m_command == Command::ReadS);
           BeginReading();
         }
       }
@@ -1788,6 +1808,9 @@ void CDROM::BeginReading(TickCount ticks_late /* = 0 */, bool after_seek /* = fa
 
   m_requested_lba = m_current_lba;
   m_reader.QueueReadSector(m_requested_lba);
+
+  if (m_stream_read)
+    PinStreamSectors(m_current_lba);
 }
 
 void CDROM::BeginPlaying(u8 track, TickCount ticks_late /* = 0 */, bool after_seek /* = false */)
@@ -2398,7 +2421,7 @@ void CDROM::ProcessDataSector(const u8* raw_sector, const CDImage::SubChannelQ&
   SetAsyncInterrupt(Interrupt::DataReady);
 }
 
-static std::array<std::array<s16, 29>, 7> s_zigzag_table = {
+static constexpr std::array<std::array<s16, 29>, 7> s_zigzag_table = {
   {{0,      0x0,     0x0,     0x0,    0x0,     -0x0002, 0x000A,  -0x0022, 0x0041, -0x0054,
     0x0034, 0x0009,  -0x010A, 0x0400, -0x0A78, 0x234C,  0x6794,  -0x1780, 0x0BCD, -0x0623,
     0x0350, -0x016D, 0x006B,  0x000A, -0x0010, 0x0011,  -0x0008, 0x0003,  -0x0001},
@@ -2421,13 +2444,64 @@ static std::array<std::array<s16, 29>, 7> s_zigzag_table = {
     0x3C07,  0x53E0,  -0x16FA, 0x0AFA, -0x0548, 0x027B,  -0x00EB, 0x001A,  0x002B, -0x0023,
     0x0010,  -0x0008, 0x0002,  0x0,    0x0,     0x0,     0x0,     0x0,     0x0}}};
 
-static s16 ZigZagInterpolate(const s16* ringbuf, const s16* table, u8 p)
+// The tables above rearranged to apply to the whole ring buffer's worth of samples, oldest first, so that they can be
+// done a vector at a time. The first tap is applied to the oldest sample in the ring buffer, not the newest, and the
+// rest to the newest 28 samples.
+static constexpr u32 XA_RESAMPLE_WINDOW_SIZE = 32;
+alignas(16) static constexpr std::array<std::array<s16, XA_RESAMPLE_WINDOW_SIZE>, 7> s_zigzag_window_table = []() {
+  std::array<std::array<s16, XA_RESAMPLE_WINDOW_SIZE>, 7> ret = {};
+  for (size_t i = 0; i < s_zigzag_table.size(); i++)
+  {
+    ret[i][0] = s_zigzag_table[i][0];
+    for (size_t j = 1; j < s_zigzag_table[i].size(); j++)
+      ret[i][XA_RESAMPLE_WINDOW_SIZE - j] = s_zigzag_table[i][j];
+  }
+  return ret;
+}();
+
+ALWAYS_INLINE static s16 ZigZagInterpolate(const s16* window, const s16* table)
 {
-  s32 sum = 0;
-  for (u8 i = 0; i < 29; i++)
-    sum += (s32(ringbuf[(p - i) & 0x1F]) * s32(table[i])) / 0x8000;
+  // Each product is divided by 0x8000 separately, rounding towards zero, before it's added. The sum can't overflow,
+  // so the order doesn't matter.
+#if defined(CPU_X64)
+  __m128i sum = _mm_setzero_si128();
+  for (u32 i = 0; i < XA_RESAMPLE_WINDOW_SIZE; i += 8)
+  {
+    const __m128i samples = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&window[i]));
+    const __m128i coefficients = _mm_load_si128(reinterpret_cast<const __m128i*>(&table[i]));
+    const __m128i products_lo = _mm_mullo_epi16(samples, coefficients);
+    const __m128i products_hi = _mm_mulhi_epi16(samples, coefficients);
+    __m128i products0 = _mm_unpacklo_epi16(products_lo, products_hi);
+    __m128i products1 = _mm_unpackhi_epi16(products_lo, products_hi);
+    products0 = _mm_add_epi32(products0, _mm_srli_epi32(_mm_srai_epi32(products0, 31), 17));
+    products1 = _mm_add_epi32(products1, _mm_srli_epi32(_mm_srai_epi32(products1, 31), 17));
+    sum = _mm_add_epi32(sum, _mm_add_epi32(_mm_srai_epi32(products0, 15), _mm_srai_epi32(products1, 15)));
+  }
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+  sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+  const s32 result = _mm_cvtsi128_si32(sum);
+#elif defined(CPU_AARCH64)
+  int32x4_t sum = vdupq_n_s32(0);
+  for (u32 i = 0; i < XA_RESAMPLE_WINDOW_SIZE; i += 8)
+  {
+    const int16x8_t samples = vld1q_s16(&window[i]);
+    const int16x8_t coefficients = vld1q_s16(&table[i]);
+    int32x4_t products0 = vmull_s16(vget_low_s16(samples), vget_low_s16(coefficients));
+    int32x4_t products1 = vmull_high_s16(samples, coefficients);
+    const uint32x4_t sign0 = vreinterpretq_u32_s32(vshrq_n_s32(products0, 31));
+    const uint32x4_t sign1 = vreinterpretq_u32_s32(vshrq_n_s32(products1, 31));
+    products0 = vaddq_s32(products0, vreinterpretq_s32_u32(vshrq_n_u32(sign0, 17)));
+    products1 = vaddq_s32(products1, vreinterpretq_s32_u32(vshrq_n_u32(sign1, 17)));
+    sum = vaddq_s32(sum, vaddq_s32(vshrq_n_s32(products0, 15), vshrq_n_s32(products1, 15)));
+  }
+  const s32 result = vaddvq_s32(sum);
+#else
+  s32 result = 0;
+  for (u32 i = 0; i < XA_RESAMPLE_WINDOW_SIZE; i++)
+    result += (s32(window[i]) * s32(table[i])) / 0x8000;
+#endif
 
-  return static_cast<s16>(std::clamp<s32>(sum, -0x8000, 0x7FFF));
+  return static_cast<s16>(std::clamp<s32>(result, -0x8000, 0x7FFF));
 }
 
 template<bool STEREO, bool SAMPLE_RATE>
@@ -2442,43 +2516,60 @@ void CDROM::ResampleXAADPCM(const s16* frames_in, u32 num_frames_in)
     return;
   }
 
-  s16* left_ringbuf = m_xa_resample_ring_buffer[0].data();
-  s16* right_ringbuf = m_xa_resample_ring_buffer[1].data();
-  u8 p = m_xa_resample_p;
-  u8 sixstep = m_xa_resample_sixstep;
-  for (u32 in_sample_index = 0; in_sample_index < num_frames_in; in_sample_index++)
+  // The ring buffer is unrolled in front of the new samples, so the window for every output is contiguous, and the
+  // filter can be applied a vector at a time. The ring buffer is then refilled from the end.
+  static constexpr u32 MAX_SAMPLES = CDXA::XA_ADPCM_SAMPLES_PER_SECTOR_4BIT * 2;
+  static constexpr u32 HISTORY_SIZE = XA_RESAMPLE_RING_BUFFER_SIZE + MAX_SAMPLES;
+  alignas(16) std::array<std::array<s16, HISTORY_SIZE>, STEREO ? 2 : 1> history;
+
+  const u32 num_samples = num_frames_in * (SAMPLE_RATE ? 2 : 1);
+  DebugAssert(num_samples <= MAX_SAMPLES);
+
+  const u8 p = m_xa_resample_p;
+  for (u32 channel = 0; channel < (STEREO ? 2 : 1); channel++)
   {
-    const s16 left = *(frames_in++);
-    const s16 right = STEREO ? *(frames_in++) : left;
+    const s16* ringbuf = m_xa_resample_ring_buffer[channel].data();
+    s16* channel_history = history[channel].data();
+    for (u32 i = 0; i < XA_RESAMPLE_RING_BUFFER_SIZE; i++)
+      channel_history[i] = ringbuf[(p + i) % XA_RESAMPLE_RING_BUFFER_SIZE];
 
-    if constexpr (!STEREO)
+    s16* out = &channel_history[XA_RESAMPLE_RING_BUFFER_SIZE];
+    const s16* in = frames_in + channel;
+    for (u32 i = 0; i < num_frames_in; i++)
     {
-      UNREFERENCED_VARIABLE(right);
+      *(out++) = *in;
+      if constexpr (SAMPLE_RATE)
+        *(out++) = *in;
+      in += STEREO ? 2 : 1;
     }
+  }
 
-    for (u32 sample_dup = 0; sample_dup < (SAMPLE_RATE ? 2 : 1); sample_dup++)
+  // Seven frames are output for every six samples, once the sixth has been written.
+  const u32 sixstep = m_xa_resample_sixstep;
+  for (u32 i = sixstep - 1; i < num_samples; i += 6)
+  {
+    const u32 window_start = i + 1;
+    for (u32 j = 0; j < XA_RESAMPLE_NUM_ZIGZAG_TABLES; j++)
     {
-      left_ringbuf[p] = left;
-      if constexpr (STEREO)
-        right_ringbuf[p] = right;
-      p = (p + 1) % 32;
-      sixstep--;
-
-      if (sixstep == 0)
-      {
-        sixstep = 6;
-        for (u32 j = 0; j < 7; j++)
-        {
-          const s16 left_interp = ZigZagInterpolate(left_ringbuf, s_zigzag_table[j].data(), p);
-          const s16 right_interp = STEREO ? ZigZagInterpolate(right_ringbuf, s_zigzag_table[j].data(), p) : left_interp;
-          AddCDAudioFrame(left_interp, right_interp);
-        }
-      }
+      const s16* table = s_zigzag_window_table[j].data();
+      const s16 left_interp = ZigZagInterpolate(&history[0][window_start], table);
+      const s16 right_interp = STEREO ? ZigZagInterpolate(&history[STEREO ? 1 : 0][window_start], table) : left_interp;
+      AddCDAudioFrame(left_interp, right_interp);
     }
   }
 
-  m_xa_resample_p = p;
-  m_xa_resample_sixstep = sixstep;
+  const u32 elapsed_steps = num_samples % 6;
+  m_xa_resample_sixstep = static_cast<u8>((sixstep > elapsed_steps) ? (sixstep - elapsed_steps) :
+                                                                          (sixstep + 6 - elapsed_steps));
+  m_xa_resample_p = static_cast<u8>((p + num_samples) % XA_RESAMPLE_RING_BUFFER_SIZE);
+
+  for (u32 channel = 0; channel < (STEREO ? 2 : 1); channel++)
+  {
+    s16* ringbuf = m_xa_resample_ring_buffer[channel].data();
+    const s16* channel_history = &history[channel][num_samples];
+    for (u32 i = 0; i < XA_RESAMPLE_RING_BUFFER_SIZE; i++)
+      ringbuf[(m_xa_resample_p + i) % XA_RESAMPLE_RING_BUFFER_SIZE] = channel_history[i];
+  }
 }
 
 void CDROM::ResetCurrentXAFile()
@@ -2719,6 +2810,35 @@ void CDROM::ClearSectorBuffers()
     m_sector_buffers[i].size = 0;
 }
 
+void CDROM::PinStreamSectors(CDImage::LBA start_lba)
+{
+  // restarting the same stream keeps its pin
+  if (m_stream_pin_count > 0 && m_stream_pin_lba == start_lba)
+    return;
+
+  UnpinStreamSectors();
+
+  const CDImage* media = m_reader.GetMedia();
+  if (!media)
+    return;
+
+  m_stream_pin_lba = start_lba;
+  m_stream_pin_count = STREAM_PIN_SECTORS;
+  media->PinSectorCacheRange(m_stream_pin_lba, m_stream_pin_count);
+  Log_DevPrintf("Pinned %u sectors of stream at LBA %u", m_stream_pin_count, m_stream_pin_lba);
+}
+
+void CDROM::UnpinStreamSectors()
+{
+  if (m_stream_pin_count == 0)
+    return;
+
+  if (const CDImage* media = m_reader.GetMedia(); media)
+    media->UnpinSectorCacheRange(m_stream_pin_lba, m_stream_pin_count);
+
+  m_stream_pin_count = 0;
+}
+
 void CDROM::DrawDebugWindow()
 {
   static const ImVec4 active_color{1.0f, 1.0f, 1.0f, 1.0f};
@@ -2754,6 +2874,30 @@ void CDROM::DrawDebugWindow()
       ImGui::Text("Disc Position: MSF[%02u:%02u:%02u] LBA[%u]", disc_position.minute, disc_position.second,
                   disc_position.frame, disc_position.ToLBA());
 
+      if (m_reader.IsUsingThread())
+      {
+        const CDROMAsyncReader::Statistics stats = m_reader.GetStatistics();
+        const u32 lookups = stats.hits + stats.misses;
+        ImGui::Text("Readahead: Depth[%u] Hits[%u] Misses[%u] Hit Rate[%.1f%%] Waits[%u, %.2f ms]",
+                    stats.readahead_depth, stats.hits, stats.misses,
+                    (lookups > 0) ? (static_cast<float>(stats.hits) * 100.0f / static_cast<float>(lookups)) : 0.0f,
+                    stats.waits, stats.wait_time_ms);
+      }
+
+      const CDImage::SectorCacheStats cache_stats = CDImage::GetSectorCacheStats();
+      if (cache_stats.memory_budget > 0)
+      {
+        const u64 cache_lookups = cache_stats.hits + cache_stats.misses;
+        ImGui::Text("Sector Cache: Sectors[%u, %u pinned] Memory[%.1f/%.1f MB] Hit Rate[%.1f%%] Evictions[%" PRIu64 "]",
+                    cache_stats.sector_count, cache_stats.pinned_sector_count,
+                    static_cast<float>(cache_stats.memory_used) / 1048576.0f,
+                    static_cast<float>(cache_stats.memory_budget) / 1048576.0f,
+                    (cache_lookups > 0) ?
+                      (static_cast<float>(cache_stats.hits) * 100.0f / static_cast<float>(cache_lookups)) :
+                      0.0f,
+                    cache_stats.evictions);
+      }
+
       if (media->GetTrackNumber() > media->GetTrackCount())
       {
         ImGui::Text("Track Position: Lead-out");
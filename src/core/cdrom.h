@@ -48,6 +48,10 @@ public:
 
   void SetReadaheadSectors(u32 readahead_sectors);
 
+  /// Readahead buffer counters, for the debug window and performance overlay.
+  bool IsUsingReadThread() const { return m_reader.IsUsingThread(); }
+  CDROMAsyncReader::Statistics GetReaderStatistics() const { return m_reader.GetStatistics(); }
+
   /// Reads a frame from the audio FIFO, used by the SPU.
   ALWAYS_INLINE std::tuple<s16, s16> GetAudioFrame()
   {
@@ -326,6 +330,8 @@ private:
   void ResetAudioDecoder();
   void LoadDataFIFO();
   void ClearSectorBuffers();
+  void PinStreamSectors(CDImage::LBA start_lba);
+  void UnpinStreamSectors();
 
   template<bool STEREO, bool SAMPLE_RATE>
   void ResampleXAADPCM(const s16* frames_in, u32 num_frames_in);
@@ -359,6 +365,11 @@ private:
   bool m_read_after_seek = false;
   bool m_play_after_seek = false;
 
+  // Start of the last ReadS stream, which is kept in the sector cache. Not saved in state, it only affects caching.
+  bool m_stream_read = false;
+  CDImage::LBA m_stream_pin_lba{};
+  u32 m_stream_pin_count = 0;
+
   bool m_muted = false;
   bool m_adpcm_muted = false;
 
@@ -2,8 +2,16 @@
 #include "common/assert.h"
 #include "common/log.h"
 #include "common/timer.h"
+#include <algorithm>
 Log_SetChannel(CDROMAsyncReader);
 
+// Bounds for the adaptive readahead depth, relative to the configured sector count.
+static constexpr u32 MIN_READAHEAD_SECTORS = 2;
+static constexpr u32 MAX_READAHEAD_SCALE = 4;
+
+// Slots on top of the maximum readahead depth, which keep the last sectors read for re-reads after a seek.
+static constexpr u32 HISTORY_SECTORS = 16;
+
 CDROMAsyncReader::CDROMAsyncReader() = default;
 
 CDROMAsyncReader::~CDROMAsyncReader()
@@ -16,13 +24,19 @@ void CDROMAsyncReader::StartThread(u32 readahead_count)
   if (IsUsingThread())
     StopThread();
 
+  m_base_readahead_count = readahead_count;
+  m_min_readahead_count = std::min(readahead_count, MIN_READAHEAD_SECTORS);
+  m_max_readahead_count = readahead_count * MAX_READAHEAD_SCALE;
+
   m_buffers.clear();
-  m_buffers.resize(readahead_count);
+  m_buffers.resize(m_max_readahead_count + HISTORY_SECTORS);
   EmptyBuffers();
+  ResetStatistics();
 
   m_shutdown_flag.store(false);
   m_read_thread = std::thread(&CDROMAsyncReader::WorkerThreadEntryPoint, this);
-  Log_InfoPrintf("Read thread started with readahead of %u sectors", readahead_count);
+  Log_InfoPrintf("Read thread started with readahead of %u sectors (%u-%u)", readahead_count, m_min_readahead_count,
+                 m_max_readahead_count);
 }
 
 void CDROMAsyncReader::StopThread()
@@ -47,6 +61,7 @@ void CDROMAsyncReader::SetMedia(std::unique_ptr<CDImage> media)
     CancelReadahead();
 
   m_media = std::move(media);
+  ResetStatistics();
 }
 
 std::unique_ptr<CDImage> CDROMAsyncReader::RemoveMedia()
@@ -54,17 +69,22 @@ std::unique_ptr<CDImage> CDROMAsyncReader::RemoveMedia()
   if (IsUsingThread())
     CancelReadahead();
 
+  ResetStatistics();
   return std::move(m_media);
 }
 
-void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
+void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba, bool speculative)
 {
   if (!IsUsingThread())
   {
-    ReadSectorNonThreaded(lba);
+    if (!speculative)
+      ReadSectorNonThreaded(lba);
     return;
   }
 
+  if (!speculative)
+    UpdateReadaheadDepth(lba);
+
   const u32 buffer_count = m_buffer_count.load();
   if (buffer_count > 0)
   {
@@ -83,6 +103,7 @@ void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
     {
       // great, don't need a seek, but still kick the thread to start reading ahead again
       Log_DebugPrintf("Readahead buffer hit for sector %u", lba);
+      m_hits += BoolToUInt32(!speculative);
       m_buffer_front.store(next_buffer);
       m_buffer_count.fetch_sub(1);
       m_can_readahead.store(true);
@@ -91,9 +112,21 @@ void CDROMAsyncReader::QueueReadSector(CDImage::LBA lba)
     }
   }
 
-  // we need to toss away our readahead and start fresh
-  Log_DebugPrintf("Readahead buffer miss, queueing seek to %u", lba);
+  // if the thread is idle, the sector might still be further ahead in the buffers, or one we read recently
   std::unique_lock<std::mutex> lock(m_mutex);
+  if (!m_is_reading.load() && ReuseBufferedSectors(lba))
+  {
+    Log_DebugPrintf("Readahead buffer hit for sector %u after seek", lba);
+    m_hits += BoolToUInt32(!speculative);
+    m_next_position_set.store(false);
+    m_seek_error.store(false);
+    m_can_readahead.store(true);
+    m_do_read_cv.notify_one();
+    return;
+  }
+
+  Log_DebugPrintf("Readahead buffer miss, queueing seek to %u", lba);
+  m_misses += BoolToUInt32(!speculative);
   m_next_position_set.store(true);
   m_next_position = lba;
   m_do_read_cv.notify_one();
@@ -109,16 +142,8 @@ bool CDROMAsyncReader::ReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ
   // wait until the read thread is idle
   m_notify_read_complete_cv.wait(lock, [this]() { return !m_is_reading.load(); });
 
-  // read while the lock is held so it has to wait
-  const CDImage::LBA prev_lba = m_media->GetPositionOnDisc();
-  const bool result = InternalReadSectorUncached(lba, subq, data);
-  if (!m_media->Seek(prev_lba))
-  {
-    Log_ErrorPrintf("Failed to re-seek to cached position %u", prev_lba);
-    m_can_readahead.store(false);
-  }
-
-  return result;
+  // read while the lock is held so it has to wait, the thread seeks back before reading ahead again
+  return InternalReadSectorUncached(lba, subq, data);
 }
 
 bool CDROMAsyncReader::InternalReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data)
@@ -161,6 +186,8 @@ bool CDROMAsyncReader::WaitForReadToComplete()
 
   const u32 front = m_buffer_front.load();
   const double wait_time = wait_timer.GetTimeMilliseconds();
+  m_waits++;
+  m_wait_time_ms += static_cast<float>(wait_time);
   if (wait_time > 1.0f)
     Log_WarningPrintf("Had to wait %.2f msec for LBA %u", wait_time, m_buffers[front].lba);
 
@@ -177,11 +204,99 @@ void CDROMAsyncReader::WaitForIdle()
   m_notify_read_complete_cv.wait(lock, [this]() { return (!m_is_reading.load() && !m_next_position_set.load()); });
 }
 
+CDROMAsyncReader::Statistics CDROMAsyncReader::GetStatistics() const
+{
+  Statistics stats;
+  stats.readahead_depth = m_readahead_depth.load();
+  stats.buffered_sectors = m_buffer_count.load();
+  stats.hits = m_hits;
+  stats.misses = m_misses;
+  stats.waits = m_waits;
+  stats.wait_time_ms = m_wait_time_ms;
+  return stats;
+}
+
+void CDROMAsyncReader::ResetStatistics()
+{
+  m_hits = 0;
+  m_misses = 0;
+  m_waits = 0;
+  m_wait_time_ms = 0.0f;
+}
+
 void CDROMAsyncReader::EmptyBuffers()
 {
   m_buffer_front.store(0);
   m_buffer_back.store(0);
   m_buffer_count.store(0);
+
+  // history is only valid for the current media, and the access pattern starts over
+  for (BufferSlot& buffer : m_buffers)
+    buffer.result = false;
+
+  m_readahead_depth.store(m_base_readahead_count);
+  m_last_requested_lba = 0;
+  m_sequential_sector_count = 0;
+}
+
+bool CDROMAsyncReader::ReuseBufferedSectors(CDImage::LBA lba)
+{
+  // Any slot still tagged with the LBA holds its data, whether it's ahead of the front or left over from earlier
+  // reads. The run of consecutive sectors following it becomes the new buffer contents. Needs the thread to be idle.
+  const u32 capacity = static_cast<u32>(m_buffers.size());
+  for (u32 slot = 0; slot < capacity; slot++)
+  {
+    if (!m_buffers[slot].result || m_buffers[slot].lba != lba)
+      continue;
+
+    u32 count = 1;
+    while (count < capacity)
+    {
+      const BufferSlot& next = m_buffers[(slot + count) % capacity];
+      if (!next.result || next.lba != (lba + count))
+        break;
+
+      count++;
+    }
+
+    m_buffer_front.store(slot);
+    m_buffer_back.store((slot + count) % capacity);
+    m_buffer_count.store(count);
+    m_next_read_lba = lba + count;
+    return true;
+  }
+
+  return false;
+}
+
+void CDROMAsyncReader::UpdateReadaheadDepth(CDImage::LBA lba)
+{
+  const u32 depth = m_readahead_depth.load();
+  if (lba == (m_last_requested_lba + 1))
+  {
+    // streaming, e.g. FMVs or XA audio, read further ahead so a slow sector doesn't stall it
+    m_sequential_sector_count++;
+    if (m_sequential_sector_count >= (depth * 2) && depth < m_max_readahead_count)
+    {
+      const u32 new_depth = std::min(depth * 2, m_max_readahead_count);
+      Log_DevPrintf("Sequential reads, increasing readahead to %u sectors", new_depth);
+      m_readahead_depth.store(new_depth);
+    }
+  }
+  else if (lba != m_last_requested_lba)
+  {
+    // most of what was read ahead got thrown away, so don't read as far next time
+    if (m_sequential_sector_count < (depth / 2) && depth > m_min_readahead_count)
+    {
+      const u32 new_depth = std::max(depth / 2, m_min_readahead_count);
+      Log_DevPrintf("Frequent seeks, decreasing readahead to %u sectors", new_depth);
+      m_readahead_depth.store(new_depth);
+    }
+
+    m_sequential_sector_count = 0;
+  }
+
+  m_last_requested_lba = lba;
 }
 
 bool CDROMAsyncReader::ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock)
@@ -189,29 +304,49 @@ bool CDROMAsyncReader::ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock)
   Common::Timer timer;
 
   const u32 slot = m_buffer_back.load();
-  m_buffer_back.store((slot + 1) % static_cast<u32>(m_buffers.size()));
-
   BufferSlot& buffer = m_buffers[slot];
-  buffer.lba = m_media->GetPositionOnDisc();
+  buffer.lba = m_next_read_lba;
+  buffer.result = false;
   m_is_reading.store(true);
   lock.unlock();
 
-  Log_TracePrintf("Reading LBA %u...", buffer.lba);
-
-  buffer.result = m_media->ReadRawSector(buffer.data.data(), &buffer.subq);
-  if (buffer.result)
+  // the media won't be at the next sector after a seek, or when buffered sectors were reused
+  const bool seek_result = (m_media->GetPositionOnDisc() == buffer.lba || m_media->Seek(buffer.lba));
+  if (seek_result)
   {
-    const double read_time = timer.GetTimeMilliseconds();
-    if (read_time > 1.0f)
-      Log_DevPrintf("Read LBA %u took %.2f msec", buffer.lba, read_time);
-  }
-  else
-  {
-    Log_ErrorPrintf("Read of LBA %u failed", buffer.lba);
+    Log_TracePrintf("Reading LBA %u...", buffer.lba);
+
+    buffer.result = m_media->ReadRawSector(buffer.data.data(), &buffer.subq);
+    if (buffer.result)
+    {
+      const double read_time = timer.GetTimeMilliseconds();
+      if (read_time > 1.0f)
+        Log_DevPrintf("Read LBA %u took %.2f msec", buffer.lba, read_time);
+    }
+    else
+    {
+      Log_ErrorPrintf("Read of LBA %u failed", buffer.lba);
+    }
   }
 
   lock.lock();
   m_is_reading.store(false);
+
+  if (!seek_result)
+  {
+    // only an error if there's nothing buffered, otherwise it's just the end of the readahead
+    Log_WarningPrintf("Seek to LBA %u failed", buffer.lba);
+    if (m_buffer_count.load() == 0 && !m_next_position_set.load())
+    {
+      m_seek_error.store(true);
+      m_notify_read_complete_cv.notify_all();
+    }
+
+    return false;
+  }
+
+  m_buffer_back.store((slot + 1) % static_cast<u32>(m_buffers.size()));
+  m_next_read_lba = buffer.lba + 1;
   m_buffer_count.fetch_add(1);
   m_notify_read_complete_cv.notify_all();
   return true;
@@ -277,64 +412,46 @@ void CDROMAsyncReader::WorkerThreadEntryPoint()
     if (m_shutdown_flag.load())
       break;
 
-    for (;;)
+    if (m_next_position_set.load())
     {
-      if (m_next_position_set.load())
+      const CDImage::LBA seek_location = m_next_position.load();
+      m_next_position_set.store(false);
+      m_seek_error.store(false);
+
+      // the sector we were reading when the seek came in might be the one we want
+      if (ReuseBufferedSectors(seek_location))
+      {
+        Log_DebugPrintf("Reusing buffered sectors for LBA %u", seek_location);
+        m_notify_read_complete_cv.notify_all();
+      }
+      else
       {
-        // discard buffers, we're seeking to a new location
-        const CDImage::LBA seek_location = m_next_position.load();
-        EmptyBuffers();
-        m_next_position_set.store(false);
-        m_seek_error.store(false);
-        m_is_reading.store(true);
-        lock.unlock();
-
-        // seek without lock held in case it takes time
+        // discard buffers, we're seeking to a new location, the actual seek happens with the first read
         Log_DebugPrintf("Seeking to LBA %u...", seek_location);
-        const bool seek_result = (m_media->GetPositionOnDisc() == seek_location || m_media->Seek(seek_location));
-
-        lock.lock();
-        m_is_reading.store(false);
-
-        // did another request come in? abort if so
-        if (m_next_position_set.load())
-          continue;
-
-        // did we fail the seek?
-        if (!seek_result)
-        {
-          // add the error result, and don't try to read ahead
-          Log_WarningPrintf("Seek to LBA %u failed", seek_location);
-          m_seek_error.store(true);
-          m_notify_read_complete_cv.notify_all();
-          break;
-        }
-
-        // go go read ahead!
-        m_can_readahead.store(true);
+        m_buffer_front.store(m_buffer_back.load());
+        m_buffer_count.store(0);
+        m_next_read_lba = seek_location;
       }
 
-      if (!m_can_readahead.load())
-        break;
+      // go go read ahead!
+      m_can_readahead.store(true);
+    }
 
-      // readahead time! read as many sectors as we have space for
-      Log_DebugPrintf("Reading ahead %u sectors...", static_cast<u32>(m_buffers.size()) - m_buffer_count.load());
-      while (m_buffer_count.load() < static_cast<u32>(m_buffers.size()))
-      {
-        if (m_next_position_set.load())
-        {
-          // a seek request came in while we're reading, so bail out
-          break;
-        }
-
-        // stop reading if we hit the end or get an error
-        if (!ReadSectorIntoBuffer(lock))
-          break;
-      }
+    // readahead time! read as many sectors as the current depth allows, the remaining slots keep history
+    const u32 readahead_depth = m_readahead_depth.load();
+    Log_DebugPrintf("Reading ahead %u sectors...", readahead_depth - std::min(m_buffer_count.load(), readahead_depth));
+    while (m_buffer_count.load() < readahead_depth)
+    {
+      // a seek request came in while we're reading, so bail out
+      if (m_next_position_set.load() || m_shutdown_flag.load())
+        break;
 
-      // readahead buffer is full or errored at this point
-      m_can_readahead.store(false);
-      break;
+      // stop reading if we hit the end or get an error
+      if (!ReadSectorIntoBuffer(lock))
+        break;
     }
+
+    // readahead buffer is full or errored at this point
+    m_can_readahead.store(false);
   }
 }
@@ -19,6 +19,16 @@ public:
     bool result;
   };
 
+  struct Statistics
+  {
+    u32 readahead_depth;
+    u32 buffered_sectors;
+    u32 hits;
+    u32 misses;
+    u32 waits;
+    float wait_time_ms;
+  };
+
   CDROMAsyncReader();
   ~CDROMAsyncReader();
 
@@ -27,20 +37,25 @@ public:
   const CDImage::SubChannelQ& GetSectorSubQ() const { return m_buffers[m_buffer_front.load()].subq; }
   const u32 GetBufferedSectorCount() const { return m_buffer_count.load(); }
   const bool HasBufferedSectors() const { return (m_buffer_count.load() > 0); }
-  const u32 GetReadaheadCount() const { return static_cast<u32>(m_buffers.size()); }
+  const u32 GetReadaheadCount() const { return m_base_readahead_count; }
+  const u32 GetReadaheadDepth() const { return m_readahead_depth.load(); }
 
   const bool HasMedia() const { return static_cast<bool>(m_media); }
   const CDImage* GetMedia() const { return m_media.get(); }
   const std::string& GetMediaFileName() const { return m_media->GetFileName(); }
 
   bool IsUsingThread() const { return m_read_thread.joinable(); }
+
+  /// Readahead starts at readahead_count sectors, and adapts to the access pattern from there.
   void StartThread(u32 readahead_count = 8);
   void StopThread();
 
   void SetMedia(std::unique_ptr<CDImage> media);
   std::unique_ptr<CDImage> RemoveMedia();
 
-  void QueueReadSector(CDImage::LBA lba);
+  /// Speculative reads are for sectors which will probably be read soon. They're skipped without a read thread, and
+  /// don't count towards the statistics or the readahead depth.
+  void QueueReadSector(CDImage::LBA lba, bool speculative = false);
 
   bool WaitForReadToComplete();
   void WaitForIdle();
@@ -48,8 +63,14 @@ public:
   /// Bypasses the sector cache and reads directly from the image.
   bool ReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data);
 
+  /// Buffer hit/miss and wait counters, since the media was last changed.
+  Statistics GetStatistics() const;
+  void ResetStatistics();
+
 private:
   void EmptyBuffers();
+  bool ReuseBufferedSectors(CDImage::LBA lba);
+  void UpdateReadaheadDepth(CDImage::LBA lba);
   bool ReadSectorIntoBuffer(std::unique_lock<std::mutex>& lock);
   void ReadSectorNonThreaded(CDImage::LBA lba);
   bool InternalReadSectorUncached(CDImage::LBA lba, CDImage::SubChannelQ* subq, SectorBuffer* data);
@@ -72,8 +93,24 @@ private:
   std::atomic_bool m_can_readahead{false};
   std::atomic_bool m_seek_error{false};
 
+  // Slots outside of front..back keep the sectors which were read last, so they can be reused by a later seek.
   std::vector<BufferSlot> m_buffers;
   std::atomic<u32> m_buffer_front{0};
   std::atomic<u32> m_buffer_back{0};
   std::atomic<u32> m_buffer_count{0};
+  CDImage::LBA m_next_read_lba = 0;
+
+  // Readahead depth is grown by sequential reads, and shrunk when seeks throw most of it away.
+  std::atomic<u32> m_readahead_depth{0};
+  u32 m_base_readahead_count = 0;
+  u32 m_min_readahead_count = 0;
+  u32 m_max_readahead_count = 0;
+  CDImage::LBA m_last_requested_lba = 0;
+  u32 m_sequential_sector_count = 0;
+
+  // Only touched by the CPU thread.
+  u32 m_hits = 0;
+  u32 m_misses = 0;
+  u32 m_waits = 0;
+  float m_wait_time_ms = 0.0f;
 };
@@ -146,6 +146,9 @@ public:
   /// Returns the full display resolution of the GPU, including padding.
   virtual std::tuple<u32, u32> GetFullDisplayResolution(bool scaled = true);
 
+  /// Returns the number of display updates which were skipped because the displayed area of VRAM was unchanged.
+  ALWAYS_INLINE u32 GetSkippedDisplayUpdateCount() const { return m_skipped_display_updates; }
+
   float ComputeHorizontalFrequency() const;
   float ComputeVerticalFrequency() const;
   float GetDisplayAspectRatio() const;
@@ -555,6 +558,9 @@ protected:
   Stats m_stats = {};
   Stats m_last_stats = {};
 
+  // Number of display updates where the previous display texture was presented again.
+  u32 m_skipped_display_updates = 0;
+
 private:
   using GP0CommandHandler = bool (GPU::*)();
   using GP0CommandHandlerTable = std::array<GP0CommandHandler, 256>;
@@ -2,6 +2,8 @@
 #include "common/align.h"
 #include "common/assert.h"
 #include "common/log.h"
+#include "common/platform.h"
+#include "common/threading.h"
 #include "cpu_core.h"
 #include "gpu_sw_backend.h"
 #include "host.h"
@@ -10,11 +12,23 @@
 #include "settings.h"
 #include "system.h"
 #include "util/state_wrapper.h"
+#include <atomic>
 #include <cmath>
 #include <sstream>
+#include <thread>
 #include <tuple>
 Log_SetChannel(GPU_HW);
 
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
 template<typename T>
 ALWAYS_INLINE static constexpr std::tuple<T, T> MinMax(T v1, T v2)
 {
@@ -114,6 +128,10 @@ void GPU_HW::Reset(bool clear_vram)
 
 bool GPU_HW::DoState(StateWrapper& sw, HostDisplayTexture** host_texture, bool update_display)
 {
+  // VRAM may have been replaced underneath us, so don't reuse the display texture when it's regenerated
+  if (sw.IsReading())
+    InvalidateDisplayTexture();
+
   if (!GPU::DoState(sw, host_texture, update_display))
     return false;
 
@@ -128,8 +146,61 @@ bool GPU_HW::DoState(StateWrapper& sw, HostDisplayTexture** host_texture, bool u
   return true;
 }
 
+bool GPU_HW::CompileInParallel(u32 count, ShaderCompileProgressTracker& progress, const std::function<bool(u32)>& task)
+{
+  if (count == 0)
+    return true;
+
+  std::atomic<u32> next_index{0};
+  std::atomic<u32> completed{0};
+  std::atomic_bool failed{false};
+
+  const auto run_next_task = [count, &task, &next_index, &completed, &failed]() {
+    const u32 index = next_index.fetch_add(1, std::memory_order_relaxed);
+    if (index >= count)
+      return false;
+
+    // drain the remaining work without running it once something has failed
+    if (!failed.load(std::memory_order_relaxed) && !task(index))
+      failed.store(true, std::memory_order_relaxed);
+
+    completed.fetch_add(1, std::memory_order_release);
+    return true;
+  };
+
+  const u32 num_workers = std::min(std::max(std::thread::hardware_concurrency(), 1u), count) - 1;
+  std::vector<Threading::Thread> workers(num_workers);
+  for (Threading::Thread& worker : workers)
+  {
+    worker.Start([&run_next_task]() {
+      while (run_next_task())
+        ;
+    });
+  }
+
+  // the loading screen isn't thread-safe, so the calling thread does the progress updates between its own tasks
+  u32 reported = 0;
+  for (;;)
+  {
+    const bool ran_task = run_next_task();
+    const u32 done = completed.load(std::memory_order_acquire);
+    progress.Increment(done - reported);
+    reported = done;
+    if (!ran_task)
+      break;
+  }
+
+  for (Threading::Thread& worker : workers)
+    worker.Join();
+
+  progress.Increment(completed.load(std::memory_order_acquire) - reported);
+  return !failed.load(std::memory_order_relaxed);
+}
+
 void GPU_HW::UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed)
 {
+  InvalidateDisplayTexture();
+
   const u32 resolution_scale = CalculateResolutionScale();
   const u32 multisamples = std::min(m_max_multisamples, g_settings.gpu_multisamples);
   const bool per_sample_shading = g_settings.gpu_per_sample_shading && m_supports_per_sample_shading;
@@ -312,17 +383,6 @@ void GPU_HW::HandleFlippedQuadTextureCoordinates(BatchVertex* vertices)
   const float bcy = vertices[2].y - vertices[1].y;
   const float cax = vertices[0].x - vertices[2].x;
   const float cay = vertices[0].y - vertices[2].y;
-
-  // Compute static derivatives, just assume W is uniform across the primitive and that the plane equation remains the
-  // same across the quad. (which it is, there is no Z.. yet).
-  const float dudx = -aby * static_cast<float>(vertices[2].u) - bcy * static_cast<float>(vertices[0].u) -
-                     cay * static_cast<float>(vertices[1].u);
-  const float dvdx = -aby * static_cast<float>(vertices[2].v) - bcy * static_cast<float>(vertices[0].v) -
-                     cay * static_cast<float>(vertices[1].v);
-  const float dudy = +abx * static_cast<float>(vertices[2].u) + bcx * static_cast<float>(vertices[0].u) +
-                     cax * static_cast<float>(vertices[1].u);
-  const float dvdy = +abx * static_cast<float>(vertices[2].v) + bcx * static_cast<float>(vertices[0].v) +
-                     cax * static_cast<float>(vertices[1].v);
   const float area = bcx * cay - bcy * cax;
 
   // Detect and reject any triangles with 0 size texture area
@@ -336,20 +396,60 @@ void GPU_HW::HandleFlippedQuadTextureCoordinates(BatchVertex* vertices)
   if (area == 0.0f || texArea == 0 || is_3d)
     return;
 
-  // Use floats here as it'll be faster than integer divides.
+  // Compute static derivatives, just assume W is uniform across the primitive and that the plane equation remains the
+  // same across the quad. (which it is, there is no Z.. yet).
+  // The four derivatives are computed together as [dudx, dvdx, dudy, dvdy], and the sign/zero tests are reduced to
+  // bitmasks with the same lane order. Use floats here as it'll be faster than integer divides.
   const float rcp_area = 1.0f / area;
-  const float dudx_area = dudx * rcp_area;
-  const float dudy_area = dudy * rcp_area;
-  const float dvdx_area = dvdx * rcp_area;
-  const float dvdy_area = dvdy * rcp_area;
-  const bool neg_dudx = dudx_area < 0.0f;
-  const bool neg_dudy = dudy_area < 0.0f;
-  const bool neg_dvdx = dvdx_area < 0.0f;
-  const bool neg_dvdy = dvdy_area < 0.0f;
-  const bool zero_dudx = dudx_area == 0.0f;
-  const bool zero_dudy = dudy_area == 0.0f;
-  const bool zero_dvdx = dvdx_area == 0.0f;
-  const bool zero_dvdy = dvdy_area == 0.0f;
+  u32 negative_mask, zero_mask;
+
+#if defined(CPU_X64)
+  const __m128 t0 = _mm_cvtepi32_ps(_mm_setr_epi32(vertices[0].u, vertices[0].v, vertices[0].u, vertices[0].v));
+  const __m128 t1 = _mm_cvtepi32_ps(_mm_setr_epi32(vertices[1].u, vertices[1].v, vertices[1].u, vertices[1].v));
+  const __m128 t2 = _mm_cvtepi32_ps(_mm_setr_epi32(vertices[2].u, vertices[2].v, vertices[2].u, vertices[2].v));
+  const __m128 a = _mm_mul_ps(_mm_setr_ps(-aby, -aby, abx, abx), t2);
+  const __m128 b = _mm_mul_ps(_mm_setr_ps(-bcy, -bcy, bcx, bcx), t0);
+  const __m128 c = _mm_mul_ps(_mm_setr_ps(-cay, -cay, cax, cax), t1);
+  const __m128 derivs = _mm_mul_ps(_mm_add_ps(_mm_add_ps(a, b), c), _mm_set1_ps(rcp_area));
+  negative_mask = static_cast<u32>(_mm_movemask_ps(_mm_cmplt_ps(derivs, _mm_setzero_ps())));
+  zero_mask = static_cast<u32>(_mm_movemask_ps(_mm_cmpeq_ps(derivs, _mm_setzero_ps())));
+#elif defined(CPU_AARCH64)
+  const s32 t0_values[4] = {vertices[0].u, vertices[0].v, vertices[0].u, vertices[0].v};
+  const s32 t1_values[4] = {vertices[1].u, vertices[1].v, vertices[1].u, vertices[1].v};
+  const s32 t2_values[4] = {vertices[2].u, vertices[2].v, vertices[2].u, vertices[2].v};
+  const float a_values[4] = {-aby, -aby, abx, abx};
+  const float b_values[4] = {-bcy, -bcy, bcx, bcx};
+  const float c_values[4] = {-cay, -cay, cax, cax};
+  const float32x4_t a = vmulq_f32(vld1q_f32(a_values), vcvtq_f32_s32(vld1q_s32(t2_values)));
+  const float32x4_t b = vmulq_f32(vld1q_f32(b_values), vcvtq_f32_s32(vld1q_s32(t0_values)));
+  const float32x4_t c = vmulq_f32(vld1q_f32(c_values), vcvtq_f32_s32(vld1q_s32(t1_values)));
+  const float32x4_t derivs = vmulq_n_f32(vaddq_f32(vaddq_f32(a, b), c), rcp_area);
+  static constexpr u32 lane_bits[4] = {1, 2, 4, 8};
+  const uint32x4_t bits = vld1q_u32(lane_bits);
+  negative_mask = vaddvq_u32(vandq_u32(vcltzq_f32(derivs), bits));
+  zero_mask = vaddvq_u32(vandq_u32(vceqzq_f32(derivs), bits));
+#else
+  const float derivs[4] = {
+    (-aby * static_cast<float>(vertices[2].u) - bcy * static_cast<float>(vertices[0].u) -
+     cay * static_cast<float>(vertices[1].u)) *
+      rcp_area,
+    (-aby * static_cast<float>(vertices[2].v) - bcy * static_cast<float>(vertices[0].v) -
+     cay * static_cast<float>(vertices[1].v)) *
+      rcp_area,
+    (abx * static_cast<float>(vertices[2].u) + bcx * static_cast<float>(vertices[0].u) +
+     cax * static_cast<float>(vertices[1].u)) *
+      rcp_area,
+    (abx * static_cast<float>(vertices[2].v) + bcx * static_cast<float>(vertices[0].v) +
+     cax * static_cast<float>(vertices[1].v)) *
+      rcp_area};
+  negative_mask = 0;
+  zero_mask = 0;
+  for (u32 i = 0; i < 4; i++)
+  {
+    negative_mask |= BoolToUInt32(derivs[i] < 0.0f) << i;
+    zero_mask |= BoolToUInt32(derivs[i] == 0.0f) << i;
+  }
+#endif
 
   // If we have negative dU or dV in any direction, increment the U or V to work properly with nearest-neighbor in
   // this impl. If we don't have 1:1 pixel correspondence, this creates a slight "shift" in the sprite, but we
@@ -357,13 +457,13 @@ void GPU_HW::HandleFlippedQuadTextureCoordinates(BatchVertex* vertices)
   // rare cases where 3D meshes hit this scenario, and a single texel offset can pop in, but this is way better than
   // having borked 2D overall.
   //
-  // TODO: If perf becomes an issue, we can probably SIMD the 8 comparisons above,
-  // create an 8-bit code, and use a LUT to get the offsets.
   // Case 1: U is decreasing in X, but no change in Y.
   // Case 2: U is decreasing in Y, but no change in X.
   // Case 3: V is decreasing in X, but no change in Y.
   // Case 4: V is decreasing in Y, but no change in X.
-  if ((neg_dudx && zero_dudy) || (neg_dudy && zero_dudx))
+  // Bit 0 of the result covers cases 1/2 (U), bit 1 covers cases 3/4 (V).
+  const u32 fixup_mask = (negative_mask & (zero_mask >> 2)) | ((negative_mask >> 2) & zero_mask);
+  if (fixup_mask & 1u)
   {
     vertices[0].u++;
     vertices[1].u++;
@@ -371,7 +471,7 @@ void GPU_HW::HandleFlippedQuadTextureCoordinates(BatchVertex* vertices)
     vertices[3].u++;
   }
 
-  if ((neg_dvdx && zero_dvdy) || (neg_dvdy && zero_dvdx))
+  if (fixup_mask & 2u)
   {
     vertices[0].v++;
     vertices[1].v++;
@@ -556,6 +656,89 @@ void GPU_HW::DrawLine(float x0, float y0, u32 col0, float x1, float y1, u32 col1
   AddVertex(output[1]);
 }
 
+void GPU_HW::AddRectangleQuadVertices(float left, float top, float right, float bottom, float depth, u32 color,
+                                      u32 texpage, u16 tex_left, u16 tex_top, u16 tex_right, u16 tex_bottom,
+                                      u32 uv_limits)
+{
+  // The corners only differ in position and texcoord, so build them in vector registers and write each vertex with
+  // two 16-byte stores, rather than field by field into the (usually write-combined) vertex buffer.
+  static_assert(sizeof(BatchVertex) == 32 && offsetof(BatchVertex, color) == 16);
+  BatchVertex* dst = m_batch_current_vertex_ptr;
+
+#if defined(CPU_X64) || defined(CPU_AARCH64)
+  const u32 tc_tl = ZeroExtend32(tex_left) | (ZeroExtend32(tex_top) << 16);
+  const u32 tc_tr = ZeroExtend32(tex_right) | (ZeroExtend32(tex_top) << 16);
+  const u32 tc_bl = ZeroExtend32(tex_left) | (ZeroExtend32(tex_bottom) << 16);
+  const u32 tc_br = ZeroExtend32(tex_right) | (ZeroExtend32(tex_bottom) << 16);
+#endif
+
+#if defined(CPU_X64)
+  const __m128 pos_tl = _mm_setr_ps(left, top, depth, 1.0f);
+  const __m128 pos_tr = _mm_setr_ps(right, top, depth, 1.0f);
+  const __m128 pos_bl = _mm_setr_ps(left, bottom, depth, 1.0f);
+  const __m128 pos_br = _mm_setr_ps(right, bottom, depth, 1.0f);
+  const __m128i attr_tl = _mm_setr_epi32(color, texpage, tc_tl, uv_limits);
+  const __m128i attr_tr = _mm_setr_epi32(color, texpage, tc_tr, uv_limits);
+  const __m128i attr_bl = _mm_setr_epi32(color, texpage, tc_bl, uv_limits);
+  const __m128i attr_br = _mm_setr_epi32(color, texpage, tc_br, uv_limits);
+
+  const auto store = [](BatchVertex* v, __m128 pos, __m128i attr) {
+    _mm_storeu_ps(&v->x, pos);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&v->color), attr);
+  };
+
+  store(&dst[0], pos_tl, attr_tl);
+  store(&dst[1], pos_tr, attr_tr);
+  store(&dst[2], pos_bl, attr_bl);
+  store(&dst[3], pos_bl, attr_bl);
+  store(&dst[4], pos_tr, attr_tr);
+  store(&dst[5], pos_br, attr_br);
+#elif defined(CPU_AARCH64)
+  const float pos_tl_values[4] = {left, top, depth, 1.0f};
+  const float pos_tr_values[4] = {right, top, depth, 1.0f};
+  const float pos_bl_values[4] = {left, bottom, depth, 1.0f};
+  const float pos_br_values[4] = {right, bottom, depth, 1.0f};
+  const u32 attr_tl_values[4] = {color, texpage, tc_tl, uv_limits};
+  const u32 attr_tr_values[4] = {color, texpage, tc_tr, uv_limits};
+  const u32 attr_bl_values[4] = {color, texpage, tc_bl, uv_limits};
+  const u32 attr_br_values[4] = {color, texpage, tc_br, uv_limits};
+  const float32x4_t pos_tl = vld1q_f32(pos_tl_values);
+  const float32x4_t pos_tr = vld1q_f32(pos_tr_values);
+  const float32x4_t pos_bl = vld1q_f32(pos_bl_values);
+  const float32x4_t pos_br = vld1q_f32(pos_br_values);
+  const uint32x4_t attr_tl = vld1q_u32(attr_tl_values);
+  const uint32x4_t attr_tr = vld1q_u32(attr_tr_values);
+  const uint32x4_t attr_bl = vld1q_u32(attr_bl_values);
+  const uint32x4_t attr_br = vld1q_u32(attr_br_values);
+
+  const auto store = [](BatchVertex* v, float32x4_t pos, uint32x4_t attr) {
+    vst1q_f32(&v->x, pos);
+    vst1q_u32(&v->color, attr);
+  };
+
+  store(&dst[0], pos_tl, attr_tl);
+  store(&dst[1], pos_tr, attr_tr);
+  store(&dst[2], pos_bl, attr_bl);
+  store(&dst[3], pos_bl, attr_bl);
+  store(&dst[4], pos_tr, attr_tr);
+  store(&dst[5], pos_br, attr_br);
+#else
+  BatchVertex tl, tr, bl, br;
+  tl.Set(left, top, depth, 1.0f, color, texpage, tex_left, tex_top, uv_limits);
+  tr.Set(right, top, depth, 1.0f, color, texpage, tex_right, tex_top, uv_limits);
+  bl.Set(left, bottom, depth, 1.0f, color, texpage, tex_left, tex_bottom, uv_limits);
+  br.Set(right, bottom, depth, 1.0f, color, texpage, tex_right, tex_bottom, uv_limits);
+  std::memcpy(&dst[0], &tl, sizeof(BatchVertex));
+  std::memcpy(&dst[1], &tr, sizeof(BatchVertex));
+  std::memcpy(&dst[2], &bl, sizeof(BatchVertex));
+  std::memcpy(&dst[3], &bl, sizeof(BatchVertex));
+  std::memcpy(&dst[4], &tr, sizeof(BatchVertex));
+  std::memcpy(&dst[5], &br, sizeof(BatchVertex));
+#endif
+
+  m_batch_current_vertex_ptr += 6;
+}
+
 void GPU_HW::LoadVertices()
 {
   if (m_GPUSTAT.check_mask_before_draw)
@@ -650,7 +833,7 @@ void GPU_HW::LoadVertices()
         const u32 clip_bottom =
           static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-        m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+        IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
         AddDrawTriangleTicks(native_vertex_positions[0][0], native_vertex_positions[0][1],
                              native_vertex_positions[1][0], native_vertex_positions[1][1],
                              native_vertex_positions[2][0], native_vertex_positions[2][1], rc.shading_enable,
@@ -684,7 +867,7 @@ void GPU_HW::LoadVertices()
           const u32 clip_bottom =
             static_cast<u32>(std::clamp<s32>(max_y_123, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-          m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+          IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
           AddDrawTriangleTicks(native_vertex_positions[2][0], native_vertex_positions[2][1],
                                native_vertex_positions[1][0], native_vertex_positions[1][1],
                                native_vertex_positions[3][0], native_vertex_positions[3][1], rc.shading_enable,
@@ -782,13 +965,8 @@ void GPU_HW::LoadVertices()
           const u16 tex_right = tex_left + static_cast<u16>(quad_width);
           const u32 uv_limits = BatchVertex::PackUVLimits(tex_left, tex_right - 1, tex_top, tex_bottom - 1);
 
-          AddNewVertex(quad_start_x, quad_start_y, depth, 1.0f, color, texpage, tex_left, tex_top, uv_limits);
-          AddNewVertex(quad_end_x, quad_start_y, depth, 1.0f, color, texpage, tex_right, tex_top, uv_limits);
-          AddNewVertex(quad_start_x, quad_end_y, depth, 1.0f, color, texpage, tex_left, tex_bottom, uv_limits);
-
-          AddNewVertex(quad_start_x, quad_end_y, depth, 1.0f, color, texpage, tex_left, tex_bottom, uv_limits);
-          AddNewVertex(quad_end_x, quad_start_y, depth, 1.0f, color, texpage, tex_right, tex_top, uv_limits);
-          AddNewVertex(quad_end_x, quad_end_y, depth, 1.0f, color, texpage, tex_right, tex_bottom, uv_limits);
+          AddRectangleQuadVertices(quad_start_x, quad_start_y, quad_end_x, quad_end_y, depth, color, texpage,
+                                   tex_left, tex_top, tex_right, tex_bottom, uv_limits);
 
           x_offset += quad_width;
           tex_left = 0;
@@ -805,7 +983,7 @@ void GPU_HW::LoadVertices()
       const u32 clip_bottom =
         static_cast<u32>(std::clamp<s32>(pos_y + rectangle_height, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-      m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+      IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
       AddDrawRectangleTicks(clip_right - clip_left, clip_bottom - clip_top, rc.texture_enable, rc.transparency_enable);
 
       if (m_sw_renderer)
@@ -868,7 +1046,7 @@ void GPU_HW::LoadVertices()
         const u32 clip_bottom =
           static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-        m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+        IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
         AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, rc.shading_enable);
 
         // TODO: Should we do a PGXP lookup here? Most lines are 2D.
@@ -935,7 +1113,7 @@ void GPU_HW::LoadVertices()
             const u32 clip_bottom =
               static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-            m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+            IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
             AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, rc.shading_enable);
 
             // TODO: Should we do a PGXP lookup here? Most lines are 2D.
@@ -1044,6 +1222,7 @@ GPU_HW::VRAMCopyUBOData GPU_HW::GetVRAMCopyUBOData(u32 src_x, u32 src_y, u32 dst
 void GPU_HW::IncludeVRAMDirtyRectangle(const Common::Rectangle<u32>& rect)
 {
   m_vram_dirty_rect.Include(rect);
+  m_display_dirty_rect.Include(rect);
 
   // the vram area can include the texture page, but the game can leave it as-is. in this case, set it as dirty so the
   // shadow texture is updated
@@ -1055,6 +1234,70 @@ void GPU_HW::IncludeVRAMDirtyRectangle(const Common::Rectangle<u32>& rect)
   }
 }
 
+void GPU_HW::ClearDisplay()
+{
+  GPU::ClearDisplay();
+  InvalidateDisplayTexture();
+}
+
+void GPU_HW::UpdateDisplay()
+{
+  GPU::UpdateDisplay();
+
+  // the display texture gets replaced by the whole of VRAM
+  if (g_settings.debugging.show_vram)
+    InvalidateDisplayTexture();
+}
+
+bool GPU_HW::CanReuseDisplayTexture()
+{
+  const InterlacedRenderMode interlaced = GetInterlacedRenderMode();
+  const u32 field = (interlaced != InterlacedRenderMode::None) ? GetInterlacedDisplayField() : 0;
+
+  // 24-bit mode reads from the start of the line, and consumes 1.5 VRAM pixels per displayed pixel.
+  const bool is_24bit = m_GPUSTAT.display_area_color_depth_24;
+  const u32 left = is_24bit ? m_crtc_state.regs.X : m_crtc_state.display_vram_left;
+  const u32 skip_x = is_24bit ? (m_crtc_state.display_vram_left - m_crtc_state.regs.X) : 0;
+  const u32 width = is_24bit ? ((((skip_x + m_crtc_state.display_vram_width) * 3) + 1) / 2) :
+                               m_crtc_state.display_vram_width;
+  const u32 top = m_crtc_state.display_vram_top;
+  const u32 height = m_crtc_state.display_vram_height + BoolToUInt32(interlaced != InterlacedRenderMode::None);
+
+  // Be conservative when the display area wraps around VRAM.
+  const Common::Rectangle<u32> display_rect(((left + width) <= VRAM_WIDTH) ? left : 0,
+                                            ((top + height) <= VRAM_HEIGHT) ? top : 0,
+                                            ((left + width) <= VRAM_WIDTH) ? (left + width) : VRAM_WIDTH,
+                                            ((top + height) <= VRAM_HEIGHT) ? (top + height) : VRAM_HEIGHT);
+  const bool area_dirty = m_display_dirty_rect.Intersects(display_rect);
+  m_display_dirty_rect.SetInvalid();
+
+  const std::array<u32, 9> params = {m_crtc_state.display_vram_left,
+                                     m_crtc_state.display_vram_top,
+                                     m_crtc_state.display_vram_width,
+                                     m_crtc_state.display_vram_height,
+                                     m_crtc_state.regs.X,
+                                     BoolToUInt32(is_24bit),
+                                     static_cast<u32>(interlaced),
+                                     m_resolution_scale,
+                                     static_cast<u32>(GetDownsampleMode(m_resolution_scale))};
+  if (area_dirty || params != m_display_texture_params)
+  {
+    m_display_texture_params = params;
+    m_display_texture_valid_fields = 0;
+  }
+
+  // When interlaced, the other field's lines in the display texture come from the previous update.
+  const u8 field_bit = static_cast<u8>(1u << field);
+  if ((m_display_texture_valid_fields & field_bit) && g_host_display->GetDisplayTextureHandle())
+  {
+    m_skipped_display_updates++;
+    return true;
+  }
+
+  m_display_texture_valid_fields |= field_bit;
+  return false;
+}
+
 void GPU_HW::EnsureVertexBufferSpace(u32 required_vertices)
 {
   if (m_batch_current_vertex_ptr)
@@ -1476,9 +1719,9 @@ GPU_HW::ShaderCompileProgressTracker::ShaderCompileProgressTracker(std::string t
 {
 }
 
-void GPU_HW::ShaderCompileProgressTracker::Increment()
+void GPU_HW::ShaderCompileProgressTracker::Increment(u32 count)
 {
-  m_progress++;
+  m_progress += count;
 
   const u64 tv = Common::Timer::GetCurrentValue();
   if ((tv - m_start_time) >= m_min_time && (tv - m_last_update_time) >= m_update_interval)
@@ -2,6 +2,7 @@
 #include "common/heap_array.h"
 #include "gpu.h"
 #include "host_display.h"
+#include <functional>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -53,6 +54,8 @@ protected:
   };
   static_assert(VRAM_UPDATE_TEXTURE_BUFFER_SIZE >= VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16));
 
+  /// Vertex layout shared by the batch pipelines of every backend. The position is kept as floats even without PGXP,
+  /// so changing this means updating the input layouts and batch shaders of all of them.
   struct BatchVertex
   {
     float x;
@@ -173,7 +176,7 @@ protected:
   public:
     ShaderCompileProgressTracker(std::string title, u32 total);
 
-    void Increment();
+    void Increment(u32 count = 1);
 
   private:
     std::string m_title;
@@ -193,6 +196,11 @@ protected:
                            static_cast<float>(rgba >> 24) * (1.0f / 255.0f));
   }
 
+  /// Runs task(index) for every index in [0, count) on a pool of worker threads plus the calling thread. Progress is
+  /// only reported from the calling thread. Tasks must be independent. Returns false if any of the tasks failed.
+  static bool CompileInParallel(u32 count, ShaderCompileProgressTracker& progress,
+                                const std::function<bool(u32)>& task);
+
   void UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed);
 
   virtual void UpdateVRAMReadTexture();
@@ -216,10 +224,21 @@ protected:
   void SetFullVRAMDirtyRectangle()
   {
     m_vram_dirty_rect.Set(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
+    m_display_dirty_rect.Set(0, 0, VRAM_WIDTH, VRAM_HEIGHT);
     m_draw_mode.SetTexturePageChanged();
   }
   void ClearVRAMDirtyRectangle() { m_vram_dirty_rect.SetInvalid(); }
   void IncludeVRAMDirtyRectangle(const Common::Rectangle<u32>& rect);
+  ALWAYS_INLINE void IncludeDrawnVRAMRectangle(u32 left, u32 right, u32 top, u32 bottom)
+  {
+    m_vram_dirty_rect.Include(left, right, top, bottom);
+    m_display_dirty_rect.Include(left, right, top, bottom);
+  }
+
+  /// Returns true if the displayed VRAM area has not been written since the current display texture was generated,
+  /// and it can be presented again as-is. Must be called once per display update.
+  bool CanReuseDisplayTexture();
+  void InvalidateDisplayTexture() { m_display_texture_valid_fields = 0; }
 
   bool IsFlushed() const { return m_batch_current_vertex_ptr == m_batch_start_vertex_ptr; }
 
@@ -302,6 +321,8 @@ protected:
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
   void DispatchRenderCommand() override;
   void FlushRender() override;
+  void ClearDisplay() override;
+  void UpdateDisplay() override;
   void DrawRendererStats(bool is_idle_frame) override;
 
   void CalcScissorRect(int* left, int* top, int* right, int* bottom);
@@ -390,6 +411,11 @@ protected:
   // Bounding box of VRAM area that the GPU has drawn into.
   Common::Rectangle<u32> m_vram_dirty_rect;
 
+  // Bounding box of VRAM area written since the last display update, and the parameters it was generated with.
+  Common::Rectangle<u32> m_display_dirty_rect;
+  std::array<u32, 9> m_display_texture_params = {};
+  u8 m_display_texture_valid_fields = 0;
+
   // Statistics
   RendererStats m_renderer_stats = {};
   RendererStats m_last_renderer_stats = {};
@@ -412,12 +438,9 @@ private:
     m_batch_current_vertex_ptr++;
   }
 
-  template<typename... Args>
-  ALWAYS_INLINE void AddNewVertex(Args&&... args)
-  {
-    m_batch_current_vertex_ptr->Set(std::forward<Args>(args)...);
-    m_batch_current_vertex_ptr++;
-  }
+  /// Adds the two triangles for an axis-aligned rectangle quad.
+  void AddRectangleQuadVertices(float left, float top, float right, float bottom, float depth, u32 color, u32 texpage,
+                                u16 tex_left, u16 tex_top, u16 tex_right, u16 tex_bottom, u32 uv_limits);
 
   void PrintSettingsToLog();
 };
@@ -903,6 +903,10 @@ void GPU_HW_D3D12::UpdateDisplay()
     {
       g_host_display->ClearDisplayTexture();
     }
+    else if (CanReuseDisplayTexture())
+    {
+      // nothing in the displayed area changed, so present the existing display texture again
+    }
     else if (!m_GPUSTAT.display_area_color_depth_24 && interlaced == InterlacedRenderMode::None &&
              !IsUsingMultisampling() && (scaled_vram_offset_x + scaled_display_width) <= m_vram_texture.GetWidth() &&
              (scaled_vram_offset_y + scaled_display_height) <= m_vram_texture.GetHeight())
@@ -902,6 +902,10 @@ void GPU_HW_OpenGL::UpdateDisplay()
     {
       g_host_display->ClearDisplayTexture();
     }
+    else if (CanReuseDisplayTexture())
+    {
+      // nothing in the displayed area changed, so present the existing display texture again
+    }
     else if (!m_GPUSTAT.display_area_color_depth_24 && interlaced == GPU_HW::InterlacedRenderMode::None &&
              !IsUsingMultisampling() && (scaled_vram_offset_x + scaled_display_width) <= m_vram_texture.GetWidth() &&
              (scaled_vram_offset_y + scaled_display_height) <= m_vram_texture.GetHeight())
@@ -926,6 +926,7 @@ bool GPU_HW_Vulkan::CompilePipelines()
                              m_true_color, m_scaled_dithering, m_texture_filtering, m_using_uv_limits,
                              m_pgxp_depth_buffer, m_supports_dual_source_blend);
 
+  // duckstation-shadercache generates the same shaders offline, update it when adding shaders here.
   ShaderCompileProgressTracker progress("Compiling Pipelines", 2 + (4 * 9 * 2 * 2) + (3 * 4 * 5 * 9 * 2 * 2) + 1 + 2 +
                                                                  (2 * 2) + 2 + 1 + 1 + (2 * 3) + 1);
 
@@ -949,125 +950,112 @@ bool GPU_HW_Vulkan::CompilePipelines()
     progress.Increment();
   }
 
-  for (u8 render_mode = 0; render_mode < 4; render_mode++)
+  // Generating and compiling the batch shaders and pipelines dominates the time spent here, and every variant is
+  // independent, so spread them across the worker pool. Results are written to distinct slots.
+  if (!CompileInParallel(4 * 9 * 2 * 2, progress, [&shadergen, &batch_fragment_shaders](u32 index) {
+        const u8 interlacing = static_cast<u8>(index % 2);
+        const u8 dithering = static_cast<u8>((index / 2) % 2);
+        const u8 texture_mode = static_cast<u8>((index / (2 * 2)) % 9);
+        const u8 render_mode = static_cast<u8>(index / (2 * 2 * 9));
+
+        const std::string fs = shadergen.GenerateBatchFragmentShader(
+          static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
+          ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
+
+        VkShaderModule shader = g_vulkan_shader_cache->GetFragmentShader(fs);
+        batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing] = shader;
+        return (shader != VK_NULL_HANDLE);
+      }))
   {
-    for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
-    {
-      for (u8 dithering = 0; dithering < 2; dithering++)
-      {
-        for (u8 interlacing = 0; interlacing < 2; interlacing++)
-        {
-          const std::string fs = shadergen.GenerateBatchFragmentShader(
-            static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
-            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
-
-          VkShaderModule shader = g_vulkan_shader_cache->GetFragmentShader(fs);
-          if (shader == VK_NULL_HANDLE)
-            return false;
+    return false;
+  }
 
-          batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing] = shader;
-          progress.Increment();
+  // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
+  if (!CompileInParallel(3 * 4 * 5 * 9 * 2 * 2, progress, [this, device, pipeline_cache, &batch_vertex_shaders,
+                                                            &batch_fragment_shaders](u32 index) {
+        const u8 interlacing = static_cast<u8>(index % 2);
+        const u8 dithering = static_cast<u8>((index / 2) % 2);
+        const u8 texture_mode = static_cast<u8>((index / (2 * 2)) % 9);
+        const u8 transparency_mode = static_cast<u8>((index / (2 * 2 * 9)) % 5);
+        const u8 render_mode = static_cast<u8>((index / (2 * 2 * 9 * 5)) % 4);
+        const u8 depth_test = static_cast<u8>(index / (2 * 2 * 9 * 5 * 4));
+
+        static constexpr std::array<VkCompareOp, 3> depth_test_values = {
+          VK_COMPARE_OP_ALWAYS, VK_COMPARE_OP_GREATER_OR_EQUAL, VK_COMPARE_OP_LESS_OR_EQUAL};
+        const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
+
+        Vulkan::GraphicsPipelineBuilder gpbuilder;
+        gpbuilder.SetPipelineLayout(m_batch_pipeline_layout);
+        gpbuilder.SetRenderPass(m_vram_render_pass, 0);
+
+        gpbuilder.AddVertexBuffer(0, sizeof(BatchVertex), VK_VERTEX_INPUT_RATE_VERTEX);
+        gpbuilder.AddVertexAttribute(0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(BatchVertex, x));
+        gpbuilder.AddVertexAttribute(1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, color));
+        if (textured)
+        {
+          gpbuilder.AddVertexAttribute(2, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, u));
+          gpbuilder.AddVertexAttribute(3, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, texpage));
+          if (m_using_uv_limits)
+            gpbuilder.AddVertexAttribute(4, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, uv_limits));
         }
-      }
-    }
-  }
 
-  Vulkan::GraphicsPipelineBuilder gpbuilder;
+        gpbuilder.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+        gpbuilder.SetVertexShader(batch_vertex_shaders[BoolToUInt8(textured)]);
+        gpbuilder.SetFragmentShader(batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing]);
 
-  // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
-  for (u8 depth_test = 0; depth_test < 3; depth_test++)
-  {
-    for (u8 render_mode = 0; render_mode < 4; render_mode++)
-    {
-      for (u8 transparency_mode = 0; transparency_mode < 5; transparency_mode++)
-      {
-        for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
+        gpbuilder.SetRasterizationState(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
+        gpbuilder.SetDepthState(true, true, depth_test_values[depth_test]);
+        gpbuilder.SetNoBlendingState();
+        gpbuilder.SetMultisamples(m_multisamples, m_per_sample_shading);
+
+        if ((static_cast<GPUTransparencyMode>(transparency_mode) != GPUTransparencyMode::Disabled &&
+             (static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+              static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque)) ||
+            m_texture_filtering != GPUTextureFilter::Nearest)
         {
-          for (u8 dithering = 0; dithering < 2; dithering++)
+          if (m_supports_dual_source_blend)
+          {
+            gpbuilder.SetBlendAttachment(
+              0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_SRC1_ALPHA,
+              (static_cast<GPUTransparencyMode>(transparency_mode) == GPUTransparencyMode::BackgroundMinusForeground &&
+               static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+               static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
+                VK_BLEND_OP_REVERSE_SUBTRACT :
+                VK_BLEND_OP_ADD,
+              VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
+          }
+          else
           {
-            for (u8 interlacing = 0; interlacing < 2; interlacing++)
-            {
-              static constexpr std::array<VkCompareOp, 3> depth_test_values = {
-                VK_COMPARE_OP_ALWAYS, VK_COMPARE_OP_GREATER_OR_EQUAL, VK_COMPARE_OP_LESS_OR_EQUAL};
-              const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
-
-              gpbuilder.SetPipelineLayout(m_batch_pipeline_layout);
-              gpbuilder.SetRenderPass(m_vram_render_pass, 0);
-
-              gpbuilder.AddVertexBuffer(0, sizeof(BatchVertex), VK_VERTEX_INPUT_RATE_VERTEX);
-              gpbuilder.AddVertexAttribute(0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(BatchVertex, x));
-              gpbuilder.AddVertexAttribute(1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, color));
-              if (textured)
-              {
-                gpbuilder.AddVertexAttribute(2, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, u));
-                gpbuilder.AddVertexAttribute(3, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, texpage));
-                if (m_using_uv_limits)
-                  gpbuilder.AddVertexAttribute(4, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, uv_limits));
-              }
-
-              gpbuilder.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
-              gpbuilder.SetVertexShader(batch_vertex_shaders[BoolToUInt8(textured)]);
-              gpbuilder.SetFragmentShader(batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing]);
-
-              gpbuilder.SetRasterizationState(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
-              gpbuilder.SetDepthState(true, true, depth_test_values[depth_test]);
-              gpbuilder.SetNoBlendingState();
-              gpbuilder.SetMultisamples(m_multisamples, m_per_sample_shading);
-
-              if ((static_cast<GPUTransparencyMode>(transparency_mode) != GPUTransparencyMode::Disabled &&
-                   (static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                    static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque)) ||
-                  m_texture_filtering != GPUTextureFilter::Nearest)
-              {
-                if (m_supports_dual_source_blend)
-                {
-                  gpbuilder.SetBlendAttachment(
-                    0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_SRC1_ALPHA,
-                    (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                       GPUTransparencyMode::BackgroundMinusForeground &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
-                      VK_BLEND_OP_REVERSE_SUBTRACT :
-                      VK_BLEND_OP_ADD,
-                    VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
-                }
-                else
-                {
-                  const float factor = (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                                        GPUTransparencyMode::HalfBackgroundPlusHalfForeground) ?
-                                         0.5f :
-                                         1.0f;
-                  gpbuilder.SetBlendAttachment(
-                    0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_CONSTANT_ALPHA,
-                    (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                       GPUTransparencyMode::BackgroundMinusForeground &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
-                      VK_BLEND_OP_REVERSE_SUBTRACT :
-                      VK_BLEND_OP_ADD,
-                    VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
-                  gpbuilder.SetBlendConstants(0.0f, 0.0f, 0.0f, factor);
-                }
-              }
-
-              gpbuilder.SetDynamicViewportAndScissorState();
-
-              VkPipeline pipeline = gpbuilder.Create(device, pipeline_cache);
-              if (pipeline == VK_NULL_HANDLE)
-                return false;
-
-              m_batch_pipelines[depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing] =
-                pipeline;
-              progress.Increment();
-            }
+            const float factor = (static_cast<GPUTransparencyMode>(transparency_mode) ==
+                                  GPUTransparencyMode::HalfBackgroundPlusHalfForeground) ?
+                                   0.5f :
+                                   1.0f;
+            gpbuilder.SetBlendAttachment(
+              0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_CONSTANT_ALPHA,
+              (static_cast<GPUTransparencyMode>(transparency_mode) == GPUTransparencyMode::BackgroundMinusForeground &&
+               static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+               static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
+                VK_BLEND_OP_REVERSE_SUBTRACT :
+                VK_BLEND_OP_ADD,
+              VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
+            gpbuilder.SetBlendConstants(0.0f, 0.0f, 0.0f, factor);
           }
         }
-      }
-    }
+
+        gpbuilder.SetDynamicViewportAndScissorState();
+
+        VkPipeline pipeline = gpbuilder.Create(device, pipeline_cache);
+        m_batch_pipelines[depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing] = pipeline;
+        return (pipeline != VK_NULL_HANDLE);
+      }))
+  {
+    return false;
   }
 
   batch_shader_guard.Exit();
 
+  Vulkan::GraphicsPipelineBuilder gpbuilder;
+
   VkShaderModule fullscreen_quad_vertex_shader =
     g_vulkan_shader_cache->GetVertexShader(shadergen.GenerateScreenQuadVertexShader());
   if (fullscreen_quad_vertex_shader == VK_NULL_HANDLE)
@@ -1469,6 +1457,10 @@ void GPU_HW_Vulkan::UpdateDisplay()
     {
       g_host_display->ClearDisplayTexture();
     }
+    else if (CanReuseDisplayTexture())
+    {
+      // nothing in the displayed area changed, so present the existing display texture again
+    }
     else if (!m_GPUSTAT.display_area_color_depth_24 && interlaced == InterlacedRenderMode::None &&
              !IsUsingMultisampling() && (scaled_vram_offset_x + scaled_display_width) <= m_vram_texture.GetWidth() &&
              (scaled_vram_offset_y + scaled_display_height) <= m_vram_texture.GetHeight())
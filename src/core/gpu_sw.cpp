@@ -4,8 +4,11 @@
 #include "common/log.h"
 #include "common/make_array.h"
 #include "common/platform.h"
+#include "host.h"
 #include "host_display.h"
+#include "imgui.h"
 #include "system.h"
+#include "xxhash.h"
 #include <algorithm>
 Log_SetChannel(GPU_SW);
 
@@ -478,9 +481,54 @@ void GPU_SW::CopyOut24Bit(HostDisplayPixelFormat display_format, u32 src_x, u32
   }
 }
 
+u64 GPU_SW::HashDisplayArea(u32 src_x, u32 src_y, u32 width, u32 rows, u32 row_step, u64 seed) const
+{
+  u64 hash = seed;
+  for (u32 row = 0; row < rows; row++)
+  {
+    const u16* row_ptr = &m_vram_ptr[((src_y + row * row_step) % VRAM_HEIGHT) * VRAM_WIDTH];
+    if ((src_x + width) <= VRAM_WIDTH)
+    {
+      hash = XXH3_64bits_withSeed(row_ptr + src_x, width * sizeof(u16), hash);
+    }
+    else
+    {
+      // wraps around the right edge of VRAM
+      const u32 first_width = VRAM_WIDTH - src_x;
+      hash = XXH3_64bits_withSeed(row_ptr + src_x, first_width * sizeof(u16), hash);
+      hash = XXH3_64bits_withSeed(row_ptr, (width - first_width) * sizeof(u16), hash);
+    }
+  }
+
+  return hash;
+}
+
+bool GPU_SW::IsDisplayAreaUnchanged(u64 params_hash, u32 field, u64 area_hash)
+{
+  if (m_display_params_hash != params_hash)
+  {
+    m_display_params_hash = params_hash;
+    m_display_field_hashes = {};
+  }
+
+  // The other field's lines are still in the host texture from the previous upload, so only this field has to match.
+  if (m_display_field_hashes[field] == area_hash && g_host_display->GetDisplayTextureHandle())
+    return true;
+
+  m_display_field_hashes[field] = area_hash;
+  return false;
+}
+
+void GPU_SW::InvalidateDisplayHashes()
+{
+  m_display_params_hash = 0;
+  m_display_field_hashes = {};
+}
+
 void GPU_SW::ClearDisplay()
 {
   std::memset(m_display_texture_buffer.data(), 0, m_display_texture_buffer.size());
+  InvalidateDisplayHashes();
 }
 
 void GPU_SW::UpdateDisplay()
@@ -498,45 +546,50 @@ void GPU_SW::UpdateDisplay()
     if (IsDisplayDisabled())
     {
       g_host_display->ClearDisplayTexture();
+      InvalidateDisplayHashes();
       return;
     }
 
+    const bool is_24bit = m_GPUSTAT.display_area_color_depth_24;
+    const bool interlaced = IsInterlacedDisplayEnabled();
+    const bool interleaved = interlaced && m_GPUSTAT.vertical_resolution;
+    const u32 field = interlaced ? GetInterlacedDisplayField() : 0;
+    const u32 src_x = is_24bit ? m_crtc_state.regs.X : m_crtc_state.display_vram_left;
+    const u32 skip_x = is_24bit ? (m_crtc_state.display_vram_left - m_crtc_state.regs.X) : 0;
     const u32 vram_offset_y = m_crtc_state.display_vram_top;
     const u32 display_width = m_crtc_state.display_vram_width;
     const u32 display_height = m_crtc_state.display_vram_height;
+    const HostDisplayPixelFormat format = is_24bit ? m_24bit_display_format : m_16bit_display_format;
+
+    // Skip the conversion and upload when neither the displayed VRAM area nor the way it is read has changed.
+    const u32 params[] = {static_cast<u32>(format), src_x, vram_offset_y, skip_x, display_width, display_height,
+                          BoolToUInt32(interlaced), BoolToUInt32(interleaved)};
+    const u32 hash_width = is_24bit ? std::min<u32>((((skip_x + display_width) * 3) + 1) / 2, VRAM_WIDTH) :
+                                      std::min<u32>(display_width, VRAM_WIDTH);
+    const u32 hash_rows = display_height >> BoolToUInt8(interlaced);
+    const u64 params_hash = XXH3_64bits(params, sizeof(params));
+    const u64 area_hash =
+      HashDisplayArea(src_x, vram_offset_y + field, hash_width, hash_rows, interleaved ? 2 : 1, params_hash);
+    if (IsDisplayAreaUnchanged(params_hash, field, area_hash))
+    {
+      m_skipped_display_updates++;
+      return;
+    }
 
-    if (IsInterlacedDisplayEnabled())
+    if (is_24bit)
     {
-      const u32 field = GetInterlacedDisplayField();
-      if (m_GPUSTAT.display_area_color_depth_24)
-      {
-        CopyOut24Bit(m_24bit_display_format, m_crtc_state.regs.X, vram_offset_y + field,
-                     m_crtc_state.display_vram_left - m_crtc_state.regs.X, display_width, display_height, field, true,
-                     m_GPUSTAT.vertical_resolution);
-      }
-      else
-      {
-        CopyOut15Bit(m_16bit_display_format, m_crtc_state.display_vram_left, vram_offset_y + field, display_width,
-                     display_height, field, true, m_GPUSTAT.vertical_resolution);
-      }
+      CopyOut24Bit(format, src_x, vram_offset_y + field, skip_x, display_width, display_height, field, interlaced,
+                   interleaved);
     }
     else
     {
-      if (m_GPUSTAT.display_area_color_depth_24)
-      {
-        CopyOut24Bit(m_24bit_display_format, m_crtc_state.regs.X, vram_offset_y,
-                     m_crtc_state.display_vram_left - m_crtc_state.regs.X, display_width, display_height, 0, false,
-                     false);
-      }
-      else
-      {
-        CopyOut15Bit(m_16bit_display_format, m_crtc_state.display_vram_left, vram_offset_y, display_width,
-                     display_height, 0, false, false);
-      }
+      CopyOut15Bit(format, src_x, vram_offset_y + field, display_width, display_height, field, interlaced,
+                   interleaved);
     }
   }
   else
   {
+    InvalidateDisplayHashes();
     CopyOut15Bit(m_16bit_display_format, 0, 0, VRAM_WIDTH, VRAM_HEIGHT, 0, false, false);
     g_host_display->SetDisplayParameters(VRAM_WIDTH, VRAM_HEIGHT, 0, 0, VRAM_WIDTH, VRAM_HEIGHT,
                                          static_cast<float>(VRAM_WIDTH) / static_cast<float>(VRAM_HEIGHT));
@@ -826,6 +879,54 @@ void GPU_SW::DispatchRenderCommand()
   }
 }
 
+void GPU_SW::DrawRendererStats(bool is_idle_frame)
+{
+  if (!is_idle_frame)
+  {
+    m_backend.Sync(false);
+    m_last_texture_page_cache_stats = m_backend.GetTexturePageCacheStats();
+    m_backend.ResetTexturePageCacheStats();
+  }
+
+  if (ImGui::CollapsingHeader("Renderer Statistics", ImGuiTreeNodeFlags_DefaultOpen))
+  {
+    const auto& stats = m_last_texture_page_cache_stats;
+    const u32 num_lookups = stats.num_hits + stats.num_misses;
+
+    ImGui::Columns(2);
+    ImGui::SetColumnWidth(0, 200.0f * Host::GetOSDScale());
+
+    ImGui::TextUnformatted("Texture Page Hits:");
+    ImGui::NextColumn();
+    ImGui::Text("%u (%.1f%%)", stats.num_hits,
+                (num_lookups > 0) ? (static_cast<float>(stats.num_hits) * 100.0f / static_cast<float>(num_lookups)) :
+                                    0.0f);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Texture Page Misses:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_misses);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Texture Page Bypasses:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_bypasses);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Texture Segment Decodes:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_segment_decodes);
+    ImGui::NextColumn();
+
+    ImGui::TextUnformatted("Texture Page Invalidations:");
+    ImGui::NextColumn();
+    ImGui::Text("%u", stats.num_invalidations);
+    ImGui::NextColumn();
+
+    ImGui::Columns(1);
+  }
+}
+
 void GPU_SW::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 {
   m_backend.Sync(false);
@@ -46,11 +46,17 @@ protected:
   void CopyOut24Bit(HostDisplayPixelFormat display_format, u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height,
                     u32 field, bool interlaced, bool interleaved);
 
+  u64 HashDisplayArea(u32 src_x, u32 src_y, u32 width, u32 rows, u32 row_step, u64 seed) const;
+  bool IsDisplayAreaUnchanged(u64 params_hash, u32 field, u64 area_hash);
+  void InvalidateDisplayHashes();
+
   void ClearDisplay() override;
   void UpdateDisplay() override;
 
   void DispatchRenderCommand() override;
 
+  void DrawRendererStats(bool is_idle_frame) override;
+
   void FillBackendCommandParameters(GPUBackendCommand* cmd) const;
   void FillDrawCommand(GPUBackendDrawCommand* cmd, GPURenderCommand rc) const;
 
@@ -58,5 +64,10 @@ protected:
   HostDisplayPixelFormat m_16bit_display_format = HostDisplayPixelFormat::RGB565;
   HostDisplayPixelFormat m_24bit_display_format = HostDisplayPixelFormat::RGBA8;
 
+  // Hashes of the parameters and VRAM contents of the last display upload, per field. Zero means invalid.
+  u64 m_display_params_hash = 0;
+  std::array<u64, 2> m_display_field_hashes = {};
+
   GPU_SW_Backend m_backend;
+  GPU_SW_Backend::TexturePageCacheStats m_last_texture_page_cache_stats = {};
 };
@@ -1,7 +1,7 @@
 #include "gpu_sw_backend.h"
 #include "common/assert.h"
+#include "common/bitutils.h"
 #include "common/log.h"
-#include "gpu_sw_backend.h"
 #include "host_display.h"
 #include "system.h"
 #include <algorithm>
@@ -26,12 +26,17 @@ void GPU_SW_Backend::Reset(bool clear_vram)
 
   if (clear_vram)
     m_vram.fill(0);
+
+  InvalidateTexturePageCache();
+  ResetTexturePageCacheStats();
 }
 
 void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
 {
   const GPURenderCommand rc{cmd->rc.bits};
   const bool dithering_enable = rc.IsDitheringEnabled() && cmd->draw_mode.dither_enable;
+  if (rc.texture_enable)
+    BindTexturePageCacheEntry(cmd);
 
   const DrawTriangleFunction DrawFunction = GetDrawTriangleFunction(
     rc.shading_enable, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable, dithering_enable);
@@ -44,6 +49,8 @@ void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
 void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
 {
   const GPURenderCommand rc{cmd->rc.bits};
+  if (rc.texture_enable)
+    BindTexturePageCacheEntry(cmd);
 
   const DrawRectangleFunction DrawFunction =
     GetDrawRectangleFunction(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
@@ -91,37 +98,46 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawComman
     texcoord_y = (texcoord_y & cmd->window.and_y) | cmd->window.or_y;
 
     VRAMPixel texture_color;
-    switch (cmd->draw_mode.texture_mode)
+    if (m_current_texture_page)
+    {
+      // Palette already resolved by the texture page cache.
+      texture_color.bits = GetCachedTexel(texcoord_x, texcoord_y);
+    }
+    else
     {
-      case GPUTextureMode::Palette4Bit:
+      switch (cmd->draw_mode.texture_mode)
       {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
+        case GPUTextureMode::Palette4Bit:
+        {
+          const u16 palette_value =
+            GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
+                     (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+          const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
 
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
+          texture_color.bits =
+            GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
+        }
+        break;
 
-      case GPUTextureMode::Palette8Bit:
-      {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
+        case GPUTextureMode::Palette8Bit:
+        {
+          const u16 palette_value =
+            GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
+                     (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+          const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
+          texture_color.bits =
+            GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
+        }
+        break;
 
-      default:
-      {
-        texture_color.bits = GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
-                                      (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+        default:
+        {
+          texture_color.bits =
+            GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
+                     (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+        }
+        break;
       }
-      break;
     }
 
     if (texture_color.bits == 0)
@@ -718,6 +734,8 @@ void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBac
 
 void GPU_SW_Backend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params)
 {
+  InvalidateTexturePageCache(x, y, width, height);
+
   const u16 color16 = VRAMRGBA8888ToRGBA5551(color);
   if ((x + width) <= VRAM_WIDTH && !params.interlaced_rendering)
   {
@@ -763,6 +781,8 @@ void GPU_SW_Backend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GP
 void GPU_SW_Backend::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data,
                                 GPUBackendCommandParameters params)
 {
+  InvalidateTexturePageCache(x, y, width, height);
+
   // Fast path when the copy is not oversized.
   if ((x + width) <= VRAM_WIDTH && (y + height) <= VRAM_HEIGHT && !params.IsMaskingEnabled())
   {
@@ -799,6 +819,8 @@ void GPU_SW_Backend::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
 void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height,
                               GPUBackendCommandParameters params)
 {
+  InvalidateTexturePageCache(dst_x, dst_y, width, height);
+
   // Break up oversized copies. This behavior has not been verified on console.
   if ((src_x + width) > VRAM_WIDTH || (dst_x + width) > VRAM_WIDTH)
   {
@@ -872,7 +894,140 @@ void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wi
 
 void GPU_SW_Backend::FlushRender() {}
 
-void GPU_SW_Backend::DrawingAreaChanged() {}
+void GPU_SW_Backend::DrawingAreaChanged()
+{
+  // Pages overlapping the drawing area are never cached, so anything drawn can't touch a cached page.
+  if (m_drawing_area.Valid())
+  {
+    InvalidateTexturePageCache(m_drawing_area.left, m_drawing_area.top, m_drawing_area.GetWidth() + 1,
+                               m_drawing_area.GetHeight() + 1);
+  }
+}
+
+static constexpr bool WrappedRangesOverlap(u32 a_start, u32 a_size, u32 b_start, u32 b_size, u32 modulus)
+{
+  return ((b_start - a_start) % modulus) < a_size || ((a_start - b_start) % modulus) < b_size;
+}
+
+bool GPU_SW_Backend::TexturePageCacheAreaOverlaps(GPUDrawModeReg draw_mode, GPUTexturePaletteReg palette, u32 x,
+                                                  u32 y, u32 width, u32 height)
+{
+  const bool is_8bit = (draw_mode.texture_mode == GPUTextureMode::Palette8Bit);
+  const u32 page_width = is_8bit ? (TEXTURE_PAGE_WIDTH / 2) : (TEXTURE_PAGE_WIDTH / 4);
+  const u32 palette_width = is_8bit ? 256 : 16;
+
+  return (WrappedRangesOverlap(draw_mode.GetTexturePageBaseX(), page_width, x, width, VRAM_WIDTH) &&
+          WrappedRangesOverlap(draw_mode.GetTexturePageBaseY(), TEXTURE_PAGE_HEIGHT, y, height, VRAM_HEIGHT)) ||
+         (WrappedRangesOverlap(palette.GetXBase(), palette_width, x, width, VRAM_WIDTH) &&
+          WrappedRangesOverlap(palette.GetYBase(), 1, y, height, VRAM_HEIGHT));
+}
+
+void GPU_SW_Backend::InvalidateTexturePageCache(u32 x, u32 y, u32 width, u32 height)
+{
+  for (u32 mask = m_texture_page_cache_valid_mask; mask != 0; mask &= (mask - 1))
+  {
+    const u32 index = CountTrailingZeros(mask);
+    const TexturePageCacheEntry& entry = m_texture_page_cache[index];
+    if (TexturePageCacheAreaOverlaps(entry.draw_mode, entry.palette, x, y, width, height))
+    {
+      m_texture_page_cache_valid_mask &= ~(1u << index);
+      m_texture_page_cache_stats.num_invalidations++;
+    }
+  }
+}
+
+void GPU_SW_Backend::InvalidateTexturePageCache()
+{
+  m_texture_page_cache_valid_mask = 0;
+  m_current_texture_page = nullptr;
+}
+
+void GPU_SW_Backend::BindTexturePageCacheEntry(const GPUBackendDrawCommand* cmd)
+{
+  m_current_texture_page = nullptr;
+  if (!cmd->draw_mode.IsUsingPalette())
+    return;
+
+  const u32 key = GetTexturePageCacheKey(cmd->draw_mode, cmd->palette);
+  u32 victim_index = 0;
+  u32 victim_last_used = UINT32_MAX;
+  for (u32 i = 0; i < TEXTURE_PAGE_CACHE_SIZE; i++)
+  {
+    TexturePageCacheEntry& entry = m_texture_page_cache[i];
+    if (!(m_texture_page_cache_valid_mask & (1u << i)))
+    {
+      victim_index = i;
+      victim_last_used = 0;
+      continue;
+    }
+
+    if (entry.key == key)
+    {
+      entry.last_used = ++m_texture_page_cache_counter;
+      m_current_texture_page = &entry;
+      m_texture_page_cache_stats.num_hits++;
+      return;
+    }
+
+    if (entry.last_used < victim_last_used)
+    {
+      victim_index = i;
+      victim_last_used = entry.last_used;
+    }
+  }
+
+  // Render-to-texture into the sampled page or CLUT would change texels mid-draw, so sample VRAM directly instead.
+  if (m_drawing_area.Valid() &&
+      TexturePageCacheAreaOverlaps(cmd->draw_mode, cmd->palette, m_drawing_area.left, m_drawing_area.top,
+                                   m_drawing_area.GetWidth() + 1, m_drawing_area.GetHeight() + 1))
+  {
+    m_texture_page_cache_stats.num_bypasses++;
+    return;
+  }
+
+  TexturePageCacheEntry& entry = m_texture_page_cache[victim_index];
+  entry.key = key;
+  entry.draw_mode.bits = cmd->draw_mode.bits;
+  entry.palette.bits = cmd->palette.bits;
+  entry.last_used = ++m_texture_page_cache_counter;
+  entry.valid_segments.fill(0);
+  m_texture_page_cache_valid_mask |= (1u << victim_index);
+  m_current_texture_page = &entry;
+  m_texture_page_cache_stats.num_misses++;
+}
+
+void GPU_SW_Backend::DecodeTexturePageSegment(TexturePageCacheEntry* entry, u32 segment)
+{
+  const u32 texcoord_y = segment / TEXTURE_PAGE_CACHE_SEGMENTS_PER_ROW;
+  const u32 start_x = (segment % TEXTURE_PAGE_CACHE_SEGMENTS_PER_ROW) * TEXTURE_PAGE_CACHE_SEGMENT_WIDTH;
+  const u32 page_x = entry->draw_mode.GetTexturePageBaseX();
+  const u16* page_row = GetPixelPtr(0, (entry->draw_mode.GetTexturePageBaseY() + texcoord_y) % VRAM_HEIGHT);
+  const u16* palette_row = GetPixelPtr(0, entry->palette.GetYBase());
+  const u32 palette_x = entry->palette.GetXBase();
+  u16* dst_ptr = &entry->texels[texcoord_y * TEXTURE_PAGE_WIDTH + start_x];
+
+  if (entry->draw_mode.texture_mode == GPUTextureMode::Palette4Bit)
+  {
+    for (u32 texcoord_x = start_x; texcoord_x < (start_x + TEXTURE_PAGE_CACHE_SEGMENT_WIDTH); texcoord_x += 4)
+    {
+      const u16 palette_value = page_row[(page_x + (texcoord_x / 4)) % VRAM_WIDTH];
+      for (u32 i = 0; i < 4; i++)
+        *(dst_ptr++) = palette_row[(palette_x + ((palette_value >> (i * 4)) & 0x0Fu)) % VRAM_WIDTH];
+    }
+  }
+  else
+  {
+    for (u32 texcoord_x = start_x; texcoord_x < (start_x + TEXTURE_PAGE_CACHE_SEGMENT_WIDTH); texcoord_x += 2)
+    {
+      const u16 palette_value = page_row[(page_x + (texcoord_x / 2)) % VRAM_WIDTH];
+      *(dst_ptr++) = palette_row[(palette_x + (palette_value & 0xFFu)) % VRAM_WIDTH];
+      *(dst_ptr++) = palette_row[(palette_x + (palette_value >> 8)) % VRAM_WIDTH];
+    }
+  }
+
+  entry->valid_segments[segment / 64] |= (UINT64_C(1) << (segment % 64));
+  m_texture_page_cache_stats.num_segment_decodes++;
+}
 
 GPU_SW_Backend::DrawLineFunction GPU_SW_Backend::GetDrawLineFunction(bool shading_enable, bool transparency_enable,
                                                                      bool dithering_enable)
@@ -23,6 +23,18 @@ public:
   using DitherLUT = std::array<std::array<std::array<u8, 512>, DITHER_MATRIX_SIZE>, DITHER_MATRIX_SIZE>;
   static constexpr DitherLUT ComputeDitherLUT();
 
+  struct TexturePageCacheStats
+  {
+    u32 num_hits;
+    u32 num_misses;
+    u32 num_bypasses;
+    u32 num_segment_decodes;
+    u32 num_invalidations;
+  };
+
+  ALWAYS_INLINE const TexturePageCacheStats& GetTexturePageCacheStats() const { return m_texture_page_cache_stats; }
+  ALWAYS_INLINE void ResetTexturePageCacheStats() { m_texture_page_cache_stats = {}; }
+
 protected:
   union VRAMPixel
   {
@@ -163,5 +175,58 @@ protected:
                                                     const GPUBackendDrawLineCommand::Vertex* p1);
   DrawLineFunction GetDrawLineFunction(bool shading_enable, bool transparency_enable, bool dithering_enable);
 
+  //////////////////////////////////////////////////////////////////////////
+  // Texture page cache
+  //////////////////////////////////////////////////////////////////////////
+  // Palette texture pages are expanded to 16-bit direct color on demand, so sampling only needs a single read per
+  // texel. Entries are keyed by page, CLUT and mode, and each row is decoded in 16-texel segments on first use.
+  enum : u32
+  {
+    TEXTURE_PAGE_CACHE_SIZE = 32,
+    TEXTURE_PAGE_CACHE_SEGMENT_WIDTH = 16,
+    TEXTURE_PAGE_CACHE_SEGMENTS_PER_ROW = TEXTURE_PAGE_WIDTH / TEXTURE_PAGE_CACHE_SEGMENT_WIDTH,
+    TEXTURE_PAGE_CACHE_SEGMENTS = TEXTURE_PAGE_CACHE_SEGMENTS_PER_ROW * TEXTURE_PAGE_HEIGHT,
+  };
+
+  struct TexturePageCacheEntry
+  {
+    u32 key;
+    u32 last_used;
+    GPUDrawModeReg draw_mode;
+    GPUTexturePaletteReg palette;
+    std::array<u64, TEXTURE_PAGE_CACHE_SEGMENTS / 64> valid_segments;
+    std::array<u16, TEXTURE_PAGE_WIDTH * TEXTURE_PAGE_HEIGHT> texels;
+  };
+
+  static constexpr u32 GetTexturePageCacheKey(GPUDrawModeReg draw_mode, GPUTexturePaletteReg palette)
+  {
+    return (ZeroExtend32(draw_mode.bits & (GPUDrawModeReg::TEXTURE_PAGE_MASK | (3u << 7))) << 16) |
+           ZeroExtend32(palette.bits & GPUTexturePaletteReg::MASK);
+  }
+
+  static bool TexturePageCacheAreaOverlaps(GPUDrawModeReg draw_mode, GPUTexturePaletteReg palette, u32 x, u32 y,
+                                           u32 width, u32 height);
+  void InvalidateTexturePageCache(u32 x, u32 y, u32 width, u32 height);
+  void InvalidateTexturePageCache();
+  void BindTexturePageCacheEntry(const GPUBackendDrawCommand* cmd);
+  void DecodeTexturePageSegment(TexturePageCacheEntry* entry, u32 segment);
+
+  ALWAYS_INLINE_RELEASE u16 GetCachedTexel(u8 texcoord_x, u8 texcoord_y)
+  {
+    TexturePageCacheEntry* entry = m_current_texture_page;
+    const u32 segment = (ZeroExtend32(texcoord_y) * TEXTURE_PAGE_CACHE_SEGMENTS_PER_ROW) +
+                        (ZeroExtend32(texcoord_x) / TEXTURE_PAGE_CACHE_SEGMENT_WIDTH);
+    if (!(entry->valid_segments[segment / 64] & (UINT64_C(1) << (segment % 64))))
+      DecodeTexturePageSegment(entry, segment);
+
+    return entry->texels[ZeroExtend32(texcoord_y) * TEXTURE_PAGE_WIDTH + ZeroExtend32(texcoord_x)];
+  }
+
   std::array<u16, VRAM_WIDTH * VRAM_HEIGHT> m_vram;
+
+  std::array<TexturePageCacheEntry, TEXTURE_PAGE_CACHE_SIZE> m_texture_page_cache;
+  TexturePageCacheEntry* m_current_texture_page = nullptr;
+  u32 m_texture_page_cache_valid_mask = 0;
+  u32 m_texture_page_cache_counter = 0;
+  TexturePageCacheStats m_texture_page_cache_stats = {};
 };
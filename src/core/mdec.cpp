@@ -1,5 +1,6 @@
 #include "mdec.h"
 #include "common/log.h"
+#include "common/platform.h"
 #include "cpu_core.h"
 #include "dma.h"
 #include "host.h"
@@ -9,6 +10,16 @@
 #include "util/state_wrapper.h"
 Log_SetChannel(MDEC);
 
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
 MDEC g_mdec;
 
 MDEC::MDEC() = default;
@@ -416,10 +427,7 @@ bool MDEC::DecodeColoredMacroblock()
   ResetDecoder();
   m_state = State::WritingMacroblock;
 
-  yuv_to_rgb(0, 0, m_blocks[0], m_blocks[1], m_blocks[2]);
-  yuv_to_rgb(8, 0, m_blocks[0], m_blocks[1], m_blocks[3]);
-  yuv_to_rgb(0, 8, m_blocks[0], m_blocks[1], m_blocks[4]);
-  yuv_to_rgb(8, 8, m_blocks[0], m_blocks[1], m_blocks[5]);
+  yuv_to_rgb_macroblock();
   m_total_blocks_decoded += 4;
 
   ScheduleBlockCopyOut(s_ticks_per_block[static_cast<u8>(m_status.data_output_depth)] * 6);
@@ -623,6 +631,126 @@ bool MDEC::rl_decode_block(s16* blk, const u8* qt)
 
 void MDEC::IDCT(s16* blk)
 {
+#if defined(CPU_X64)
+  // Both passes are done a row at a time, with pairs of rows of the scale table interleaved so that each pair of
+  // multiply-adds can be done with pmaddwd. The first pass can't overflow 32 bits, since the coefficients are limited
+  // to 10 bits.
+  __m128i scale_pairs[4][2];
+  __m128i block_pairs[4][2];
+  for (u32 i = 0; i < 4; i++)
+  {
+    const __m128i scale_row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_scale_table[i * 16]));
+    const __m128i scale_row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_scale_table[i * 16 + 8]));
+    scale_pairs[i][0] = _mm_unpacklo_epi16(scale_row0, scale_row1);
+    scale_pairs[i][1] = _mm_unpackhi_epi16(scale_row0, scale_row1);
+
+    const __m128i block_row0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&blk[i * 16]));
+    const __m128i block_row1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&blk[i * 16 + 8]));
+    block_pairs[i][0] = _mm_unpacklo_epi16(block_row0, block_row1);
+    block_pairs[i][1] = _mm_unpackhi_epi16(block_row0, block_row1);
+  }
+
+  alignas(16) std::array<u32, 32> scale_pair_columns;
+  std::memcpy(scale_pair_columns.data(), scale_pairs, sizeof(scale_pair_columns));
+
+  alignas(16) std::array<s16, 64> out;
+  for (u32 y = 0; y < 8; y++)
+  {
+    __m128i temp_lo = _mm_setzero_si128();
+    __m128i temp_hi = _mm_setzero_si128();
+    for (u32 i = 0; i < 4; i++)
+    {
+      const __m128i scale = _mm_set1_epi32(static_cast<s32>(scale_pair_columns[i * 8 + y]));
+      temp_lo = _mm_add_epi32(temp_lo, _mm_madd_epi16(block_pairs[i][0], scale));
+      temp_hi = _mm_add_epi32(temp_hi, _mm_madd_epi16(block_pairs[i][1], scale));
+    }
+
+    // The second pass needs 47 bits, which we don't have. Instead, the row is split into 16, 8 and 8-bit parts, which
+    // are multiplied separately, and the carries are then propagated up into the top part. The result of that is
+    // exactly the top 32 bits of the sum, with the rounding bit added in.
+    const __m128i byte_mask = _mm_set1_epi32(0xFF);
+    const __m128i top = _mm_packs_epi32(_mm_srai_epi32(temp_lo, 16), _mm_srai_epi32(temp_hi, 16));
+    const __m128i middle = _mm_packs_epi32(_mm_and_si128(_mm_srli_epi32(temp_lo, 8), byte_mask),
+                                           _mm_and_si128(_mm_srli_epi32(temp_hi, 8), byte_mask));
+    const __m128i bottom = _mm_packs_epi32(_mm_and_si128(temp_lo, byte_mask), _mm_and_si128(temp_hi, byte_mask));
+
+    __m128i sum_top[2] = {_mm_setzero_si128(), _mm_setzero_si128()};
+    __m128i sum_middle[2] = {_mm_setzero_si128(), _mm_setzero_si128()};
+    __m128i sum_bottom[2] = {_mm_setzero_si128(), _mm_setzero_si128()};
+    const auto accumulate = [&](u32 i, __m128i top_pair, __m128i middle_pair, __m128i bottom_pair) {
+      for (u32 half = 0; half < 2; half++)
+      {
+        sum_top[half] = _mm_add_epi32(sum_top[half], _mm_madd_epi16(top_pair, scale_pairs[i][half]));
+        sum_middle[half] = _mm_add_epi32(sum_middle[half], _mm_madd_epi16(middle_pair, scale_pairs[i][half]));
+        sum_bottom[half] = _mm_add_epi32(sum_bottom[half], _mm_madd_epi16(bottom_pair, scale_pairs[i][half]));
+      }
+    };
+    accumulate(0, _mm_shuffle_epi32(top, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_epi32(middle, _MM_SHUFFLE(0, 0, 0, 0)),
+               _mm_shuffle_epi32(bottom, _MM_SHUFFLE(0, 0, 0, 0)));
+    accumulate(1, _mm_shuffle_epi32(top, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_epi32(middle, _MM_SHUFFLE(1, 1, 1, 1)),
+               _mm_shuffle_epi32(bottom, _MM_SHUFFLE(1, 1, 1, 1)));
+    accumulate(2, _mm_shuffle_epi32(top, _MM_SHUFFLE(2, 2, 2, 2)), _mm_shuffle_epi32(middle, _MM_SHUFFLE(2, 2, 2, 2)),
+               _mm_shuffle_epi32(bottom, _MM_SHUFFLE(2, 2, 2, 2)));
+    accumulate(3, _mm_shuffle_epi32(top, _MM_SHUFFLE(3, 3, 3, 3)), _mm_shuffle_epi32(middle, _MM_SHUFFLE(3, 3, 3, 3)),
+               _mm_shuffle_epi32(bottom, _MM_SHUFFLE(3, 3, 3, 3)));
+
+    __m128i result[2];
+    for (u32 half = 0; half < 2; half++)
+    {
+      const __m128i middle_carry = _mm_add_epi32(sum_middle[half], _mm_srai_epi32(sum_bottom[half], 8));
+      const __m128i top_carry = _mm_add_epi32(sum_top[half], _mm_srai_epi32(middle_carry, 8));
+      const __m128i rounded = _mm_srai_epi32(_mm_add_epi32(top_carry, _mm_set1_epi32(0x8000)), 16);
+      result[half] = _mm_srai_epi32(_mm_slli_epi32(rounded, 23), 23);
+    }
+
+    const __m128i clamped = _mm_min_epi16(_mm_max_epi16(_mm_packs_epi32(result[0], result[1]), _mm_set1_epi16(-128)),
+                                          _mm_set1_epi16(127));
+    _mm_store_si128(reinterpret_cast<__m128i*>(&out[y * 8]), clamped);
+  }
+
+  std::memcpy(blk, out.data(), sizeof(out));
+#elif defined(CPU_AARCH64)
+  // The first pass can't overflow 32 bits, since the coefficients are limited to 10 bits. The second pass is done with
+  // 64-bit multiply-adds, and the rounding narrow is the same as adding bit 31 to the top 32 bits of the sum.
+  alignas(16) std::array<s32, 64> temp_buffer;
+  for (u32 y = 0; y < 8; y++)
+  {
+    int32x4_t temp_lo = vdupq_n_s32(0);
+    int32x4_t temp_hi = vdupq_n_s32(0);
+    for (u32 u = 0; u < 8; u++)
+    {
+      const int16x8_t block_row = vld1q_s16(&blk[u * 8]);
+      temp_lo = vmlal_n_s16(temp_lo, vget_low_s16(block_row), m_scale_table[u * 8 + y]);
+      temp_hi = vmlal_n_s16(temp_hi, vget_high_s16(block_row), m_scale_table[u * 8 + y]);
+    }
+    vst1q_s32(&temp_buffer[y * 8], temp_lo);
+    vst1q_s32(&temp_buffer[y * 8 + 4], temp_hi);
+  }
+
+  for (u32 y = 0; y < 8; y++)
+  {
+    int64x2_t sum[4] = {vdupq_n_s64(0), vdupq_n_s64(0), vdupq_n_s64(0), vdupq_n_s64(0)};
+    for (u32 u = 0; u < 8; u++)
+    {
+      const int16x8_t scale_row = vld1q_s16(&m_scale_table[u * 8]);
+      const int32x4_t scale_lo = vmovl_s16(vget_low_s16(scale_row));
+      const int32x4_t scale_hi = vmovl_s16(vget_high_s16(scale_row));
+      const s32 temp = temp_buffer[u + y * 8];
+      sum[0] = vmlal_n_s32(sum[0], vget_low_s32(scale_lo), temp);
+      sum[1] = vmlal_n_s32(sum[1], vget_high_s32(scale_lo), temp);
+      sum[2] = vmlal_n_s32(sum[2], vget_low_s32(scale_hi), temp);
+      sum[3] = vmlal_n_s32(sum[3], vget_high_s32(scale_hi), temp);
+    }
+
+    int32x4_t result_lo = vcombine_s32(vrshrn_n_s64(sum[0], 32), vrshrn_n_s64(sum[1], 32));
+    int32x4_t result_hi = vcombine_s32(vrshrn_n_s64(sum[2], 32), vrshrn_n_s64(sum[3], 32));
+    result_lo = vshrq_n_s32(vshlq_n_s32(result_lo, 23), 23);
+    result_hi = vshrq_n_s32(vshlq_n_s32(result_hi, 23), 23);
+
+    const int16x8_t result = vcombine_s16(vqmovn_s32(result_lo), vqmovn_s32(result_hi));
+    vst1q_s16(&blk[y * 8], vminq_s16(vmaxq_s16(result, vdupq_n_s16(-128)), vdupq_n_s16(127)));
+  }
+#else
   std::array<s64, 64> temp_buffer;
   for (u32 x = 0; x < 8; x++)
   {
@@ -646,6 +774,22 @@ void MDEC::IDCT(s16* blk)
         static_cast<s16>(std::clamp<s32>(SignExtendN<9, s32>((sum >> 32) + ((sum >> 31) & 1)), -128, 127));
     }
   }
+#endif
+}
+
+// Fixed-point versions of the 1.402, 1.772, -0.3437 and -0.7143 factors. These give exactly the same results as the
+// float calculations they replaced, for every possible input.
+static constexpr s32 YUV_CR_TO_R = 22970;
+static constexpr s32 YUV_CB_TO_B = 29032;
+static constexpr u32 YUV_RB_SHIFT = 14;
+static constexpr s32 YUV_CB_TO_G = 360396;
+static constexpr s32 YUV_CR_TO_G = 748997;
+static constexpr u32 YUV_G_SHIFT = 20;
+
+ALWAYS_INLINE static constexpr s32 YUVDivide(s32 value, u32 shift)
+{
+  // Rounds towards zero, like the float to integer conversion.
+  return (value + static_cast<s32>(static_cast<u32>(value >> 31) >> (32 - shift))) >> shift;
 }
 
 void MDEC::yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
@@ -657,10 +801,10 @@ void MDEC::yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const st
     {
       s16 R = Crblk[((x + xx) / 2) + ((y + yy) / 2) * 8];
       s16 B = Cbblk[((x + xx) / 2) + ((y + yy) / 2) * 8];
-      s16 G = static_cast<s16>((-0.3437f * static_cast<float>(B)) + (-0.7143f * static_cast<float>(R)));
+      s16 G = static_cast<s16>(-YUVDivide((B * YUV_CB_TO_G) + (R * YUV_CR_TO_G), YUV_G_SHIFT));
 
-      R = static_cast<s16>(1.402f * static_cast<float>(R));
-      B = static_cast<s16>(1.772f * static_cast<float>(B));
+      R = static_cast<s16>(YUVDivide(R * YUV_CR_TO_R, YUV_RB_SHIFT));
+      B = static_cast<s16>(YUVDivide(B * YUV_CB_TO_B, YUV_RB_SHIFT));
 
       s16 Y = Yblk[x + y * 8];
       R = static_cast<s16>(std::clamp(static_cast<int>(Y) + R, -128, 127));
@@ -679,6 +823,133 @@ void MDEC::yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const st
   }
 }
 
+void MDEC::yuv_to_rgb_macroblock()
+{
+#if defined(CPU_X64)
+  // Each row of chroma is converted once, then doubled up and applied to two rows of the 16x16 macroblock.
+  // The G factors don't fit in 16 bits, so they are split into two multiplies.
+  const __m128i r_factor = _mm_set_epi16(0, YUV_CR_TO_R, 0, YUV_CR_TO_R, 0, YUV_CR_TO_R, 0, YUV_CR_TO_R);
+  const __m128i b_factor = _mm_set_epi16(YUV_CB_TO_B, 0, YUV_CB_TO_B, 0, YUV_CB_TO_B, 0, YUV_CB_TO_B, 0);
+  const __m128i g_factor_hi = _mm_set1_epi32(((YUV_CB_TO_G >> 8) << 16) | (YUV_CR_TO_G >> 8));
+  const __m128i g_factor_lo = _mm_set1_epi32(((YUV_CB_TO_G & 0xFF) << 16) | (YUV_CR_TO_G & 0xFF));
+  const auto divide = [](__m128i value, int shift) {
+    const __m128i rounding = _mm_srl_epi32(_mm_srai_epi32(value, 31), _mm_cvtsi32_si128(32 - shift));
+    return _mm_sra_epi32(_mm_add_epi32(value, rounding), _mm_cvtsi32_si128(shift));
+  };
+
+  const __m128i sign_flip = _mm_set1_epi8(static_cast<s8>(0x80));
+  const __m128i zero = _mm_setzero_si128();
+  for (u32 cy = 0; cy < 8; cy++)
+  {
+    const __m128i cr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_blocks[0][cy * 8]));
+    const __m128i cb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&m_blocks[1][cy * 8]));
+    const __m128i crcb[2] = {_mm_unpacklo_epi16(cr, cb), _mm_unpackhi_epi16(cr, cb)};
+
+    __m128i r32[2], g32[2], b32[2];
+    for (u32 i = 0; i < 2; i++)
+    {
+      r32[i] = divide(_mm_madd_epi16(crcb[i], r_factor), YUV_RB_SHIFT);
+      b32[i] = divide(_mm_madd_epi16(crcb[i], b_factor), YUV_RB_SHIFT);
+      const __m128i g_sum =
+        _mm_add_epi32(_mm_slli_epi32(_mm_madd_epi16(crcb[i], g_factor_hi), 8), _mm_madd_epi16(crcb[i], g_factor_lo));
+      g32[i] = _mm_sub_epi32(zero, divide(g_sum, YUV_G_SHIFT));
+    }
+
+    const __m128i r = _mm_packs_epi32(r32[0], r32[1]);
+    const __m128i g = _mm_packs_epi32(g32[0], g32[1]);
+    const __m128i b = _mm_packs_epi32(b32[0], b32[1]);
+    const __m128i r_left = _mm_unpacklo_epi16(r, r), r_right = _mm_unpackhi_epi16(r, r);
+    const __m128i g_left = _mm_unpacklo_epi16(g, g), g_right = _mm_unpackhi_epi16(g, g);
+    const __m128i b_left = _mm_unpacklo_epi16(b, b), b_right = _mm_unpackhi_epi16(b, b);
+
+    for (u32 py = cy * 2; py < (cy * 2 + 2); py++)
+    {
+      const std::array<s16, 64>& y_left = m_blocks[(py < 8) ? 2 : 4];
+      const std::array<s16, 64>& y_right = m_blocks[(py < 8) ? 3 : 5];
+      const __m128i yl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&y_left[(py % 8) * 8]));
+      const __m128i yr = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&y_right[(py % 8) * 8]));
+
+      // Saturating to 8 bits is the same as clamping to -128..127, and flipping the sign bit adds 128.
+      const __m128i rp =
+        _mm_xor_si128(_mm_packs_epi16(_mm_add_epi16(yl, r_left), _mm_add_epi16(yr, r_right)), sign_flip);
+      const __m128i gp =
+        _mm_xor_si128(_mm_packs_epi16(_mm_add_epi16(yl, g_left), _mm_add_epi16(yr, g_right)), sign_flip);
+      const __m128i bp =
+        _mm_xor_si128(_mm_packs_epi16(_mm_add_epi16(yl, b_left), _mm_add_epi16(yr, b_right)), sign_flip);
+
+      const __m128i rg_lo = _mm_unpacklo_epi8(rp, gp);
+      const __m128i rg_hi = _mm_unpackhi_epi8(rp, gp);
+      const __m128i b0_lo = _mm_unpacklo_epi8(bp, zero);
+      const __m128i b0_hi = _mm_unpackhi_epi8(bp, zero);
+      __m128i* out = reinterpret_cast<__m128i*>(&m_block_rgb[py * 16]);
+      _mm_storeu_si128(out + 0, _mm_unpacklo_epi16(rg_lo, b0_lo));
+      _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(rg_lo, b0_lo));
+      _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(rg_hi, b0_hi));
+      _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(rg_hi, b0_hi));
+    }
+  }
+#elif defined(CPU_AARCH64)
+  // Each row of chroma is converted once, then doubled up and applied to two rows of the 16x16 macroblock.
+  const auto divide = [](int32x4_t value, int shift) {
+    const int32x4_t rounding =
+      vreinterpretq_s32_u32(vshlq_u32(vreinterpretq_u32_s32(vshrq_n_s32(value, 31)), vdupq_n_s32(shift - 32)));
+    return vshlq_s32(vaddq_s32(value, rounding), vdupq_n_s32(-shift));
+  };
+
+  const uint8x16_t sign_flip = vdupq_n_u8(0x80);
+  for (u32 cy = 0; cy < 8; cy++)
+  {
+    const int16x8_t cr = vld1q_s16(&m_blocks[0][cy * 8]);
+    const int16x8_t cb = vld1q_s16(&m_blocks[1][cy * 8]);
+    const int32x4_t cr32[2] = {vmovl_s16(vget_low_s16(cr)), vmovl_s16(vget_high_s16(cr))};
+    const int32x4_t cb32[2] = {vmovl_s16(vget_low_s16(cb)), vmovl_s16(vget_high_s16(cb))};
+
+    int32x4_t r32[2], g32[2], b32[2];
+    for (u32 i = 0; i < 2; i++)
+    {
+      r32[i] = divide(vmulq_n_s32(cr32[i], YUV_CR_TO_R), YUV_RB_SHIFT);
+      b32[i] = divide(vmulq_n_s32(cb32[i], YUV_CB_TO_B), YUV_RB_SHIFT);
+      g32[i] = vnegq_s32(
+        divide(vmlaq_n_s32(vmulq_n_s32(cb32[i], YUV_CB_TO_G), cr32[i], YUV_CR_TO_G), YUV_G_SHIFT));
+    }
+
+    const int16x8_t r = vcombine_s16(vmovn_s32(r32[0]), vmovn_s32(r32[1]));
+    const int16x8_t g = vcombine_s16(vmovn_s32(g32[0]), vmovn_s32(g32[1]));
+    const int16x8_t b = vcombine_s16(vmovn_s32(b32[0]), vmovn_s32(b32[1]));
+    const int16x8_t r_left = vzip1q_s16(r, r), r_right = vzip2q_s16(r, r);
+    const int16x8_t g_left = vzip1q_s16(g, g), g_right = vzip2q_s16(g, g);
+    const int16x8_t b_left = vzip1q_s16(b, b), b_right = vzip2q_s16(b, b);
+
+    for (u32 py = cy * 2; py < (cy * 2 + 2); py++)
+    {
+      const std::array<s16, 64>& y_left = m_blocks[(py < 8) ? 2 : 4];
+      const std::array<s16, 64>& y_right = m_blocks[(py < 8) ? 3 : 5];
+      const int16x8_t yl = vld1q_s16(&y_left[(py % 8) * 8]);
+      const int16x8_t yr = vld1q_s16(&y_right[(py % 8) * 8]);
+
+      // Saturating to 8 bits is the same as clamping to -128..127, and flipping the sign bit adds 128.
+      uint8x16x4_t pixels;
+      pixels.val[0] = veorq_u8(vreinterpretq_u8_s8(vcombine_s8(vqmovn_s16(vaddq_s16(yl, r_left)),
+                                                                vqmovn_s16(vaddq_s16(yr, r_right)))),
+                               sign_flip);
+      pixels.val[1] = veorq_u8(vreinterpretq_u8_s8(vcombine_s8(vqmovn_s16(vaddq_s16(yl, g_left)),
+                                                                vqmovn_s16(vaddq_s16(yr, g_right)))),
+                               sign_flip);
+      pixels.val[2] = veorq_u8(vreinterpretq_u8_s8(vcombine_s8(vqmovn_s16(vaddq_s16(yl, b_left)),
+                                                                vqmovn_s16(vaddq_s16(yr, b_right)))),
+                               sign_flip);
+      pixels.val[3] = vdupq_n_u8(0);
+      vst4q_u8(reinterpret_cast<u8*>(&m_block_rgb[py * 16]), pixels);
+    }
+  }
+#else
+  yuv_to_rgb(0, 0, m_blocks[0], m_blocks[1], m_blocks[2]);
+  yuv_to_rgb(8, 0, m_blocks[0], m_blocks[1], m_blocks[3]);
+  yuv_to_rgb(0, 8, m_blocks[0], m_blocks[1], m_blocks[4]);
+  yuv_to_rgb(8, 8, m_blocks[0], m_blocks[1], m_blocks[5]);
+#endif
+}
+
 void MDEC::y_to_mono(const std::array<s16, 64>& Yblk)
 {
   for (u32 i = 0; i < 64; i++)
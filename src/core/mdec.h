@@ -119,6 +119,7 @@ private:
   void IDCT(s16* blk);
   void yuv_to_rgb(u32 xx, u32 yy, const std::array<s16, 64>& Crblk, const std::array<s16, 64>& Cbblk,
                   const std::array<s16, 64>& Yblk);
+  void yuv_to_rgb_macroblock();
   void y_to_mono(const std::array<s16, 64>& Yblk);
 
   StatusRegister m_status = {};
@@ -271,6 +271,9 @@ void Settings::Load(SettingsInterface& si)
   cdrom_mute_cd_audio = si.GetBoolValue("CDROM", "MuteCDAudio", false);
   cdrom_read_speedup = si.GetIntValue("CDROM", "ReadSpeedup", 1);
   cdrom_seek_speedup = si.GetIntValue("CDROM", "SeekSpeedup", 1);
+  cdrom_block_cache_size = si.GetUIntValue("CDROM", "BlockCacheSize", DEFAULT_CDROM_BLOCK_CACHE_SIZE);
+  cdrom_prefetch_blocks = si.GetUIntValue("CDROM", "PrefetchBlocks", DEFAULT_CDROM_PREFETCH_BLOCKS);
+  cdrom_sector_cache_size = si.GetUIntValue("CDROM", "SectorCacheSize", DEFAULT_CDROM_SECTOR_CACHE_SIZE);
 
   audio_backend =
     ParseAudioBackend(si.GetStringValue("Audio", "Backend", GetAudioBackendName(DEFAULT_AUDIO_BACKEND)).c_str())
@@ -279,8 +282,13 @@ void Settings::Load(SettingsInterface& si)
   audio_fast_forward_volume = si.GetIntValue("Audio", "FastForwardVolume", 100);
   audio_buffer_size = si.GetIntValue("Audio", "BufferSize", DEFAULT_AUDIO_BUFFER_SIZE);
   audio_resampling = si.GetBoolValue("Audio", "Resampling", true);
+  audio_resampler =
+    ParseAudioResampler(si.GetStringValue("Audio", "Resampler", GetAudioResamplerName(DEFAULT_AUDIO_RESAMPLER)).c_str())
+      .value_or(DEFAULT_AUDIO_RESAMPLER);
+  audio_time_stretch = si.GetBoolValue("Audio", "TimeStretch", false);
   audio_output_muted = si.GetBoolValue("Audio", "OutputMuted", false);
   audio_sync_enabled = si.GetBoolValue("Audio", "Sync", true);
+  audio_use_spu_thread = si.GetBoolValue("Audio", "UseSPUThread", false);
   audio_dump_on_boot = si.GetBoolValue("Audio", "DumpOnBoot", false);
 
   dma_max_slice_ticks = si.GetIntValue("Hacks", "DMAMaxSliceTicks", DEFAULT_DMA_MAX_SLICE_TICKS);
@@ -470,14 +478,20 @@ void Settings::Save(SettingsInterface& si) const
   si.SetBoolValue("CDROM", "MuteCDAudio", cdrom_mute_cd_audio);
   si.SetIntValue("CDROM", "ReadSpeedup", cdrom_read_speedup);
   si.SetIntValue("CDROM", "SeekSpeedup", cdrom_seek_speedup);
+  si.SetUIntValue("CDROM", "BlockCacheSize", cdrom_block_cache_size);
+  si.SetUIntValue("CDROM", "PrefetchBlocks", cdrom_prefetch_blocks);
+  si.SetUIntValue("CDROM", "SectorCacheSize", cdrom_sector_cache_size);
 
   si.SetStringValue("Audio", "Backend", GetAudioBackendName(audio_backend));
   si.SetIntValue("Audio", "OutputVolume", audio_output_volume);
   si.SetIntValue("Audio", "FastForwardVolume", audio_fast_forward_volume);
   si.SetIntValue("Audio", "BufferSize", audio_buffer_size);
   si.SetBoolValue("Audio", "Resampling", audio_resampling);
+  si.SetStringValue("Audio", "Resampler", GetAudioResamplerName(audio_resampler));
+  si.SetBoolValue("Audio", "TimeStretch", audio_time_stretch);
   si.SetBoolValue("Audio", "OutputMuted", audio_output_muted);
   si.SetBoolValue("Audio", "Sync", audio_sync_enabled);
+  si.SetBoolValue("Audio", "UseSPUThread", audio_use_spu_thread);
   si.SetBoolValue("Audio", "DumpOnBoot", audio_dump_on_boot);
 
   si.SetIntValue("Hacks", "DMAMaxSliceTicks", dma_max_slice_ticks);
@@ -1025,6 +1039,37 @@ const char* Settings::GetAudioBackendDisplayName(AudioBackend backend)
   return s_audio_backend_display_names[static_cast<int>(backend)];
 }
 
+static std::array<const char*, static_cast<u32>(AudioResampler::Count)> s_audio_resampler_names = {
+  {"LibSampleRate", "PolyphaseLow", "PolyphaseMedium", "PolyphaseHigh"}};
+static std::array<const char*, static_cast<u32>(AudioResampler::Count)> s_audio_resampler_display_names = {
+  {TRANSLATABLE("AudioResampler", "libsamplerate (Sinc)"), TRANSLATABLE("AudioResampler", "Polyphase (Low Quality)"),
+   TRANSLATABLE("AudioResampler", "Polyphase (Medium Quality)"),
+   TRANSLATABLE("AudioResampler", "Polyphase (High Quality)")}};
+
+std::optional<AudioResampler> Settings::ParseAudioResampler(const char* str)
+{
+  u8 index = 0;
+  for (const char* name : s_audio_resampler_names)
+  {
+    if (StringUtil::Strcasecmp(name, str) == 0)
+      return static_cast<AudioResampler>(index);
+
+    index++;
+  }
+
+  return std::nullopt;
+}
+
+const char* Settings::GetAudioResamplerName(AudioResampler resampler)
+{
+  return s_audio_resampler_names[static_cast<u8>(resampler)];
+}
+
+const char* Settings::GetAudioResamplerDisplayName(AudioResampler resampler)
+{
+  return s_audio_resampler_display_names[static_cast<u8>(resampler)];
+}
+
 static std::array<const char*, 7> s_controller_type_names = {
   {"None", "DigitalController", "AnalogController", "AnalogJoystick", "GunCon", "PlayStationMouse", "NeGcon"}};
 static std::array<const char*, 7> s_controller_display_names = {
@@ -140,14 +140,20 @@ struct Settings
   bool cdrom_mute_cd_audio = false;
   u32 cdrom_read_speedup = 1;
   u32 cdrom_seek_speedup = 1;
+  u32 cdrom_block_cache_size = DEFAULT_CDROM_BLOCK_CACHE_SIZE;
+  u32 cdrom_prefetch_blocks = DEFAULT_CDROM_PREFETCH_BLOCKS;
+  u32 cdrom_sector_cache_size = DEFAULT_CDROM_SECTOR_CACHE_SIZE;
 
   AudioBackend audio_backend = DEFAULT_AUDIO_BACKEND;
   s32 audio_output_volume = 100;
   s32 audio_fast_forward_volume = 100;
   u32 audio_buffer_size = DEFAULT_AUDIO_BUFFER_SIZE;
   bool audio_resampling = true;
+  AudioResampler audio_resampler = DEFAULT_AUDIO_RESAMPLER;
+  bool audio_time_stretch = false;
   bool audio_output_muted = false;
   bool audio_sync_enabled = true;
+  bool audio_use_spu_thread = false;
   bool audio_dump_on_boot = false;
 
   // timing hacks section
@@ -343,6 +349,10 @@ struct Settings
   static const char* GetAudioBackendName(AudioBackend backend);
   static const char* GetAudioBackendDisplayName(AudioBackend backend);
 
+  static std::optional<AudioResampler> ParseAudioResampler(const char* str);
+  static const char* GetAudioResamplerName(AudioResampler resampler);
+  static const char* GetAudioResamplerDisplayName(AudioResampler resampler);
+
   static std::optional<ControllerType> ParseControllerTypeName(const char* str);
   static const char* GetControllerTypeName(ControllerType type);
   static const char* GetControllerTypeDisplayName(ControllerType type);
@@ -385,12 +395,16 @@ struct Settings
 #else
   static constexpr AudioBackend DEFAULT_AUDIO_BACKEND = AudioBackend::Cubeb;
 #endif
+  static constexpr AudioResampler DEFAULT_AUDIO_RESAMPLER = AudioResampler::LibSampleRate;
 
   static constexpr DisplayCropMode DEFAULT_DISPLAY_CROP_MODE = DisplayCropMode::Overscan;
   static constexpr DisplayAspectRatio DEFAULT_DISPLAY_ASPECT_RATIO = DisplayAspectRatio::Auto;
   static constexpr float DEFAULT_OSD_SCALE = 100.0f;
 
   static constexpr u8 DEFAULT_CDROM_READAHEAD_SECTORS = 8;
+  static constexpr u32 DEFAULT_CDROM_BLOCK_CACHE_SIZE = 64;
+  static constexpr u32 DEFAULT_CDROM_PREFETCH_BLOCKS = 4;
+  static constexpr u32 DEFAULT_CDROM_SECTOR_CACHE_SIZE = 8; // MB
 
   static constexpr ControllerType DEFAULT_CONTROLLER_1_TYPE = ControllerType::DigitalController;
   static constexpr ControllerType DEFAULT_CONTROLLER_2_TYPE = ControllerType::None;
@@ -1,7 +1,9 @@
 #include "spu.h"
 #include "cdrom.h"
+#include "common/bitutils.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/platform.h"
 #include "dma.h"
 #include "host.h"
 #include "imgui.h"
@@ -10,10 +12,25 @@
 #include "util/audio_stream.h"
 #include "util/state_wrapper.h"
 #include "util/wav_writer.h"
+#include <cinttypes>
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
 Log_SetChannel(SPU);
 
 SPU g_spu;
 
+// Queued register writes are applied by calling WriteRegister() on the worker thread, which must not queue them again.
+static thread_local bool s_is_worker_thread = false;
+
 SPU::SPU() = default;
 
 SPU::~SPU() = default;
@@ -35,6 +52,9 @@ void SPU::Initialize()
 
   CreateOutputStream();
   Reset();
+
+  if (g_settings.audio_use_spu_thread)
+    StartWorkerThread();
 }
 
 void SPU::CreateOutputStream()
@@ -44,7 +64,11 @@ void SPU::CreateOutputStream()
                  g_settings.audio_buffer_size);
 
   m_audio_stream = Host::CreateAudioStream(g_settings.audio_backend);
+  ConfigureOutputStream();
+}
 
+void SPU::ConfigureOutputStream()
+{
   if (!m_audio_stream ||
       !m_audio_stream->Reconfigure(SAMPLE_RATE, SAMPLE_RATE, NUM_CHANNELS, g_settings.audio_buffer_size))
   {
@@ -54,15 +78,36 @@ void SPU::CreateOutputStream()
     m_audio_stream->Reconfigure(SAMPLE_RATE, SAMPLE_RATE, NUM_CHANNELS, g_settings.audio_buffer_size);
   }
 
+  if (g_settings.audio_resampler == AudioResampler::LibSampleRate)
+  {
+    m_audio_stream->SetResampler(AudioStream::ResamplerType::LibSampleRate, PolyphaseResampler::Quality::Medium);
+  }
+  else
+  {
+    // Polyphase entries are in the same order as the quality levels.
+    m_audio_stream->SetResampler(AudioStream::ResamplerType::Polyphase,
+                                 static_cast<PolyphaseResampler::Quality>(
+                                   static_cast<u8>(g_settings.audio_resampler) -
+                                   static_cast<u8>(AudioResampler::PolyphaseLow)));
+  }
+
   m_audio_stream->SetOutputVolume(System::GetAudioOutputVolume());
 }
 
 void SPU::RecreateOutputStream()
 {
+  FlushWorkerThread();
   m_audio_stream.reset();
   CreateOutputStream();
 }
 
+void SPU::SetOutputStream(std::unique_ptr<AudioStream> stream)
+{
+  FlushWorkerThread();
+  m_audio_stream = std::move(stream);
+  ConfigureOutputStream();
+}
+
 void SPU::CPUClockChanged()
 {
   // (X * D) / N / 768 -> (X * D) / (N * 768)
@@ -72,8 +117,20 @@ void SPU::CPUClockChanged()
   UpdateEventInterval();
 }
 
+void SPU::UpdateSettings()
+{
+  if (m_use_worker_thread == g_settings.audio_use_spu_thread)
+    return;
+
+  if (g_settings.audio_use_spu_thread)
+    StartWorkerThread();
+  else
+    StopWorkerThread();
+}
+
 void SPU::Shutdown()
 {
+  StopWorkerThread();
   m_tick_event.reset();
   m_transfer_event.reset();
   m_dump_writer.reset();
@@ -82,6 +139,7 @@ void SPU::Shutdown()
 
 void SPU::Reset()
 {
+  FlushWorkerThread();
   m_ticks_carry = 0;
 
   m_SPUCNT.bits = 0;
@@ -111,6 +169,7 @@ void SPU::Reset()
   m_reverb_registers = {};
   m_reverb_registers.mBASE = 0;
   m_reverb_base_address = m_reverb_current_address = ZeroExtend32(m_reverb_registers.mBASE) << 2;
+  UpdateReverbAccessOffsets();
   m_reverb_downsample_buffer = {};
   m_reverb_upsample_buffer = {};
   m_reverb_resample_buffer_position = 0;
@@ -135,11 +194,16 @@ void SPU::Reset()
   m_transfer_fifo.Clear();
   m_transfer_event->Deactivate();
   m_ram.fill(0);
+  ClearBlockCache();
+  UpdateRegisterShadow();
   UpdateEventInterval();
 }
 
 bool SPU::DoState(StateWrapper& sw)
 {
+  FlushWorkerThread();
+  UpdateCaptureBufferStatus();
+
   sw.Do(&m_ticks_carry);
   sw.Do(&m_SPUCNT.bits);
   sw.Do(&m_SPUSTAT.bits);
@@ -201,6 +265,9 @@ bool SPU::DoState(StateWrapper& sw)
 
   if (sw.IsReading())
   {
+    ClearBlockCache();
+    UpdateReverbAccessOffsets();
+    UpdateRegisterShadow();
     UpdateEventInterval();
     UpdateTransferEvent();
   }
@@ -210,6 +277,9 @@ bool SPU::DoState(StateWrapper& sw)
 
 u16 SPU::ReadRegister(u32 offset)
 {
+  if (IsUsingWorkerThread() && IsShadowedRegister(offset))
+    return m_register_shadow[offset / 2];
+
   switch (offset)
   {
     case 0x1F801D80 - SPU_BASE:
@@ -225,15 +295,19 @@ u16 SPU::ReadRegister(u32 offset)
       return m_reverb_registers.vROUT;
 
     case 0x1F801D88 - SPU_BASE:
+      SyncWorkerThread();
       return Truncate16(m_key_on_register);
 
     case 0x1F801D8A - SPU_BASE:
+      SyncWorkerThread();
       return Truncate16(m_key_on_register >> 16);
 
     case 0x1F801D8C - SPU_BASE:
+      SyncWorkerThread();
       return Truncate16(m_key_off_register);
 
     case 0x1F801D8E - SPU_BASE:
+      SyncWorkerThread();
       return Truncate16(m_key_off_register >> 16);
 
     case 0x1F801D90 - SPU_BASE:
@@ -255,9 +329,11 @@ u16 SPU::ReadRegister(u32 offset)
       return Truncate16(m_reverb_on_register >> 16);
 
     case 0x1F801D9C - SPU_BASE:
+      SyncWorkerThread();
       return Truncate16(m_endx_register);
 
     case 0x1F801D9E - SPU_BASE:
+      SyncWorkerThread();
       return Truncate16(m_endx_register >> 16);
 
     case 0x1F801DA2 - SPU_BASE:
@@ -285,6 +361,8 @@ u16 SPU::ReadRegister(u32 offset)
 
     case 0x1F801DAE - SPU_BASE:
       GeneratePendingSamples();
+      SyncWorkerThread();
+      UpdateCaptureBufferStatus();
       Log_TracePrintf("SPU status register -> 0x%04X", ZeroExtend32(m_SPUCNT.bits));
       return m_SPUSTAT.bits;
 
@@ -302,10 +380,12 @@ u16 SPU::ReadRegister(u32 offset)
 
     case 0x1F801DB8 - SPU_BASE:
       GeneratePendingSamples();
+      SyncWorkerThread();
       return m_main_volume_left.current_level;
 
     case 0x1F801DBA - SPU_BASE:
       GeneratePendingSamples();
+      SyncWorkerThread();
       return m_main_volume_right.current_level;
 
     default:
@@ -320,6 +400,7 @@ u16 SPU::ReadRegister(u32 offset)
       {
         const u32 voice_index = (offset - (0x1F801E00 - SPU_BASE)) / 4;
         GeneratePendingSamples();
+        SyncWorkerThread();
         if (offset & 0x02)
           return m_voices[voice_index].left_volume.current_level;
         else
@@ -334,6 +415,16 @@ u16 SPU::ReadRegister(u32 offset)
 
 void SPU::WriteRegister(u32 offset, u16 value)
 {
+  if (IsMixerRegister(offset) && !s_is_worker_thread)
+  {
+    m_register_shadow[offset / 2] = value;
+    if (IsUsingWorkerThread())
+    {
+      QueueWorkerRegisterWrite(offset, value);
+      return;
+    }
+  }
+
   switch (offset)
   {
     case 0x1F801D80 - SPU_BASE:
@@ -502,6 +593,9 @@ void SPU::WriteRegister(u32 offset, u16 value)
       Log_DebugPrintf("SPU control register <- 0x%04X", ZeroExtend32(value));
       GeneratePendingSamples();
 
+      // Enabling the IRQ moves mixing to this thread, so frames the worker is holding back have to be mixed first.
+      FlushWorkerThread();
+
       const SPUCNT new_value{value};
       if (new_value.ram_transfer_mode != m_SPUCNT.ram_transfer_mode &&
           new_value.ram_transfer_mode == RAMTransferMode::Stopped)
@@ -607,6 +701,7 @@ void SPU::WriteRegister(u32 offset, u16 value)
         Log_DebugPrintf("SPU reverb register %u <- 0x%04X", reg, value);
         GeneratePendingSamples();
         m_reverb_registers.rev[reg] = value;
+        UpdateReverbAccessOffsets();
         return;
       }
 
@@ -625,8 +720,15 @@ u16 SPU::ReadVoiceRegister(u32 offset)
 
   // ADSR volume needs to be updated when reading. A voice might be off as well, but key on is pending.
   const Voice& voice = m_voices[voice_index];
-  if (reg_index >= 6 && (voice.IsOn() || m_key_on_register & (1u << voice_index)))
-    GeneratePendingSamples();
+  if (reg_index >= 6)
+  {
+    SyncWorkerThread();
+    if (voice.IsOn() || m_key_on_register & (1u << voice_index))
+    {
+      GeneratePendingSamples();
+      SyncWorkerThread();
+    }
+  }
 
   Log_TracePrintf("Read voice %u register %u -> 0x%02X", voice_index, reg_index, voice.regs.index[reg_index]);
   return voice.regs.index[reg_index];
@@ -769,6 +871,7 @@ void SPU::WriteToCaptureBuffer(u32 index, s16 value)
   const u32 ram_address = (index * CAPTURE_BUFFER_SIZE_PER_CHANNEL) | ZeroExtend16(m_capture_buffer_position);
   // Log_DebugPrintf("write to capture buffer %u (0x%08X) <- 0x%04X", index, ram_address, u16(value));
   std::memcpy(&m_ram[ram_address], &value, sizeof(value));
+  InvalidateBlockCache(ram_address);
   if (IsRAMIRQTriggerable() && CheckRAMIRQ(ram_address))
   {
     Log_DebugPrintf("Trigger IRQ @ %08X %04X from capture buffer", ram_address, ram_address / 8);
@@ -780,7 +883,6 @@ void SPU::IncrementCaptureBufferPosition()
 {
   m_capture_buffer_position += sizeof(s16);
   m_capture_buffer_position %= CAPTURE_BUFFER_SIZE_PER_CHANNEL;
-  m_SPUSTAT.second_half_capture_buffer = m_capture_buffer_position >= (CAPTURE_BUFFER_SIZE_PER_CHANNEL / 2);
 }
 
 void ALWAYS_INLINE SPU::ExecuteFIFOReadFromRAM(TickCount& ticks)
@@ -807,6 +909,7 @@ void ALWAYS_INLINE SPU::ExecuteFIFOWriteToRAM(TickCount& ticks)
   {
     u16 value = m_transfer_fifo.Pop();
     std::memcpy(&m_ram[m_transfer_address], &value, sizeof(u16));
+    InvalidateBlockCache(m_transfer_address);
     m_transfer_address = (m_transfer_address + sizeof(u16)) & RAM_MASK;
     ticks -= TRANSFER_TICKS_PER_HALFWORD;
 
@@ -820,6 +923,9 @@ void ALWAYS_INLINE SPU::ExecuteFIFOWriteToRAM(TickCount& ticks)
 
 void SPU::ExecuteTransfer(TickCount ticks)
 {
+  // The worker thread reads the sample data, and writes the capture and reverb buffers.
+  SyncWorkerThread();
+
   const RAMTransferMode mode = m_SPUCNT.ram_transfer_mode;
   Assert(mode != RAMTransferMode::Stopped);
 
@@ -1026,6 +1132,9 @@ void SPU::DMAWrite(const u32* words, u32 word_count)
 
 void SPU::GeneratePendingSamples()
 {
+  if (s_is_worker_thread)
+    return;
+
   if (m_transfer_event->IsActive())
     m_transfer_event->InvokeEarly();
 
@@ -1048,6 +1157,7 @@ void SPU::GeneratePendingSamples()
 
 bool SPU::StartDumpingAudio(const char* filename)
 {
+  FlushWorkerThread();
   m_dump_writer.reset();
   m_dump_writer = std::make_unique<Common::WAVWriter>();
   if (!m_dump_writer->Open(filename, SAMPLE_RATE, 2))
@@ -1086,6 +1196,7 @@ bool SPU::StopDumpingAudio()
   if (!m_dump_writer)
     return false;
 
+  FlushWorkerThread();
   m_dump_writer.reset();
 
 #ifdef SPU_DUMP_ALL_VOICES
@@ -1357,6 +1468,19 @@ void SPU::Voice::DecodeBlock(const ADPCMBlock& block)
   current_block_flags.bits = block.flags.bits;
 }
 
+void SPU::Voice::LoadDecodedBlock(const DecodedBlockCacheEntry& entry)
+{
+  // store samples needed for interpolation
+  current_block_samples[2] = current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + NUM_SAMPLES_PER_ADPCM_BLOCK - 1];
+  current_block_samples[1] = current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + NUM_SAMPLES_PER_ADPCM_BLOCK - 2];
+  current_block_samples[0] = current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK + NUM_SAMPLES_PER_ADPCM_BLOCK - 3];
+
+  std::copy(entry.samples.begin(), entry.samples.end(), &current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK]);
+  adpcm_last_samples[0] = entry.samples[NUM_SAMPLES_PER_ADPCM_BLOCK - 1];
+  adpcm_last_samples[1] = entry.samples[NUM_SAMPLES_PER_ADPCM_BLOCK - 2];
+  current_block_flags.bits = entry.flags;
+}
+
 s32 SPU::Voice::Interpolate() const
 {
   static constexpr std::array<s16, 0x200> gauss = {{
@@ -1463,29 +1587,74 @@ void SPU::ReadADPCMBlock(u16 address, ADPCMBlock* block)
   }
 }
 
-ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
+void SPU::DecodeVoiceBlock(Voice& voice)
 {
-  Voice& voice = m_voices[voice_index];
-  if (!voice.IsOn() && !m_SPUCNT.irq9_enable)
+  const u32 ram_address = (ZeroExtend32(voice.current_address) * 8) & RAM_MASK;
+
+  // Addresses are in 8-byte units, so a block can straddle two cache lines. These are rare, so skip the cache.
+  if ((ram_address % sizeof(ADPCMBlock)) != 0)
+  {
+    ADPCMBlock block;
+    ReadADPCMBlock(voice.current_address, &block);
+    voice.DecodeBlock(block);
+    return;
+  }
+
+  if (IsRAMIRQTriggerable() && (CheckRAMIRQ(ram_address) || CheckRAMIRQ((ram_address + 8) & RAM_MASK)))
+  {
+    Log_DebugPrintf("Trigger IRQ @ %08X %04X from ADPCM reader", ram_address, ram_address / 8);
+    TriggerRAMIRQ();
+  }
+
+  const u32 tag = (ram_address / static_cast<u32>(sizeof(ADPCMBlock))) + 1;
+  auto& set = m_block_cache[(tag - 1) % NUM_BLOCK_CACHE_SETS];
+  for (u32 way = 0; way < NUM_BLOCK_CACHE_WAYS; way++)
   {
-    voice.last_volume = 0;
+    if (set[way].tag != tag || set[way].history != voice.adpcm_last_samples)
+      continue;
 
-#ifdef SPU_DUMP_ALL_VOICES
-    if (m_voice_dump_writers[voice_index])
-    {
-      const s16 dump_samples[2] = {0, 0};
-      m_voice_dump_writers[voice_index]->WriteFrames(dump_samples, 1);
-    }
-#endif
+    if (way != 0)
+      std::swap(set[0], set[way]);
 
-    return {};
+    voice.LoadDecodedBlock(set[0]);
+    m_block_cache_hits++;
+    return;
+  }
+
+  const std::array<s16, 2> history = voice.adpcm_last_samples;
+  ADPCMBlock block;
+  std::memcpy(&block, &m_ram[ram_address], sizeof(block));
+  voice.DecodeBlock(block);
+  m_block_cache_misses++;
+
+  // evict the least recently used entry
+  std::move_backward(set.begin(), set.end() - 1, set.end());
+  DecodedBlockCacheEntry& entry = set[0];
+  entry.tag = tag;
+  entry.history = history;
+  entry.flags = voice.current_block_flags.bits;
+  std::copy_n(&voice.current_block_samples[NUM_SAMPLES_FROM_LAST_ADPCM_BLOCK], NUM_SAMPLES_PER_ADPCM_BLOCK,
+              entry.samples.begin());
+}
+
+void SPU::ClearBlockCache()
+{
+  for (auto& set : m_block_cache)
+  {
+    for (DecodedBlockCacheEntry& entry : set)
+      entry.tag = 0;
   }
 
+  m_block_cache_hits = 0;
+  m_block_cache_misses = 0;
+}
+
+ALWAYS_INLINE_RELEASE std::tuple<s32, s32> SPU::SampleVoice(u32 voice_index)
+{
+  Voice& voice = m_voices[voice_index];
   if (!voice.has_samples)
   {
-    ADPCMBlock block;
-    ReadADPCMBlock(voice.current_address, &block);
-    voice.DecodeBlock(block);
+    DecodeVoiceBlock(voice);
     voice.has_samples = true;
 
     if (voice.current_block_flags.loop_start && !voice.ignore_loop_address)
@@ -1605,32 +1774,84 @@ void SPU::UpdateNoise()
 /* Reverb algorithm from Mednafen-PSX                                   */
 /************************************************************************/
 
+void SPU::UpdateReverbAccessOffsets()
+{
+  const ReverbRegisters& rr = m_reverb_registers;
+  const auto Offset = [](u32 address, s32 offset = 0) { return ((address << 2) + offset) & REVERB_ADDRESS_MASK; };
+  for (u32 lr = 0; lr < 2; lr++)
+  {
+    u32* offsets = &m_reverb_access_offsets[lr * NUM_REVERB_ACCESSES_PER_CHANNEL];
+    offsets[REVERB_IIR_SRC_A] = Offset(rr.IIR_SRC_A[lr ^ 0]);
+    offsets[REVERB_IIR_SRC_B] = Offset(rr.IIR_SRC_B[lr ^ 1]);
+    offsets[REVERB_IIR_DEST_A_PREV] = Offset(rr.IIR_DEST_A[lr], -1);
+    offsets[REVERB_IIR_DEST_B_PREV] = Offset(rr.IIR_DEST_B[lr], -1);
+    offsets[REVERB_IIR_DEST_A] = Offset(rr.IIR_DEST_A[lr]);
+    offsets[REVERB_IIR_DEST_B] = Offset(rr.IIR_DEST_B[lr]);
+    offsets[REVERB_ACC_SRC_A] = Offset(rr.ACC_SRC_A[lr]);
+    offsets[REVERB_ACC_SRC_B] = Offset(rr.ACC_SRC_B[lr]);
+    offsets[REVERB_ACC_SRC_C] = Offset(rr.ACC_SRC_C[lr]);
+    offsets[REVERB_ACC_SRC_D] = Offset(rr.ACC_SRC_D[lr]);
+    offsets[REVERB_FB_SRC_A] = Offset(rr.MIX_DEST_A[lr] - rr.FB_SRC_A);
+    offsets[REVERB_FB_SRC_B] = Offset(rr.MIX_DEST_B[lr] - rr.FB_SRC_B);
+    offsets[REVERB_MIX_DEST_A] = Offset(rr.MIX_DEST_A[lr]);
+    offsets[REVERB_MIX_DEST_B] = Offset(rr.MIX_DEST_B[lr]);
+  }
+}
+
 u32 SPU::ReverbMemoryAddress(u32 address) const
 {
   // Ensures address does not leave the reverb work area.
-  static constexpr u32 MASK = (RAM_SIZE - 1) / 2;
-  u32 offset = m_reverb_current_address + (address & MASK);
+  u32 offset = m_reverb_current_address + (address & REVERB_ADDRESS_MASK);
   offset += m_reverb_base_address & ((s32)(offset << 13) >> 31);
 
   // We address RAM in bytes. TODO: Change this to words.
-  return (offset & MASK) * 2u;
+  return (offset & REVERB_ADDRESS_MASK) * 2u;
 }
 
-s16 SPU::ReverbRead(u32 address, s32 offset)
+void SPU::GetReverbAddresses(u32* addresses) const
 {
-  // TODO: This should check interrupts.
-  const u32 real_address = ReverbMemoryAddress((address << 2) + offset);
+  // Same as ReverbMemoryAddress(), for all of the accesses in a step at once.
+#if defined(CPU_X64)
+  const __m128i current_address = _mm_set1_epi32(static_cast<s32>(m_reverb_current_address));
+  const __m128i base_address = _mm_set1_epi32(static_cast<s32>(m_reverb_base_address));
+  const __m128i mask = _mm_set1_epi32(static_cast<s32>(REVERB_ADDRESS_MASK));
+  for (u32 i = 0; i < NUM_REVERB_ACCESSES; i += 4)
+  {
+    __m128i offset =
+      _mm_add_epi32(current_address, _mm_load_si128(reinterpret_cast<const __m128i*>(&m_reverb_access_offsets[i])));
+    offset = _mm_add_epi32(offset, _mm_and_si128(base_address, _mm_srai_epi32(_mm_slli_epi32(offset, 13), 31)));
+    _mm_store_si128(reinterpret_cast<__m128i*>(&addresses[i]), _mm_slli_epi32(_mm_and_si128(offset, mask), 1));
+  }
+#elif defined(CPU_AARCH64)
+  const uint32x4_t current_address = vdupq_n_u32(m_reverb_current_address);
+  const uint32x4_t base_address = vdupq_n_u32(m_reverb_base_address);
+  const uint32x4_t mask = vdupq_n_u32(REVERB_ADDRESS_MASK);
+  for (u32 i = 0; i < NUM_REVERB_ACCESSES; i += 4)
+  {
+    uint32x4_t offset = vaddq_u32(current_address, vld1q_u32(&m_reverb_access_offsets[i]));
+    const int32x4_t wrapped = vshrq_n_s32(vreinterpretq_s32_u32(vshlq_n_u32(offset, 13)), 31);
+    offset = vaddq_u32(offset, vandq_u32(base_address, vreinterpretq_u32_s32(wrapped)));
+    vst1q_u32(&addresses[i], vshlq_n_u32(vandq_u32(offset, mask), 1));
+  }
+#else
+  for (u32 i = 0; i < NUM_REVERB_ACCESSES; i++)
+    addresses[i] = ReverbMemoryAddress(m_reverb_access_offsets[i]);
+#endif
+}
 
+s16 SPU::ReverbRead(u32 real_address) const
+{
+  // TODO: This should check interrupts.
   s16 data;
   std::memcpy(&data, &m_ram[real_address], sizeof(data));
   return data;
 }
 
-void SPU::ReverbWrite(u32 address, s16 data)
+void SPU::ReverbWrite(u32 real_address, s16 data)
 {
   // TODO: This should check interrupts.
-  const u32 real_address = ReverbMemoryAddress(address << 2);
   std::memcpy(&m_ram[real_address], &data, sizeof(data));
+  InvalidateBlockCache(real_address);
 }
 
 // Zeroes optimized out; middle removed too(it's 16384)
@@ -1640,6 +1861,89 @@ static constexpr std::array<s16, 20> s_reverb_resample_coefficients = {
 static s16 s_last_reverb_input[2];
 static s32 s_last_reverb_output[2];
 
+#if defined(CPU_X64) || defined(CPU_AARCH64)
+
+// The older taps of the filters above with the zeroes and middle put back, so they can be done a vector at a time. The
+// newest samples were only just written to the buffers, so those taps are done individually, as loading them as part
+// of a vector would stall on store forwarding.
+static constexpr u32 NUM_REVERB_DOWNSAMPLE_VECTOR_TAPS = 32;
+static constexpr u32 NUM_REVERB_UPSAMPLE_VECTOR_TAPS = 16;
+alignas(16) static constexpr std::array<s16, NUM_REVERB_DOWNSAMPLE_VECTOR_TAPS> s_reverb_downsample_coefficients =
+  []() {
+    std::array<s16, NUM_REVERB_DOWNSAMPLE_VECTOR_TAPS> ret = {};
+    for (u32 i = 0; i < NUM_REVERB_DOWNSAMPLE_VECTOR_TAPS / 2; i++)
+      ret[i * 2] = s_reverb_resample_coefficients[i];
+    ret[19] = 0x4000;
+    return ret;
+  }();
+alignas(16) static constexpr std::array<s16, NUM_REVERB_UPSAMPLE_VECTOR_TAPS> s_reverb_upsample_coefficients = []() {
+  std::array<s16, NUM_REVERB_UPSAMPLE_VECTOR_TAPS> ret = {};
+  for (u32 i = 0; i < NUM_REVERB_UPSAMPLE_VECTOR_TAPS; i++)
+    ret[i] = s_reverb_resample_coefficients[i];
+  return ret;
+}();
+
+template<u32 N>
+ALWAYS_INLINE static s32 ReverbFilter(const s16* src, const s16* coefficients)
+{
+  // The sum is exact regardless of order, since it can't overflow.
+#if defined(CPU_X64)
+  __m128i acc = _mm_setzero_si128();
+  for (u32 i = 0; i < N; i += 8)
+  {
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(&src[i])),
+                                            _mm_load_si128(reinterpret_cast<const __m128i*>(&coefficients[i]))));
+  }
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+  return _mm_cvtsi128_si32(acc);
+#elif defined(CPU_AARCH64)
+  int32x4_t acc = vdupq_n_s32(0);
+  for (u32 i = 0; i < N; i += 8)
+  {
+    const int16x8_t samples = vld1q_s16(&src[i]);
+    const int16x8_t coeffs = vld1q_s16(&coefficients[i]);
+    acc = vmlal_s16(acc, vget_low_s16(samples), vget_low_s16(coeffs));
+    acc = vmlal_high_s16(acc, samples, coeffs);
+  }
+  return vaddvq_s32(acc);
+#endif
+}
+
+ALWAYS_INLINE static s32 Reverb4422(const s16* src)
+{
+  s32 out = ReverbFilter<NUM_REVERB_DOWNSAMPLE_VECTOR_TAPS>(src, s_reverb_downsample_coefficients.data());
+  for (u32 i = NUM_REVERB_DOWNSAMPLE_VECTOR_TAPS / 2; i < 20; i++)
+    out += s_reverb_resample_coefficients[i] * src[i * 2];
+
+  out >>= 15;
+  return std::clamp<s32>(out, -32768, 32767);
+}
+
+template<bool phase>
+ALWAYS_INLINE static s32 Reverb2244(const s16* src)
+{
+  s32 out;
+  if (phase)
+  {
+    // Middle non-zero
+    out = src[9];
+  }
+  else
+  {
+    out = ReverbFilter<NUM_REVERB_UPSAMPLE_VECTOR_TAPS>(src, s_reverb_upsample_coefficients.data());
+    for (u32 i = NUM_REVERB_UPSAMPLE_VECTOR_TAPS; i < 20; i++)
+      out += s_reverb_resample_coefficients[i] * src[i];
+
+    out >>= 14;
+    out = std::clamp<s32>(out, -32768, 32767);
+  }
+
+  return out;
+}
+
+#else
+
 ALWAYS_INLINE static s32 Reverb4422(const s16* src)
 {
   s32 out = 0; // 32-bits is adequate(it won't overflow)
@@ -1674,6 +1978,8 @@ ALWAYS_INLINE static s32 Reverb2244(const s16* src)
   return out;
 }
 
+#endif
+
 ALWAYS_INLINE static s16 ReverbSat(s32 val)
 {
   return static_cast<s16>(std::clamp<s32>(val, -0x8000, 0x7FFF));
@@ -1716,48 +2022,53 @@ void SPU::ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out
     for (unsigned lr = 0; lr < 2; lr++)
       downsampled[lr] = Reverb4422(&m_reverb_downsample_buffer[lr][(m_reverb_resample_buffer_position - 38) & 0x3F]);
 
+    // Work from a copy of the registers, otherwise they have to be reloaded after every RAM write.
+    const ReverbRegisters rr = m_reverb_registers;
+    const bool master_enable = m_SPUCNT.reverb_master_enable;
+
+    alignas(16) std::array<u32, NUM_REVERB_ACCESSES> addresses;
+    GetReverbAddresses(addresses.data());
+
     for (unsigned lr = 0; lr < 2; lr++)
     {
-      if (m_SPUCNT.reverb_master_enable)
+      const u32* ch_addresses = &addresses[lr * NUM_REVERB_ACCESSES_PER_CHANNEL];
+      if (master_enable)
       {
-        const s16 IIR_INPUT_A =
-          ReverbSat((((ReverbRead(m_reverb_registers.IIR_SRC_A[lr ^ 0]) * m_reverb_registers.IIR_COEF) >> 14) +
-                     ((downsampled[lr] * m_reverb_registers.IN_COEF[lr]) >> 14)) >>
-                    1);
-        const s16 IIR_INPUT_B =
-          ReverbSat((((ReverbRead(m_reverb_registers.IIR_SRC_B[lr ^ 1]) * m_reverb_registers.IIR_COEF) >> 14) +
-                     ((downsampled[lr] * m_reverb_registers.IN_COEF[lr]) >> 14)) >>
-                    1);
+        const s16 IIR_INPUT_A = ReverbSat((((ReverbRead(ch_addresses[REVERB_IIR_SRC_A]) * rr.IIR_COEF) >> 14) +
+                                           ((downsampled[lr] * rr.IN_COEF[lr]) >> 14)) >>
+                                          1);
+        const s16 IIR_INPUT_B = ReverbSat((((ReverbRead(ch_addresses[REVERB_IIR_SRC_B]) * rr.IIR_COEF) >> 14) +
+                                           ((downsampled[lr] * rr.IN_COEF[lr]) >> 14)) >>
+                                          1);
         const s16 IIR_A =
-          ReverbSat((((IIR_INPUT_A * m_reverb_registers.IIR_ALPHA) >> 14) +
-                     (IIASM(m_reverb_registers.IIR_ALPHA, ReverbRead(m_reverb_registers.IIR_DEST_A[lr], -1)) >> 14)) >>
+          ReverbSat((((IIR_INPUT_A * rr.IIR_ALPHA) >> 14) +
+                     (IIASM(rr.IIR_ALPHA, ReverbRead(ch_addresses[REVERB_IIR_DEST_A_PREV])) >> 14)) >>
                     1);
         const s16 IIR_B =
-          ReverbSat((((IIR_INPUT_B * m_reverb_registers.IIR_ALPHA) >> 14) +
-                     (IIASM(m_reverb_registers.IIR_ALPHA, ReverbRead(m_reverb_registers.IIR_DEST_B[lr], -1)) >> 14)) >>
+          ReverbSat((((IIR_INPUT_B * rr.IIR_ALPHA) >> 14) +
+                     (IIASM(rr.IIR_ALPHA, ReverbRead(ch_addresses[REVERB_IIR_DEST_B_PREV])) >> 14)) >>
                     1);
 
-        ReverbWrite(m_reverb_registers.IIR_DEST_A[lr], IIR_A);
-        ReverbWrite(m_reverb_registers.IIR_DEST_B[lr], IIR_B);
+        ReverbWrite(ch_addresses[REVERB_IIR_DEST_A], IIR_A);
+        ReverbWrite(ch_addresses[REVERB_IIR_DEST_B], IIR_B);
       }
 
-      const s32 ACC = ((ReverbRead(m_reverb_registers.ACC_SRC_A[lr]) * m_reverb_registers.ACC_COEF_A) >> 14) +
-                      ((ReverbRead(m_reverb_registers.ACC_SRC_B[lr]) * m_reverb_registers.ACC_COEF_B) >> 14) +
-                      ((ReverbRead(m_reverb_registers.ACC_SRC_C[lr]) * m_reverb_registers.ACC_COEF_C) >> 14) +
-                      ((ReverbRead(m_reverb_registers.ACC_SRC_D[lr]) * m_reverb_registers.ACC_COEF_D) >> 14);
+      const s32 ACC = ((ReverbRead(ch_addresses[REVERB_ACC_SRC_A]) * rr.ACC_COEF_A) >> 14) +
+                      ((ReverbRead(ch_addresses[REVERB_ACC_SRC_B]) * rr.ACC_COEF_B) >> 14) +
+                      ((ReverbRead(ch_addresses[REVERB_ACC_SRC_C]) * rr.ACC_COEF_C) >> 14) +
+                      ((ReverbRead(ch_addresses[REVERB_ACC_SRC_D]) * rr.ACC_COEF_D) >> 14);
 
-      const s16 FB_A = ReverbRead(m_reverb_registers.MIX_DEST_A[lr] - m_reverb_registers.FB_SRC_A);
-      const s16 FB_B = ReverbRead(m_reverb_registers.MIX_DEST_B[lr] - m_reverb_registers.FB_SRC_B);
-      const s16 MDA = ReverbSat((ACC + ((FB_A * ReverbNeg(m_reverb_registers.FB_ALPHA)) >> 14)) >> 1);
-      const s16 MDB = ReverbSat(
-        FB_A +
-        ((((MDA * m_reverb_registers.FB_ALPHA) >> 14) + ((FB_B * ReverbNeg(m_reverb_registers.FB_X)) >> 14)) >> 1));
-      const s16 IVB = ReverbSat(FB_B + ((MDB * m_reverb_registers.FB_X) >> 15));
+      const s16 FB_A = ReverbRead(ch_addresses[REVERB_FB_SRC_A]);
+      const s16 FB_B = ReverbRead(ch_addresses[REVERB_FB_SRC_B]);
+      const s16 MDA = ReverbSat((ACC + ((FB_A * ReverbNeg(rr.FB_ALPHA)) >> 14)) >> 1);
+      const s16 MDB =
+        ReverbSat(FB_A + ((((MDA * rr.FB_ALPHA) >> 14) + ((FB_B * ReverbNeg(rr.FB_X)) >> 14)) >> 1));
+      const s16 IVB = ReverbSat(FB_B + ((MDB * rr.FB_X) >> 15));
 
-      if (m_SPUCNT.reverb_master_enable)
+      if (master_enable)
       {
-        ReverbWrite(m_reverb_registers.MIX_DEST_A[lr], MDA);
-        ReverbWrite(m_reverb_registers.MIX_DEST_B[lr], MDB);
+        ReverbWrite(ch_addresses[REVERB_MIX_DEST_A], MDA);
+        ReverbWrite(ch_addresses[REVERB_MIX_DEST_B], MDB);
       }
 
       m_reverb_upsample_buffer[lr][(m_reverb_resample_buffer_position >> 1) | 0x20] =
@@ -1809,7 +2120,25 @@ void SPU::Execute(TickCount ticks)
     m_ticks_carry = (ticks + m_ticks_carry) % SYSCLK_TICKS_PER_SPU_TICK;
   }
 
-  AudioStream* output_stream = m_audio_output_muted ? m_null_audio_stream.get() : m_audio_stream.get();
+  if (IsUsingWorkerThread())
+  {
+    QueueWorkerFrames(remaining_frames);
+    return;
+  }
+
+  MixFrames(remaining_frames, m_audio_output_muted ? m_null_audio_stream.get() : m_audio_stream.get(), nullptr);
+}
+
+void SPU::MixFrames(u32 remaining_frames, AudioStream* output_stream, const std::tuple<s16, s16>* cd_audio_frames)
+{
+  // Voices which are off are silent, so only the active voices need to be sampled. The exception is when the IRQ is
+  // enabled, since the ADPCM reads of voices which are off can still trigger it.
+  u32 active_voices = 0;
+  for (u32 voice = 0; voice < NUM_VOICES; voice++)
+    active_voices |= (static_cast<u32>(m_voices[voice].IsOn()) << voice);
+
+  // Skipped voices have their last volume cleared, since it's used for pitch modulation and the capture buffers.
+  u32 last_voice_mask = ALL_VOICES_MASK;
 
   while (remaining_frames > 0)
   {
@@ -1826,20 +2155,38 @@ void SPU::Execute(TickCount ticks)
       s32 reverb_in_left = 0;
       s32 reverb_in_right = 0;
 
-      u32 reverb_on_register = m_reverb_on_register;
+      const u32 voice_mask = m_SPUCNT.irq9_enable ? ALL_VOICES_MASK : active_voices;
+      for (u32 bits = last_voice_mask & ~voice_mask; bits != 0; bits &= (bits - 1))
+        m_voices[CountTrailingZeros(bits)].last_volume = 0;
+      last_voice_mask = voice_mask;
 
       for (u32 voice = 0; voice < NUM_VOICES; voice++)
       {
+        const u32 voice_bit = (1u << voice);
+        if (!(voice_mask & voice_bit))
+        {
+#ifdef SPU_DUMP_ALL_VOICES
+          if (m_voice_dump_writers[voice])
+          {
+            const s16 dump_samples[2] = {0, 0};
+            m_voice_dump_writers[voice]->WriteFrames(dump_samples, 1);
+          }
+#endif
+          continue;
+        }
+
         const auto [left, right] = SampleVoice(voice);
+        if (!m_voices[voice].IsOn())
+          active_voices &= ~voice_bit;
+
         left_sum += left;
         right_sum += right;
 
-        if (reverb_on_register & 1u)
+        if (m_reverb_on_register & voice_bit)
         {
           reverb_in_left += left;
           reverb_in_right += right;
         }
-        reverb_on_register >>= 1;
       }
 
       if (!m_SPUCNT.mute_n)
@@ -1851,8 +2198,8 @@ void SPU::Execute(TickCount ticks)
       // Update noise once per frame.
       UpdateNoise();
 
-      // Mix in CD audio.
-      const auto [cd_audio_left, cd_audio_right] = g_cdrom.GetAudioFrame();
+      // Mix in CD audio. The worker thread is passed the frames, since the CD-ROM is emulated on the CPU thread.
+      const auto [cd_audio_left, cd_audio_right] = cd_audio_frames ? *(cd_audio_frames++) : g_cdrom.GetAudioFrame();
       if (m_SPUCNT.cd_audio_enable)
       {
         const s32 cd_audio_volume_left = ApplyVolume(s32(cd_audio_left), m_cd_audio_volume_left);
@@ -1909,6 +2256,7 @@ void SPU::Execute(TickCount ticks)
           {
             m_endx_register &= ~(1u << voice);
             m_voices[voice].KeyOn();
+            active_voices |= (1u << voice);
           }
           key_on_register >>= 1;
         }
@@ -1947,12 +2295,209 @@ void SPU::UpdateEventInterval()
   m_tick_event->Schedule(downcount);
 }
 
+void SPU::StartWorkerThread()
+{
+  m_worker_shutdown = false;
+  m_use_worker_thread = true;
+  m_worker_thread.Start([this]() { WorkerThreadEntryPoint(); });
+  Log_InfoPrint("SPU worker thread started.");
+}
+
+void SPU::StopWorkerThread()
+{
+  if (!m_use_worker_thread)
+    return;
+
+  FlushWorkerThread();
+  {
+    std::unique_lock lock(m_worker_mutex);
+    m_worker_shutdown = true;
+  }
+  m_worker_wake_cv.notify_one();
+  m_worker_thread.Join();
+  m_use_worker_thread = false;
+  Log_InfoPrint("SPU worker thread stopped.");
+}
+
+void SPU::QueueWorkerFrames(u32 num_frames)
+{
+  std::unique_lock lock(m_worker_mutex);
+
+  // Don't let the CPU thread run too far ahead, since audio sync relies on the mixer blocking on the output stream.
+  if (m_worker_queued_frames >= MAX_WORKER_QUEUED_FRAMES)
+    m_worker_done_cv.wait(lock, [this]() { return m_worker_queued_frames < MAX_WORKER_QUEUED_FRAMES; });
+
+  for (u32 i = 0; i < num_frames; i++)
+    m_worker_cd_audio_frames.push_back(g_cdrom.GetAudioFrame());
+
+  WorkerCommand& cmd = m_worker_commands.emplace_back();
+  cmd.type = (m_worker_voice_write_offset >= 0) ? WorkerCommandType::MixFramesIfVoiceActive :
+                                                   WorkerCommandType::MixFrames;
+  cmd.offset = static_cast<u16>(std::max(m_worker_voice_write_offset, 0));
+  cmd.value = 0;
+  cmd.num_frames = num_frames;
+  cmd.output_stream = m_audio_output_muted ? m_null_audio_stream.get() : m_audio_stream.get();
+  m_worker_queued_frames += num_frames;
+
+  lock.unlock();
+  m_worker_wake_cv.notify_one();
+}
+
+void SPU::QueueWorkerRegisterWrite(u32 offset, u16 value)
+{
+  // Voice register writes only generate the pending samples if the voice is on or being keyed on, and only the worker
+  // knows that. So the frames are tagged with the register, and the worker holds them back if the voice is off.
+  m_worker_voice_write_offset = (offset < (0x1F801D80 - SPU_BASE)) ? static_cast<s32>(offset) : -1;
+  GeneratePendingSamples();
+  m_worker_voice_write_offset = -1;
+
+  std::unique_lock lock(m_worker_mutex);
+  WorkerCommand& cmd = m_worker_commands.emplace_back();
+  cmd.type = WorkerCommandType::WriteRegister;
+  cmd.offset = static_cast<u16>(offset);
+  cmd.value = value;
+  cmd.num_frames = 0;
+  cmd.output_stream = nullptr;
+}
+
+void SPU::SyncWorkerThread()
+{
+  if (!m_use_worker_thread)
+    return;
+
+  DebugAssert(!s_is_worker_thread);
+  std::unique_lock lock(m_worker_mutex);
+  if (!m_worker_commands.empty())
+    m_worker_wake_cv.notify_one();
+
+  m_worker_done_cv.wait(lock, [this]() { return m_worker_commands.empty() && !m_worker_busy; });
+}
+
+void SPU::FlushWorkerThread()
+{
+  if (!m_use_worker_thread)
+    return;
+
+  // Frames held back by voice register writes would otherwise be mixed in the next batch, but the CPU thread has
+  // already accounted for them, so they have to be mixed before saving state or switching streams.
+  {
+    std::unique_lock lock(m_worker_mutex);
+    WorkerCommand& cmd = m_worker_commands.emplace_back();
+    cmd.type = WorkerCommandType::Flush;
+    cmd.offset = 0;
+    cmd.value = 0;
+    cmd.num_frames = 0;
+    cmd.output_stream = nullptr;
+  }
+
+  SyncWorkerThread();
+}
+
+void SPU::WorkerThreadEntryPoint()
+{
+  s_is_worker_thread = true;
+
+  std::vector<WorkerCommand> commands;
+  std::vector<std::tuple<s16, s16>> cd_audio_frames;
+  u32 cd_audio_frame_position = 0;
+  u32 deferred_frames = 0;
+  AudioStream* deferred_output_stream = nullptr;
+
+  auto MixDeferredFrames = [&]() {
+    if (deferred_frames == 0)
+      return;
+
+    MixFrames(deferred_frames, deferred_output_stream, &cd_audio_frames[cd_audio_frame_position]);
+    cd_audio_frame_position += deferred_frames;
+    deferred_frames = 0;
+  };
+
+  std::unique_lock lock(m_worker_mutex);
+  for (;;)
+  {
+    m_worker_wake_cv.wait(lock, [this]() { return m_worker_shutdown || !m_worker_commands.empty(); });
+    if (m_worker_commands.empty())
+      break;
+
+    commands.swap(m_worker_commands);
+    cd_audio_frames.insert(cd_audio_frames.end(), m_worker_cd_audio_frames.begin(), m_worker_cd_audio_frames.end());
+    m_worker_cd_audio_frames.clear();
+    m_worker_queued_frames = 0;
+    m_worker_busy = true;
+    lock.unlock();
+    m_worker_done_cv.notify_all();
+
+    for (const WorkerCommand& cmd : commands)
+    {
+      switch (cmd.type)
+      {
+        case WorkerCommandType::MixFrames:
+        case WorkerCommandType::MixFramesIfVoiceActive:
+        {
+          deferred_frames += cmd.num_frames;
+          deferred_output_stream = cmd.output_stream;
+          if (cmd.type == WorkerCommandType::MixFramesIfVoiceActive)
+          {
+            const u32 voice_index = cmd.offset / 0x10;
+            if (!m_voices[voice_index].IsOn() && !(m_key_on_register & (1u << voice_index)))
+              break;
+          }
+
+          MixDeferredFrames();
+        }
+        break;
+
+        case WorkerCommandType::WriteRegister:
+          WriteRegister(cmd.offset, cmd.value);
+          break;
+
+        case WorkerCommandType::Flush:
+          MixDeferredFrames();
+          break;
+      }
+    }
+
+    commands.clear();
+    cd_audio_frames.erase(cd_audio_frames.begin(), cd_audio_frames.begin() + cd_audio_frame_position);
+    cd_audio_frame_position = 0;
+
+    lock.lock();
+    m_worker_busy = false;
+    m_worker_done_cv.notify_all();
+  }
+}
+
+void SPU::UpdateRegisterShadow()
+{
+  for (u32 i = 0; i < NUM_VOICES; i++)
+    std::copy_n(m_voices[i].regs.index, NUM_VOICE_REGISTERS, &m_register_shadow[i * NUM_VOICE_REGISTERS]);
+
+  const auto Shadow = [this](u32 address) -> u16& { return m_register_shadow[(address - SPU_BASE) / 2]; };
+  Shadow(0x1F801D80) = m_main_volume_left_reg.bits;
+  Shadow(0x1F801D82) = m_main_volume_right_reg.bits;
+  Shadow(0x1F801D84) = m_reverb_registers.vLOUT;
+  Shadow(0x1F801D86) = m_reverb_registers.vROUT;
+  Shadow(0x1F801D90) = Truncate16(m_pitch_modulation_enable_register);
+  Shadow(0x1F801D92) = Truncate16(m_pitch_modulation_enable_register >> 16);
+  Shadow(0x1F801D94) = Truncate16(m_noise_mode_register);
+  Shadow(0x1F801D96) = Truncate16(m_noise_mode_register >> 16);
+  Shadow(0x1F801D98) = Truncate16(m_reverb_on_register);
+  Shadow(0x1F801D9A) = Truncate16(m_reverb_on_register >> 16);
+  Shadow(0x1F801DA2) = m_reverb_registers.mBASE;
+  Shadow(0x1F801DB0) = static_cast<u16>(m_cd_audio_volume_left);
+  Shadow(0x1F801DB2) = static_cast<u16>(m_cd_audio_volume_right);
+  std::copy_n(m_reverb_registers.rev, NUM_REVERB_REGS, &Shadow(0x1F801DC0));
+}
+
 void SPU::DrawDebugStateWindow()
 {
   static const ImVec4 active_color{1.0f, 1.0f, 1.0f, 1.0f};
   static const ImVec4 inactive_color{0.4f, 0.4f, 0.4f, 1.0f};
   const float framebuffer_scale = Host::GetOSDScale();
 
+  SyncWorkerThread();
+  UpdateCaptureBufferStatus();
+
   ImGui::SetNextWindowSize(ImVec2(800.0f * framebuffer_scale, 800.0f * framebuffer_scale), ImGuiCond_FirstUseEver);
   if (!ImGui::Begin("SPU State", nullptr))
   {
@@ -2021,6 +2566,14 @@ void SPU::DrawDebugStateWindow()
     ImGui::SameLine(offsets[0]);
     ImGui::TextColored(m_transfer_event->IsActive() ? active_color : inactive_color, "%u halfwords (%u bytes)",
                        m_transfer_fifo.GetSize(), m_transfer_fifo.GetSize() * 2);
+
+    const u64 block_cache_lookups = m_block_cache_hits + m_block_cache_misses;
+    ImGui::Text("Block Cache: ");
+    ImGui::SameLine(offsets[0]);
+    ImGui::Text("%" PRIu64 " hits, %" PRIu64 " misses (%.1f%% hit rate)", m_block_cache_hits, m_block_cache_misses,
+                (block_cache_lookups > 0) ?
+                  (static_cast<double>(m_block_cache_hits) * 100.0 / static_cast<double>(block_cache_lookups)) :
+                  0.0);
   }
 
   // draw voice states
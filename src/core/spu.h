@@ -1,10 +1,15 @@
 #pragma once
 #include "common/bitfield.h"
 #include "common/fifo_queue.h"
+#include "common/threading.h"
 #include "system.h"
 #include "types.h"
 #include <array>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <tuple>
+#include <vector>
 
 // Enable to dump all voices of the SPU audio individually.
 // #define SPU_DUMP_ALL_VOICES 1
@@ -34,6 +39,7 @@ public:
 
   void Initialize();
   void CPUClockChanged();
+  void UpdateSettings();
   void Shutdown();
   void Reset();
   bool DoState(StateWrapper& sw);
@@ -50,6 +56,9 @@ public:
   // Executes the SPU, generating any pending samples.
   void GeneratePendingSamples();
 
+  /// Waits for the worker thread to finish mixing all queued frames, if it is in use.
+  void SyncWorkerThread();
+
   /// Returns true if currently dumping audio.
   ALWAYS_INLINE bool IsDumpingAudio() const { return static_cast<bool>(m_dump_writer); }
 
@@ -61,20 +70,38 @@ public:
 
   /// Access to SPU RAM.
   const std::array<u8, RAM_SIZE>& GetRAM() const { return m_ram; }
-  std::array<u8, RAM_SIZE>& GetRAM() { return m_ram; }
+  std::array<u8, RAM_SIZE>& GetRAM()
+  {
+    // The worker thread writes the capture and reverb buffers.
+    SyncWorkerThread();
+    return m_ram;
+  }
 
   /// Change output stream - used for runahead.
   // TODO: Make it use system "running ahead" flag
   ALWAYS_INLINE bool IsAudioOutputMuted() const { return m_audio_output_muted; }
   void SetAudioOutputMuted(bool muted) { m_audio_output_muted = muted; }
 
-  ALWAYS_INLINE AudioStream* GetOutputStream() const { return m_audio_stream.get(); }
+  /// Waits for the worker thread first, so the stream can be paused or reconfigured without frames in flight.
+  AudioStream* GetOutputStream()
+  {
+    SyncWorkerThread();
+    return m_audio_stream.get();
+  }
+
+  /// Doesn't wait for the worker thread, so it's cheap enough to call every frame. Only for the parts of the stream
+  /// which are safe to use while it's being written: underflow/stretching status and output volume.
+  ALWAYS_INLINE AudioStream* GetOutputStreamUnsynced() const { return m_audio_stream.get(); }
   void RecreateOutputStream();
 
+  /// Replaces the host's output stream, e.g. to capture the audio without a device. The stream is configured here.
+  void SetOutputStream(std::unique_ptr<AudioStream> stream);
+
 private:
   static constexpr u32 SPU_BASE = 0x1F801C00;
   static constexpr u32 NUM_CHANNELS = 2;
   static constexpr u32 NUM_VOICES = 24;
+  static constexpr u32 ALL_VOICES_MASK = (1u << NUM_VOICES) - 1;
   static constexpr u32 NUM_VOICE_REGISTERS = 8;
   static constexpr u32 VOICE_ADDRESS_SHIFT = 3;
   static constexpr u32 NUM_SAMPLES_PER_ADPCM_BLOCK = 28;
@@ -85,8 +112,13 @@ private:
   static constexpr u32 CAPTURE_BUFFER_SIZE_PER_CHANNEL = 0x400;
   static constexpr u32 MINIMUM_TICKS_BETWEEN_KEY_ON_OFF = 2;
   static constexpr u32 NUM_REVERB_REGS = 32;
+  static constexpr u32 REVERB_ADDRESS_MASK = (RAM_SIZE - 1) / 2;
   static constexpr u32 FIFO_SIZE_IN_HALFWORDS = 32;
   static constexpr TickCount TRANSFER_TICKS_PER_HALFWORD = 16;
+  static constexpr u32 NUM_BLOCK_CACHE_SETS = 512;
+  static constexpr u32 NUM_BLOCK_CACHE_WAYS = 2;
+  static constexpr u32 NUM_SHADOW_REGISTERS = (0x1F801E00 - SPU_BASE) / 2;
+  static constexpr u32 MAX_WORKER_QUEUED_FRAMES = 1024;
 
   enum class RAMTransferMode : u8
   {
@@ -230,6 +262,15 @@ private:
     u8 GetNibble(u32 index) const { return (data[index / 2] >> ((index % 2) * 4)) & 0x0F; }
   };
 
+  // Decoded samples depend on the filter history as well as the block contents, so both are part of the key.
+  struct DecodedBlockCacheEntry
+  {
+    u32 tag; // block index + 1, zero if unused
+    std::array<s16, 2> history;
+    u8 flags; // ADPCMFlags bits
+    std::array<s16, NUM_SAMPLES_PER_ADPCM_BLOCK> samples;
+  };
+
   struct VolumeEnvelope
   {
     s32 counter;
@@ -287,6 +328,7 @@ private:
     void ForceOff();
 
     void DecodeBlock(const ADPCMBlock& block);
+    void LoadDecodedBlock(const DecodedBlockCacheEntry& entry);
     s32 Interpolate() const;
 
     // Switches to the specified phase, filling in target.
@@ -333,6 +375,27 @@ private:
     };
   };
 
+  // RAM accesses made by each channel in a reverb step.
+  enum ReverbAccess : u32
+  {
+    REVERB_IIR_SRC_A,
+    REVERB_IIR_SRC_B,
+    REVERB_IIR_DEST_A_PREV,
+    REVERB_IIR_DEST_B_PREV,
+    REVERB_IIR_DEST_A,
+    REVERB_IIR_DEST_B,
+    REVERB_ACC_SRC_A,
+    REVERB_ACC_SRC_B,
+    REVERB_ACC_SRC_C,
+    REVERB_ACC_SRC_D,
+    REVERB_FB_SRC_A,
+    REVERB_FB_SRC_B,
+    REVERB_MIX_DEST_A,
+    REVERB_MIX_DEST_B,
+    NUM_REVERB_ACCESSES_PER_CHANNEL
+  };
+  static constexpr u32 NUM_REVERB_ACCESSES = NUM_REVERB_ACCESSES_PER_CHANNEL * 2;
+
   static constexpr s32 Clamp16(s32 value) { return (value < -0x8000) ? -0x8000 : (value > 0x7FFF) ? 0x7FFF : value; }
 
   static constexpr s32 ApplyVolume(s32 sample, s16 volume) { return (sample * s32(volume)) >> 15; }
@@ -353,6 +416,21 @@ private:
   }
   ALWAYS_INLINE s16 GetVoiceNoiseLevel() const { return static_cast<s16>(static_cast<u16>(m_noise_level)); }
 
+  /// Registers which only affect the mixer. Writes to these can be queued for the worker thread.
+  static constexpr bool IsMixerRegister(u32 offset)
+  {
+    return (offset < (0x1F801D9C - SPU_BASE) || offset == (0x1F801DA2 - SPU_BASE) ||
+            (offset >= (0x1F801DB0 - SPU_BASE) && offset < (0x1F801DB4 - SPU_BASE)) ||
+            (offset >= (0x1F801DC0 - SPU_BASE) && offset < (0x1F801E00 - SPU_BASE)));
+  }
+
+  /// Mixer registers which are never modified by the mixer, so reads can be satisfied from the shadow copy.
+  static constexpr bool IsShadowedRegister(u32 offset)
+  {
+    return (IsMixerRegister(offset) && !(offset < (0x1F801D80 - SPU_BASE) && (offset % 0x10) >= 0x0C) &&
+            !(offset >= (0x1F801D88 - SPU_BASE) && offset < (0x1F801D90 - SPU_BASE)));
+  }
+
   u16 ReadVoiceRegister(u32 offset);
   void WriteVoiceRegister(u32 offset, u16 value);
 
@@ -363,20 +441,48 @@ private:
 
   void WriteToCaptureBuffer(u32 index, s16 value);
   void IncrementCaptureBufferPosition();
+  ALWAYS_INLINE void UpdateCaptureBufferStatus()
+  {
+    m_SPUSTAT.second_half_capture_buffer = m_capture_buffer_position >= (CAPTURE_BUFFER_SIZE_PER_CHANNEL / 2);
+  }
 
   void ReadADPCMBlock(u16 address, ADPCMBlock* block);
+  void DecodeVoiceBlock(Voice& voice);
+
+  void ClearBlockCache();
+  ALWAYS_INLINE void InvalidateBlockCache(u32 ram_address)
+  {
+    const u32 tag = (ram_address / static_cast<u32>(sizeof(ADPCMBlock))) + 1;
+    for (DecodedBlockCacheEntry& entry : m_block_cache[(tag - 1) % NUM_BLOCK_CACHE_SETS])
+    {
+      if (entry.tag == tag)
+        entry.tag = 0;
+    }
+  }
   std::tuple<s32, s32> SampleVoice(u32 voice_index);
 
   void UpdateNoise();
 
+  void UpdateReverbAccessOffsets();
   u32 ReverbMemoryAddress(u32 address) const;
-  s16 ReverbRead(u32 address, s32 offset = 0);
-  void ReverbWrite(u32 address, s16 data);
+  void GetReverbAddresses(u32* addresses) const;
+  s16 ReverbRead(u32 real_address) const;
+  void ReverbWrite(u32 real_address, s16 data);
   void ProcessReverb(s16 left_in, s16 right_in, s32* left_out, s32* right_out);
 
   void Execute(TickCount ticks);
+  void MixFrames(u32 remaining_frames, AudioStream* output_stream, const std::tuple<s16, s16>* cd_audio_frames);
   void UpdateEventInterval();
 
+  ALWAYS_INLINE bool IsUsingWorkerThread() const { return m_use_worker_thread && !m_SPUCNT.irq9_enable; }
+  void StartWorkerThread();
+  void StopWorkerThread();
+  void QueueWorkerFrames(u32 num_frames);
+  void QueueWorkerRegisterWrite(u32 offset, u16 value);
+  void FlushWorkerThread();
+  void WorkerThreadEntryPoint();
+  void UpdateRegisterShadow();
+
   void ExecuteFIFOWriteToRAM(TickCount& ticks);
   void ExecuteFIFOReadFromRAM(TickCount& ticks);
   void ExecuteTransfer(TickCount ticks);
@@ -385,6 +491,7 @@ private:
   void UpdateDMARequest();
 
   void CreateOutputStream();
+  void ConfigureOutputStream();
 
   std::unique_ptr<TimingEvent> m_tick_event;
   std::unique_ptr<TimingEvent> m_transfer_event;
@@ -431,6 +538,9 @@ private:
   u32 m_reverb_base_address = 0;
   u32 m_reverb_current_address = 0;
   ReverbRegisters m_reverb_registers{};
+
+  // Offsets of each reverb access from the current address, computed when the registers are written.
+  alignas(16) std::array<u32, NUM_REVERB_ACCESSES> m_reverb_access_offsets{};
   std::array<std::array<s16, 128>, 2> m_reverb_downsample_buffer;
   std::array<std::array<s16, 64>, 2> m_reverb_upsample_buffer;
   s32 m_reverb_resample_buffer_position = 0;
@@ -441,6 +551,45 @@ private:
 
   std::array<u8, RAM_SIZE> m_ram{};
 
+  // Most recently used entry first.
+  std::array<std::array<DecodedBlockCacheEntry, NUM_BLOCK_CACHE_WAYS>, NUM_BLOCK_CACHE_SETS> m_block_cache{};
+  u64 m_block_cache_hits = 0;
+  u64 m_block_cache_misses = 0;
+
+  // Mixer worker thread. Register writes and frames are queued in order, and CD audio frames are popped when the frames
+  // are queued, so the output is identical to mixing on the CPU thread. Not used when the RAM IRQ is enabled.
+  enum class WorkerCommandType : u8
+  {
+    MixFrames,
+    MixFramesIfVoiceActive,
+    WriteRegister,
+    Flush
+  };
+
+  struct WorkerCommand
+  {
+    WorkerCommandType type;
+    u16 offset;
+    u16 value;
+    u32 num_frames;
+    AudioStream* output_stream;
+  };
+
+  Threading::Thread m_worker_thread;
+  std::mutex m_worker_mutex;
+  std::condition_variable m_worker_wake_cv;
+  std::condition_variable m_worker_done_cv;
+  std::vector<WorkerCommand> m_worker_commands;
+  std::vector<std::tuple<s16, s16>> m_worker_cd_audio_frames;
+  u32 m_worker_queued_frames = 0;
+  s32 m_worker_voice_write_offset = -1;
+  bool m_worker_busy = false;
+  bool m_worker_shutdown = false;
+  bool m_use_worker_thread = false;
+
+  // Last values written by the CPU to the mixer registers.
+  std::array<u16, NUM_SHADOW_REGISTERS> m_register_shadow{};
+
 #ifdef SPU_DUMP_ALL_VOICES
   // +1 for reverb output
   std::array<std::unique_ptr<Common::WAVWriter>, NUM_VOICES + 1> m_voice_dump_writers;
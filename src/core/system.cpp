@@ -166,9 +166,11 @@ static float s_cpu_thread_usage = 0.0f;
 static float s_cpu_thread_time = 0.0f;
 static float s_sw_thread_usage = 0.0f;
 static float s_sw_thread_time = 0.0f;
+static float s_skipped_display_updates = 0.0f;
 static u32 s_last_frame_number = 0;
 static u32 s_last_internal_frame_number = 0;
 static u32 s_last_global_tick_counter = 0;
+static u32 s_last_skipped_display_updates = 0;
 static u64 s_last_cpu_time = 0;
 static u64 s_last_sw_time = 0;
 static Common::Timer s_fps_timer;
@@ -354,6 +356,10 @@ float System::GetSWThreadAverageTime()
 {
   return s_sw_thread_time;
 }
+float System::GetSkippedDisplayUpdatePercentage()
+{
+  return s_skipped_display_updates;
+}
 
 bool System::IsExeFileName(const std::string_view& path)
 {
@@ -372,7 +378,7 @@ bool System::IsLoadableFilename(const std::string_view& path)
                                                 ".exe", ".psexe", ".ps-exe",                            // exes
                                                 ".psf", ".minipsf",                                     // psf
                                                 ".m3u",                                                 // playlists
-                                                ".pbp");
+                                                ".pbp", ".dci");
 
   for (const char* test_extension : extensions)
   {
@@ -453,7 +459,7 @@ std::string System::GetGameHashCodeForImage(CDImage* cdi)
 
   std::string exe_name;
   std::vector<u8> exe_buffer;
-  if (!ReadExecutableFromImage(cdi, &exe_name, &exe_buffer))
+  if (!ReadExecutableFromImage(iso, &exe_name, &exe_buffer))
     return {};
 
   const u32 track_1_length = cdi->GetTrackLength(1);
@@ -759,6 +765,9 @@ bool System::RecreateGPU(GPURenderer renderer, bool force_recreate_display, bool
 std::unique_ptr<CDImage> System::OpenCDImage(const char* path, Common::Error* error, bool force_preload,
                                              bool check_for_patches)
 {
+  CDImage::SetBlockCacheParameters(g_settings.cdrom_block_cache_size, g_settings.cdrom_prefetch_blocks);
+  CDImage::SetSectorCacheBudget(static_cast<u64>(g_settings.cdrom_sector_cache_size) * 1024 * 1024);
+
   std::unique_ptr<CDImage> media = CDImage::Open(path, error);
   if (!media)
     return {};
@@ -1270,6 +1279,7 @@ bool System::Initialize(bool force_software_renderer)
   s_cpu_thread_time = 0.0f;
   s_sw_thread_usage = 0.0f;
   s_sw_thread_time = 0.0f;
+  s_skipped_display_updates = 0.0f;
   s_last_frame_number = 0;
   s_last_internal_frame_number = 0;
   s_last_global_tick_counter = 0;
@@ -2069,8 +2079,10 @@ void System::ResetThrottler()
 
 void System::Throttle()
 {
-  // Reset the throttler on audio buffer overflow, so we don't end up out of phase.
-  if (g_spu.GetOutputStream()->DidUnderflow() && s_target_speed >= 1.0f)
+  // Reset the throttler on audio buffer overflow, so we don't end up out of phase. The time stretcher paces itself
+  // from the buffer level instead, so it doesn't need this.
+  AudioStream* stream = g_spu.GetOutputStreamUnsynced();
+  if (stream->DidUnderflow() && s_target_speed >= 1.0f && !stream->IsStretching())
   {
     Log_VerbosePrintf("Audio buffer underflowed, resetting throttler");
     ResetThrottler();
@@ -2161,6 +2173,15 @@ void System::UpdatePerformanceCounters()
             100.0f;
   s_last_global_tick_counter = global_tick_counter;
 
+  // the counter restarts when the GPU is recreated
+  const u32 skipped_display_updates = g_gpu->GetSkippedDisplayUpdateCount();
+  const u32 skipped_display_updates_delta = (skipped_display_updates >= s_last_skipped_display_updates) ?
+                                              (skipped_display_updates - s_last_skipped_display_updates) :
+                                              skipped_display_updates;
+  s_skipped_display_updates =
+    std::min(static_cast<float>(skipped_display_updates_delta) / frames_presented * 100.0f, 100.0f);
+  s_last_skipped_display_updates = skipped_display_updates;
+
   const Threading::Thread* sw_thread =
     g_gpu->IsHardwareRenderer() ? nullptr : static_cast<GPU_SW*>(g_gpu.get())->GetBackend().GetThread();
   const u64 cpu_time = s_cpu_thread_handle.GetCPUTime();
@@ -2177,8 +2198,8 @@ void System::UpdatePerformanceCounters()
 
   s_fps_timer.ResetTo(now_ticks);
 
-  Log_VerbosePrintf("FPS: %.2f VPS: %.2f CPU: %.2f Average: %.2fms Worst: %.2fms", s_fps, s_vps, s_cpu_thread_usage,
-                    s_average_frame_time, s_worst_frame_time);
+  Log_VerbosePrintf("FPS: %.2f VPS: %.2f CPU: %.2f Average: %.2fms Worst: %.2fms Skipped Display: %.1f%%", s_fps,
+                    s_vps, s_cpu_thread_usage, s_average_frame_time, s_worst_frame_time, s_skipped_display_updates);
 
   Host::OnPerformanceCountersUpdated();
 }
@@ -2188,6 +2209,7 @@ void System::ResetPerformanceCounters()
   s_last_frame_number = s_frame_number;
   s_last_internal_frame_number = s_internal_frame_number;
   s_last_global_tick_counter = TimingEvents::GetGlobalTickCounter();
+  s_last_skipped_display_updates = g_gpu->GetSkippedDisplayUpdateCount();
   s_last_cpu_time = s_cpu_thread_handle.GetCPUTime();
   s_last_sw_time = 0;
   if (g_gpu->IsHardwareRenderer())
@@ -2202,6 +2224,7 @@ void System::ResetPerformanceCounters()
   s_cpu_thread_time = 0.0f;
   s_sw_thread_usage = 0.0f;
   s_sw_thread_time = 0.0f;
+  s_skipped_display_updates = 0.0f;
   s_fps_timer.Reset();
   ResetThrottler();
 }
@@ -2230,6 +2253,7 @@ void System::UpdateSpeedLimiterState()
   }
 
   const bool is_non_standard_speed = (std::abs(target_speed - 1.0f) > 0.05f);
+  const bool time_stretch = (g_settings.audio_time_stretch && target_speed > 0.0f && is_non_standard_speed);
   const bool audio_sync_enabled =
     !IsRunning() || (m_throttler_enabled && g_settings.audio_sync_enabled && !is_non_standard_speed);
   const bool video_sync_enabled =
@@ -2247,13 +2271,14 @@ void System::UpdateSpeedLimiterState()
     UpdateThrottlePeriod();
     ResetThrottler();
 
-    const u32 input_sample_rate = (target_speed == 0.0f || !g_settings.audio_resampling) ?
+    const u32 input_sample_rate = (target_speed == 0.0f || !g_settings.audio_resampling || time_stretch) ?
                                     SPU::SAMPLE_RATE :
                                     static_cast<u32>(static_cast<float>(SPU::SAMPLE_RATE) * target_speed);
-    Log_InfoPrintf("Audio input sample rate: %u hz", input_sample_rate);
+    Log_InfoPrintf("Audio input sample rate: %u hz%s", input_sample_rate, time_stretch ? ", time stretching" : "");
 
     AudioStream* stream = g_spu.GetOutputStream();
     stream->SetInputSampleRate(input_sample_rate);
+    stream->SetStretchTempo(time_stretch ? target_speed : 1.0f);
     stream->SetWaitForBufferFill(true);
 
     if (g_settings.audio_fast_forward_volume != g_settings.audio_output_volume)
@@ -3056,7 +3081,8 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
     }
 
     if (g_settings.audio_backend != old_settings.audio_backend ||
-        g_settings.audio_buffer_size != old_settings.audio_buffer_size)
+        g_settings.audio_buffer_size != old_settings.audio_buffer_size ||
+        g_settings.audio_resampler != old_settings.audio_resampler)
     {
       if (g_settings.audio_backend != old_settings.audio_backend)
       {
@@ -3068,6 +3094,9 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
       g_spu.GetOutputStream()->PauseOutput(IsPaused());
     }
 
+    if (g_settings.audio_use_spu_thread != old_settings.audio_use_spu_thread)
+      g_spu.UpdateSettings();
+
     if (g_settings.emulation_speed != old_settings.emulation_speed)
       UpdateThrottlePeriod();
 
@@ -3095,7 +3124,7 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
         CPU::ClearICache();
     }
 
-    g_spu.GetOutputStream()->SetOutputVolume(GetAudioOutputVolume());
+    g_spu.GetOutputStreamUnsynced()->SetOutputVolume(GetAudioOutputVolume());
 
     if (g_settings.gpu_resolution_scale != old_settings.gpu_resolution_scale ||
         g_settings.gpu_multisamples != old_settings.gpu_multisamples ||
@@ -3199,6 +3228,7 @@ void System::CheckForSettingsChanges(const Settings& old_settings)
         g_settings.display_max_fps != old_settings.display_max_fps ||
         g_settings.display_all_frames != old_settings.display_all_frames ||
         g_settings.audio_resampling != old_settings.audio_resampling ||
+        g_settings.audio_time_stretch != old_settings.audio_time_stretch ||
         g_settings.sync_to_host_refresh_rate != old_settings.sync_to_host_refresh_rate)
     {
       UpdateSpeedLimiterState();
@@ -3628,7 +3658,7 @@ void System::UpdateVolume()
   if (!IsValid())
     return;
 
-  g_spu.GetOutputStream()->SetOutputVolume(GetAudioOutputVolume());
+  g_spu.GetOutputStreamUnsynced()->SetOutputVolume(GetAudioOutputVolume());
 }
 
 bool System::IsDumpingAudio()
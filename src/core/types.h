@@ -120,6 +120,15 @@ enum class AudioBackend : u8
   Count
 };
 
+enum class AudioResampler : u8
+{
+  LibSampleRate,
+  PolyphaseLow,
+  PolyphaseMedium,
+  PolyphaseHigh,
+  Count
+};
+
 enum class ControllerType
 {
   None,
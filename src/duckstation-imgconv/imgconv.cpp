@@ -0,0 +1,252 @@
+#include "common/error.h"
+#include "common/log.h"
+#include "common/progress_callback.h"
+#include "common/string_util.h"
+#include "common/timer.h"
+#include "scmversion/scmversion.h"
+#include "util/cd_image.h"
+#include "util/dci_types.h"
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <string>
+Log_SetChannel(ImageConverter);
+
+static std::string s_input_path;
+static std::string s_output_path;
+static u32 s_sectors_per_frame = DCI::DEFAULT_SECTORS_PER_FRAME;
+static u32 s_disc_index = 0;
+static bool s_use_lzma = true;
+static bool s_verify = false;
+
+static void PrintCommandLineVersion()
+{
+  std::fprintf(stderr, "DuckStation Disc Image Converter Version %s (%s)\n", g_scm_tag_str, g_scm_branch_str);
+  std::fprintf(stderr, "https://github.com/stenzek/duckstation\n");
+  std::fprintf(stderr, "\n");
+}
+
+static void PrintCommandLineHelp(const char* progname)
+{
+  PrintCommandLineVersion();
+  std::fprintf(stderr, "Usage: %s [parameters] <input image> <output .dci>\n", progname);
+  std::fprintf(stderr, "\n");
+  std::fprintf(stderr, "  -help: Displays this information and exits.\n");
+  std::fprintf(stderr, "  -version: Displays version information and exits.\n");
+  std::fprintf(stderr, "  -codec <lzma|deflate>: Compression for each frame. LZMA is smaller, deflate decompresses\n");
+  std::fprintf(stderr, "    faster. Defaults to lzma.\n");
+  std::fprintf(stderr, "  -frame-sectors <count>: Sectors per compressed frame, between 1 and %u. Defaults to %u.\n",
+               static_cast<u32>(DCI::MAX_SECTORS_PER_FRAME), static_cast<u32>(DCI::DEFAULT_SECTORS_PER_FRAME));
+  std::fprintf(stderr, "  -disc <number>: Disc to convert from multi-disc images, starting at 1.\n");
+  std::fprintf(stderr, "  -verify: Reads back the converted image, and compares it against the input.\n");
+  std::fprintf(stderr, "  -verbose: Enables verbose logging.\n");
+  std::fprintf(stderr, "\n");
+}
+
+static bool ParseCommandLineArgs(int argc, char* argv[])
+{
+  for (int i = 1; i < argc; i++)
+  {
+#define CHECK_ARG(str) !std::strcmp(argv[i], str)
+#define CHECK_ARG_PARAM(str) (!std::strcmp(argv[i], str) && ((i + 1) < argc))
+
+    if (CHECK_ARG("-help"))
+    {
+      PrintCommandLineHelp(argv[0]);
+      return false;
+    }
+    else if (CHECK_ARG("-version"))
+    {
+      PrintCommandLineVersion();
+      return false;
+    }
+    else if (CHECK_ARG_PARAM("-codec"))
+    {
+      const char* codec = argv[++i];
+      if (StringUtil::Strcasecmp(codec, "lzma") == 0)
+      {
+        s_use_lzma = true;
+      }
+      else if (StringUtil::Strcasecmp(codec, "deflate") == 0)
+      {
+        s_use_lzma = false;
+      }
+      else
+      {
+        Log_ErrorPrintf("Invalid codec: %s", codec);
+        return false;
+      }
+      continue;
+    }
+    else if (CHECK_ARG_PARAM("-frame-sectors"))
+    {
+      s_sectors_per_frame = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+      if (s_sectors_per_frame == 0 || s_sectors_per_frame > DCI::MAX_SECTORS_PER_FRAME)
+      {
+        Log_ErrorPrintf("Invalid frame size: %s", argv[i]);
+        return false;
+      }
+      continue;
+    }
+    else if (CHECK_ARG_PARAM("-disc"))
+    {
+      s_disc_index = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+      if (s_disc_index == 0)
+      {
+        Log_ErrorPrintf("Invalid disc number: %s", argv[i]);
+        return false;
+      }
+      s_disc_index--;
+      continue;
+    }
+    else if (CHECK_ARG("-verify"))
+    {
+      s_verify = true;
+      continue;
+    }
+    else if (CHECK_ARG("-verbose"))
+    {
+      Log::SetConsoleOutputParams(true, nullptr, LOGLEVEL_VERBOSE);
+      continue;
+    }
+    else if (argv[i][0] == '-')
+    {
+      Log_ErrorPrintf("Unknown parameter: '%s'", argv[i]);
+      return false;
+    }
+
+#undef CHECK_ARG
+#undef CHECK_ARG_PARAM
+
+    if (s_input_path.empty())
+    {
+      s_input_path = argv[i];
+    }
+    else if (s_output_path.empty())
+    {
+      s_output_path = argv[i];
+    }
+    else
+    {
+      Log_ErrorPrintf("Unexpected parameter: '%s'", argv[i]);
+      return false;
+    }
+  }
+
+  if (s_input_path.empty() || s_output_path.empty())
+  {
+    PrintCommandLineHelp(argv[0]);
+    return false;
+  }
+
+  return true;
+}
+
+static bool VerifyImage(CDImage* input_image, CDImage* output_image, ProgressCallback* progress)
+{
+  if (input_image->GetLBACount() != output_image->GetLBACount() ||
+      input_image->GetTrackCount() != output_image->GetTrackCount() ||
+      input_image->GetIndexCount() != output_image->GetIndexCount())
+  {
+    Log_ErrorPrintf("TOC does not match");
+    return false;
+  }
+
+  progress->SetStatusText("Verifying...");
+  progress->SetProgressRange(input_image->GetIndexCount());
+  progress->SetProgressValue(0);
+
+  std::array<u8, CDImage::RAW_SECTOR_SIZE> input_sector, output_sector;
+  for (u32 i = 0; i < input_image->GetIndexCount(); i++)
+  {
+    const CDImage::Index& input_index = input_image->GetIndex(i);
+    const CDImage::Index& output_index = output_image->GetIndex(i);
+    if (input_index.start_lba_on_disc != output_index.start_lba_on_disc || input_index.length != output_index.length ||
+        (input_index.file_sector_size > 0) != (output_index.file_sector_size > 0))
+    {
+      Log_ErrorPrintf("Index %u does not match", i);
+      return false;
+    }
+
+    for (u32 lba = 0; lba < input_index.length; lba++)
+    {
+      CDImage::SubChannelQ input_subq, output_subq;
+      if (!input_image->ReadSubChannelQ(&input_subq, input_index, lba) ||
+          !output_image->ReadSubChannelQ(&output_subq, output_index, lba) || input_subq.data != output_subq.data)
+      {
+        Log_ErrorPrintf("Sub-channel Q of LBA %u does not match", input_index.start_lba_on_disc + lba);
+        return false;
+      }
+
+      if (input_index.file_sector_size == 0)
+        continue;
+
+      if (!input_image->ReadSectorFromIndex(input_sector.data(), input_index, lba) ||
+          !output_image->ReadSectorFromIndex(output_sector.data(), output_index, lba) ||
+          input_sector != output_sector)
+      {
+        Log_ErrorPrintf("Sector at LBA %u does not match", input_index.start_lba_on_disc + lba);
+        return false;
+      }
+    }
+
+    progress->SetProgressValue(i + 1);
+  }
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  Log::SetConsoleOutputParams(true, nullptr, LOGLEVEL_INFO);
+
+  if (!ParseCommandLineArgs(argc, argv))
+    return -1;
+
+  Common::Error error;
+  std::unique_ptr<CDImage> input_image = CDImage::Open(s_input_path.c_str(), &error);
+  if (!input_image)
+  {
+    Log_ErrorPrintf("Failed to open '%s': %s", s_input_path.c_str(), error.GetCodeAndMessage().GetCharArray());
+    return -1;
+  }
+
+  input_image->SetSectorCacheEnabled(false);
+
+  if (s_disc_index > 0 && !input_image->SwitchSubImage(s_disc_index, &error))
+  {
+    Log_ErrorPrintf("Failed to switch to disc %u: %s", s_disc_index + 1, error.GetCodeAndMessage().GetCharArray());
+    return -1;
+  }
+
+  ConsoleProgressCallback progress;
+  Common::Timer timer;
+  if (!CDImage::WriteDCIImage(input_image.get(), s_output_path.c_str(), s_sectors_per_frame, s_use_lzma, &progress,
+                              &error))
+  {
+    Log_ErrorPrintf("Failed to write '%s': %s", s_output_path.c_str(), error.GetCodeAndMessage().GetCharArray());
+    return -1;
+  }
+
+  Log_InfoPrintf("Converted '%s' in %.2f seconds", s_input_path.c_str(), timer.GetTimeSeconds());
+
+  if (s_verify)
+  {
+    std::unique_ptr<CDImage> output_image = CDImage::Open(s_output_path.c_str(), &error);
+    if (!output_image)
+    {
+      Log_ErrorPrintf("Failed to open '%s': %s", s_output_path.c_str(), error.GetCodeAndMessage().GetCharArray());
+      return -1;
+    }
+
+    output_image->SetSectorCacheEnabled(false);
+
+    if (!VerifyImage(input_image.get(), output_image.get(), &progress))
+      return -1;
+
+    Log_InfoPrintf("Verified '%s'", s_output_path.c_str());
+  }
+
+  return 0;
+}
@@ -0,0 +1,167 @@
+#include "null_host_display.h"
+#include "common/align.h"
+
+NullHostDisplay::NullHostDisplay() = default;
+
+NullHostDisplay::~NullHostDisplay() = default;
+
+HostDisplay::RenderAPI NullHostDisplay::GetRenderAPI() const
+{
+  return RenderAPI::None;
+}
+
+void* NullHostDisplay::GetRenderDevice() const
+{
+  return nullptr;
+}
+
+void* NullHostDisplay::GetRenderContext() const
+{
+  return nullptr;
+}
+
+bool NullHostDisplay::HasRenderDevice() const
+{
+  return true;
+}
+
+bool NullHostDisplay::HasRenderSurface() const
+{
+  return true;
+}
+
+bool NullHostDisplay::CreateRenderDevice(const WindowInfo& wi, std::string_view adapter_name, bool debug_device,
+                                         bool threaded_presentation)
+{
+  m_window_info = wi;
+  return true;
+}
+
+bool NullHostDisplay::InitializeRenderDevice(std::string_view shader_cache_directory, bool debug_device,
+                                             bool threaded_presentation)
+{
+  return true;
+}
+
+bool NullHostDisplay::MakeRenderContextCurrent()
+{
+  return true;
+}
+
+bool NullHostDisplay::DoneRenderContextCurrent()
+{
+  return true;
+}
+
+void NullHostDisplay::DestroyRenderDevice()
+{
+  ClearSoftwareCursor();
+}
+
+void NullHostDisplay::DestroyRenderSurface() {}
+
+bool NullHostDisplay::CreateResources()
+{
+  return true;
+}
+
+void NullHostDisplay::DestroyResources() {}
+
+HostDisplay::AdapterAndModeList NullHostDisplay::GetAdapterAndModeList()
+{
+  return {};
+}
+
+bool NullHostDisplay::CreateImGuiContext()
+{
+  return true;
+}
+
+void NullHostDisplay::DestroyImGuiContext() {}
+
+bool NullHostDisplay::UpdateImGuiFontTexture()
+{
+  return true;
+}
+
+bool NullHostDisplay::ChangeRenderWindow(const WindowInfo& wi)
+{
+  m_window_info = wi;
+  return true;
+}
+
+void NullHostDisplay::ResizeRenderWindow(s32 new_window_width, s32 new_window_height)
+{
+  m_window_info.surface_width = new_window_width;
+  m_window_info.surface_height = new_window_height;
+}
+
+bool NullHostDisplay::SupportsFullscreen() const
+{
+  return false;
+}
+
+bool NullHostDisplay::IsFullscreen()
+{
+  return false;
+}
+
+bool NullHostDisplay::SetFullscreen(bool fullscreen, u32 width, u32 height, float refresh_rate)
+{
+  return false;
+}
+
+bool NullHostDisplay::SetPostProcessingChain(const std::string_view& config)
+{
+  return false;
+}
+
+std::unique_ptr<HostDisplayTexture> NullHostDisplay::CreateTexture(u32 width, u32 height, u32 layers, u32 levels,
+                                                                   u32 samples, HostDisplayPixelFormat format,
+                                                                   const void* data, u32 data_stride,
+                                                                   bool dynamic /* = false */)
+{
+  return nullptr;
+}
+
+void NullHostDisplay::UpdateTexture(HostDisplayTexture* texture, u32 x, u32 y, u32 width, u32 height,
+                                    const void* data, u32 data_stride)
+{
+}
+
+bool NullHostDisplay::DownloadTexture(const void* texture_handle, HostDisplayPixelFormat texture_format, u32 x, u32 y,
+                                      u32 width, u32 height, void* out_data, u32 out_data_stride)
+{
+  return false;
+}
+
+bool NullHostDisplay::SupportsDisplayPixelFormat(HostDisplayPixelFormat format) const
+{
+  return (format == HostDisplayPixelFormat::RGBA8);
+}
+
+bool NullHostDisplay::BeginSetDisplayPixels(HostDisplayPixelFormat format, u32 width, u32 height, void** out_buffer,
+                                            u32* out_pitch)
+{
+  const u32 pitch = Common::AlignUpPow2(width * GetDisplayPixelFormatSize(format), 4);
+  m_frame_buffer.resize((height * pitch) / 4);
+  SetDisplayTexture(m_frame_buffer.data(), format, width, height, 0, 0, width, height);
+  *out_buffer = m_frame_buffer.data();
+  *out_pitch = pitch;
+  return true;
+}
+
+void NullHostDisplay::EndSetDisplayPixels() {}
+
+void NullHostDisplay::SetVSync(bool enabled) {}
+
+bool NullHostDisplay::Render()
+{
+  return true;
+}
+
+bool NullHostDisplay::RenderScreenshot(u32 width, u32 height, std::vector<u32>* out_pixels, u32* out_stride,
+                                       HostDisplayPixelFormat* out_format)
+{
+  return false;
+}
@@ -0,0 +1,749 @@
+#include "common/assert.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/memory_settings_interface.h"
+#include "common/path.h"
+#include "common/string_util.h"
+#include "common/timer.h"
+#include "core/host.h"
+#include "core/host_display.h"
+#include "core/host_settings.h"
+#include "core/psf_loader.h"
+#include "core/settings.h"
+#include "core/spu.h"
+#include "core/system.h"
+#include "frontend-common/achievements.h"
+#include "frontend-common/game_list.h"
+#include "frontend-common/input_manager.h"
+#include "null_host_display.h"
+#include "scmversion/scmversion.h"
+#include "util/audio_stream.h"
+#include "util/wav_writer.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include "common/windows_headers.h"
+#else
+#include <cerrno>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+extern char** environ;
+#endif
+Log_SetChannel(PSFRender);
+
+namespace {
+// Receives the SPU output directly, and writes it to the WAV file as soon as it's produced. Nothing reads the stream
+// from another thread, so the ring never fills and the emulator runs as fast as it can.
+class WAVOutputStream final : public AudioStream
+{
+public:
+  WAVOutputStream();
+  ~WAVOutputStream() override;
+
+  ALWAYS_INLINE bool IsFinished() const { return m_finished; }
+  ALWAYS_INLINE u32 GetFramesWritten() const { return m_frames_written; }
+
+  bool StartFile(const char* path, u32 length_frames, u32 fade_frames, bool trim_leading_silence);
+  bool FinishFile();
+
+protected:
+  bool OpenDevice() override;
+  void PauseDevice(bool paused) override;
+  void CloseDevice() override;
+  void FramesAvailable() override;
+
+private:
+  void WriteSamples(SampleType* samples, u32 num_frames);
+
+  Common::WAVWriter m_writer;
+  std::vector<SampleType> m_read_buffer;
+  u32 m_length_frames = 0;
+  u32 m_fade_frames = 0;
+  u32 m_frames_written = 0;
+  u32 m_silent_frames = 0;
+  bool m_waiting_for_audio = false;
+  bool m_finished = true;
+};
+} // namespace
+
+// BIOS startup is silent, so the track is considered to start with the first non-zero sample. Give up on files which
+// don't make any sound for this long.
+static constexpr u32 MAX_LEADING_SILENCE_SECONDS = 30;
+
+static constexpr u32 SAMPLE_RATE = 44100;
+
+static std::vector<std::string> s_input_files;
+static std::string s_output_directory;
+static std::string s_bios_directory;
+static float s_default_length = 180.0f;
+static float s_default_fade = 10.0f;
+static bool s_trim_leading_silence = true;
+static u32 s_num_jobs = 1;
+
+// Options which are passed through when rendering files in child processes.
+static std::vector<std::string> s_child_args;
+
+static MemorySettingsInterface s_base_settings_interface;
+
+WAVOutputStream::WAVOutputStream() = default;
+
+WAVOutputStream::~WAVOutputStream()
+{
+  FinishFile();
+}
+
+bool WAVOutputStream::StartFile(const char* path, u32 length_frames, u32 fade_frames, bool trim_leading_silence)
+{
+  if (!m_writer.Open(path, SAMPLE_RATE, m_channels))
+    return false;
+
+  m_length_frames = length_frames;
+  m_fade_frames = fade_frames;
+  m_frames_written = 0;
+  m_silent_frames = 0;
+  m_waiting_for_audio = trim_leading_silence;
+  m_finished = false;
+  return true;
+}
+
+bool WAVOutputStream::FinishFile()
+{
+  if (!m_writer.IsOpen())
+    return false;
+
+  m_writer.Close();
+  m_finished = true;
+  return (m_frames_written > 0);
+}
+
+bool WAVOutputStream::OpenDevice()
+{
+  m_read_buffer.resize(MaxSamples);
+  return true;
+}
+
+void WAVOutputStream::PauseDevice(bool paused) {}
+
+void WAVOutputStream::CloseDevice() {}
+
+void WAVOutputStream::FramesAvailable()
+{
+  HandleDiscardRequest();
+
+  u32 num_samples;
+  while ((num_samples = PopSamples(m_read_buffer.data(), static_cast<u32>(m_read_buffer.size()))) > 0)
+  {
+    if (!m_finished)
+      WriteSamples(m_read_buffer.data(), num_samples / m_channels);
+  }
+}
+
+void WAVOutputStream::WriteSamples(SampleType* samples, u32 num_frames)
+{
+  if (m_waiting_for_audio)
+  {
+    u32 skip = 0;
+    while (skip < num_frames && samples[skip * 2] == 0 && samples[skip * 2 + 1] == 0)
+      skip++;
+
+    m_silent_frames += skip;
+    if (skip == num_frames)
+    {
+      if (m_silent_frames >= (MAX_LEADING_SILENCE_SECONDS * SAMPLE_RATE))
+      {
+        Log_WarningPrintf("No audio after %u seconds, giving up.", MAX_LEADING_SILENCE_SECONDS);
+        m_finished = true;
+      }
+
+      return;
+    }
+
+    samples += skip * 2;
+    num_frames -= skip;
+    m_waiting_for_audio = false;
+  }
+
+  const u32 total_frames = m_length_frames + m_fade_frames;
+  num_frames = std::min(num_frames, total_frames - m_frames_written);
+
+  // Linear fade out after the track's length.
+  if ((m_frames_written + num_frames) > m_length_frames)
+  {
+    const u32 fade_start = (m_frames_written < m_length_frames) ? (m_length_frames - m_frames_written) : 0;
+    for (u32 i = fade_start; i < num_frames; i++)
+    {
+      const s32 remaining = static_cast<s32>(total_frames - (m_frames_written + i));
+      const s32 fade = static_cast<s32>(m_fade_frames);
+      samples[i * 2] = static_cast<SampleType>((static_cast<s32>(samples[i * 2]) * remaining) / fade);
+      samples[i * 2 + 1] = static_cast<SampleType>((static_cast<s32>(samples[i * 2 + 1]) * remaining) / fade);
+    }
+  }
+
+  m_writer.WriteFrames(samples, num_frames);
+  m_frames_written += num_frames;
+  if (m_frames_written == total_frames)
+    m_finished = true;
+}
+
+static void PrintCommandLineVersion()
+{
+  std::fprintf(stderr, "DuckStation PSF Renderer Version %s (%s)\n", g_scm_tag_str, g_scm_branch_str);
+  std::fprintf(stderr, "https://github.com/stenzek/duckstation\n");
+  std::fprintf(stderr, "\n");
+}
+
+static void PrintCommandLineHelp(const char* progname)
+{
+  PrintCommandLineVersion();
+  std::fprintf(stderr, "Usage: %s [parameters] [--] <files or directories...>\n", progname);
+  std::fprintf(stderr, "\n");
+  std::fprintf(stderr, "  -help: Displays this information and exits.\n");
+  std::fprintf(stderr, "  -version: Displays version information and exits.\n");
+  std::fprintf(stderr, "  -output <dir>: Directory to write WAV files to. Defaults to next to each input file.\n");
+  std::fprintf(stderr, "  -bios <dir>: Directory to search for BIOS images in.\n");
+  std::fprintf(stderr, "  -length <time>: Length of files without a length tag, e.g. 2:30. Defaults to 3:00.\n");
+  std::fprintf(stderr, "  -fade <time>: Fade of files without a fade tag. Defaults to 10 seconds.\n");
+  std::fprintf(stderr, "  -keep-silence: Don't skip the silence before the track starts playing.\n");
+  std::fprintf(stderr, "  -jobs <count>: Number of files to render at once. Defaults to 1.\n");
+  std::fprintf(stderr, "  -verbose: Enables verbose logging.\n");
+  std::fprintf(stderr, "  --: Signals that no more arguments will follow and the remaining\n"
+                       "    parameters are files. Use when a filename starts with a dash.\n");
+  std::fprintf(stderr, "\n");
+}
+
+/// Parses PSF tag times, which are in the form [[hh:]mm:]ss[.fff].
+static std::optional<float> ParseTime(const std::string_view& str)
+{
+  if (str.empty())
+    return std::nullopt;
+
+  float seconds = 0.0f;
+  for (const std::string_view& part : StringUtil::SplitString(str, ':', false))
+  {
+    std::string trimmed(StringUtil::StripWhitespace(part));
+    std::replace(trimmed.begin(), trimmed.end(), ',', '.');
+    const std::optional<float> value = StringUtil::FromChars<float>(trimmed);
+    if (!value.has_value() || value.value() < 0.0f)
+      return std::nullopt;
+
+    seconds = (seconds * 60.0f) + value.value();
+  }
+
+  return seconds;
+}
+
+static void AddInputPath(const char* path)
+{
+  if (!FileSystem::DirectoryExists(path))
+  {
+    s_input_files.emplace_back(path);
+    return;
+  }
+
+  FileSystem::FindResultsArray results;
+  FileSystem::FindFiles(path, "*", FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE, &results);
+  std::sort(results.begin(), results.end(),
+            [](const FILESYSTEM_FIND_DATA& lhs, const FILESYSTEM_FIND_DATA& rhs) { return lhs.FileName < rhs.FileName; });
+  for (FILESYSTEM_FIND_DATA& fd : results)
+  {
+    if (System::IsPsfFileName(fd.FileName))
+      s_input_files.push_back(std::move(fd.FileName));
+  }
+}
+
+static bool ParseCommandLineArgs(int argc, char* argv[])
+{
+  bool no_more_args = false;
+  for (int i = 1; i < argc; i++)
+  {
+    if (!no_more_args)
+    {
+#define CHECK_ARG(str) !std::strcmp(argv[i], str)
+#define CHECK_ARG_PARAM(str) (!std::strcmp(argv[i], str) && ((i + 1) < argc))
+
+      if (CHECK_ARG("-help"))
+      {
+        PrintCommandLineHelp(argv[0]);
+        return false;
+      }
+      else if (CHECK_ARG("-version"))
+      {
+        PrintCommandLineVersion();
+        return false;
+      }
+      else if (CHECK_ARG_PARAM("-output"))
+      {
+        s_output_directory = argv[++i];
+        s_child_args.insert(s_child_args.end(), {argv[i - 1], argv[i]});
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-bios"))
+      {
+        s_bios_directory = argv[++i];
+        s_child_args.insert(s_child_args.end(), {argv[i - 1], argv[i]});
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-length") || CHECK_ARG_PARAM("-fade"))
+      {
+        const bool is_length = CHECK_ARG("-length");
+        const std::optional<float> value = ParseTime(argv[++i]);
+        if (!value.has_value())
+        {
+          Log_ErrorPrintf("Invalid time: %s", argv[i]);
+          return false;
+        }
+
+        (is_length ? s_default_length : s_default_fade) = value.value();
+        s_child_args.insert(s_child_args.end(), {argv[i - 1], argv[i]});
+        continue;
+      }
+      else if (CHECK_ARG("-keep-silence"))
+      {
+        s_trim_leading_silence = false;
+        s_child_args.emplace_back(argv[i]);
+        continue;
+      }
+      else if (CHECK_ARG_PARAM("-jobs"))
+      {
+        s_num_jobs = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+        if (s_num_jobs == 0)
+        {
+          Log_ErrorPrintf("Invalid job count: %s", argv[i]);
+          return false;
+        }
+        continue;
+      }
+      else if (CHECK_ARG("-verbose"))
+      {
+        Log::SetConsoleOutputParams(true, nullptr, LOGLEVEL_VERBOSE);
+        s_child_args.emplace_back(argv[i]);
+        continue;
+      }
+      else if (CHECK_ARG("--"))
+      {
+        no_more_args = true;
+        continue;
+      }
+      else if (argv[i][0] == '-')
+      {
+        Log_ErrorPrintf("Unknown parameter: '%s'", argv[i]);
+        return false;
+      }
+
+#undef CHECK_ARG
+#undef CHECK_ARG_PARAM
+    }
+
+    AddInputPath(argv[i]);
+  }
+
+  if (s_input_files.empty())
+  {
+    PrintCommandLineHelp(argv[0]);
+    return false;
+  }
+
+  return true;
+}
+
+static void InitializeSettings()
+{
+  const std::string program_path(FileSystem::GetProgramPath());
+  EmuFolders::AppRoot = Path::Canonicalize(Path::GetDirectory(program_path));
+  EmuFolders::DataRoot = EmuFolders::AppRoot;
+  EmuFolders::Resources = Path::Combine(EmuFolders::AppRoot, "resources");
+  EmuFolders::SetDefaults();
+  if (!s_bios_directory.empty())
+    EmuFolders::Bios = Path::Canonicalize(s_bios_directory);
+
+  SettingsInterface& si = s_base_settings_interface;
+  System::SetDefaultSettings(si);
+
+  // Nothing is displayed, so render as little as possible, and don't throttle or sync to the audio.
+  si.SetStringValue("GPU", "Renderer", Settings::GetRendererName(GPURenderer::Software));
+  si.SetBoolValue("GPU", "UseThread", false);
+  si.SetFloatValue("Main", "EmulationSpeed", 0.0f);
+  si.SetBoolValue("Main", "ApplyGameSettings", false);
+  si.SetStringValue("Audio", "Backend", Settings::GetAudioBackendName(AudioBackend::Null));
+  si.SetBoolValue("Audio", "Sync", false);
+
+  Host::Internal::SetBaseSettingsLayer(&si);
+  System::ApplySettings(false);
+}
+
+static bool RenderFile(const std::string& path)
+{
+  PSFLoader::File psf;
+  if (!psf.Load(path.c_str()))
+    return false;
+
+  const float length = ParseTime(psf.GetTagString("length", "")).value_or(s_default_length);
+  const float fade = ParseTime(psf.GetTagString("fade", "")).value_or(s_default_fade);
+  const std::string output_path(
+    s_output_directory.empty() ? Path::ReplaceExtension(path, "wav") :
+                                 Path::Combine(s_output_directory, Path::ReplaceExtension(Path::GetFileName(path), "wav")));
+
+  Log_InfoPrintf("Rendering '%s' (%.1f seconds + %.1f seconds fade) to '%s'...", path.c_str(), length, fade,
+                 output_path.c_str());
+
+  SystemBootParameters boot_params;
+  boot_params.filename = path;
+  if (!System::BootSystem(std::move(boot_params)))
+    return false;
+
+  // The SPU writes straight into the file, instead of the host's stream.
+  std::unique_ptr<WAVOutputStream> stream = std::make_unique<WAVOutputStream>();
+  WAVOutputStream* output_stream = stream.get();
+  g_spu.SetOutputStream(std::move(stream));
+  output_stream->PauseOutput(false);
+  if (!output_stream->StartFile(output_path.c_str(), static_cast<u32>(length * SAMPLE_RATE),
+                                 static_cast<u32>(fade * SAMPLE_RATE), s_trim_leading_silence))
+  {
+    Log_ErrorPrintf("Failed to open '%s' for writing.", output_path.c_str());
+    System::ShutdownSystem(false);
+    return false;
+  }
+
+  Common::Timer timer;
+  while (!output_stream->IsFinished() && System::IsValid())
+    System::RunFrame();
+
+  const u32 frames_written = output_stream->GetFramesWritten();
+  const bool result = output_stream->FinishFile();
+  System::ShutdownSystem(false);
+
+  const double audio_seconds = static_cast<double>(frames_written) / static_cast<double>(SAMPLE_RATE);
+  const double render_seconds = timer.GetTimeSeconds();
+  Log_InfoPrintf("Rendered %.1f seconds of audio in %.2f seconds (%.1fx realtime).", audio_seconds, render_seconds,
+                 audio_seconds / std::max(render_seconds, 0.001));
+  return result;
+}
+
+#ifdef _WIN32
+
+/// Quotes an argument so CommandLineToArgvW() gives it back unchanged. Backslashes are only special before a quote.
+static void AppendCommandLineArgument(std::wstring& command_line, const std::wstring& arg)
+{
+  if (!command_line.empty())
+    command_line += L' ';
+
+  command_line += L'"';
+  for (size_t i = 0;; i++)
+  {
+    size_t backslashes = 0;
+    for (; i < arg.size() && arg[i] == L'\\'; i++)
+      backslashes++;
+
+    if (i == arg.size())
+    {
+      command_line.append(backslashes * 2, L'\\');
+      break;
+    }
+
+    command_line.append((arg[i] == L'"') ? (backslashes * 2 + 1) : backslashes, L'\\');
+    command_line += arg[i];
+  }
+  command_line += L'"';
+}
+
+/// Runs a process directly rather than through a shell, so the arguments aren't interpreted.
+static bool RunChildProcess(const std::vector<std::string>& args)
+{
+  std::wstring command_line;
+  for (const std::string& arg : args)
+    AppendCommandLineArgument(command_line, StringUtil::UTF8StringToWideString(arg));
+
+  const std::wstring program(StringUtil::UTF8StringToWideString(args.front()));
+  STARTUPINFOW si = {};
+  si.cb = sizeof(si);
+  PROCESS_INFORMATION pi = {};
+  if (!CreateProcessW(program.c_str(), command_line.data(), nullptr, nullptr, FALSE, 0, nullptr, nullptr, &si, &pi))
+  {
+    Log_ErrorPrintf("CreateProcessW() failed: %u", GetLastError());
+    return false;
+  }
+
+  WaitForSingleObject(pi.hProcess, INFINITE);
+  DWORD exit_code = 1;
+  GetExitCodeProcess(pi.hProcess, &exit_code);
+  CloseHandle(pi.hThread);
+  CloseHandle(pi.hProcess);
+  return (exit_code == 0);
+}
+
+#else
+
+/// Runs a process directly rather than through a shell, so the arguments aren't interpreted.
+static bool RunChildProcess(const std::vector<std::string>& args)
+{
+  std::vector<char*> argv;
+  argv.reserve(args.size() + 1);
+  for (const std::string& arg : args)
+    argv.push_back(const_cast<char*>(arg.c_str()));
+  argv.push_back(nullptr);
+
+  pid_t pid;
+  const int res = posix_spawn(&pid, argv[0], nullptr, nullptr, argv.data(), environ);
+  if (res != 0)
+  {
+    Log_ErrorPrintf("posix_spawn() failed: %d", res);
+    return false;
+  }
+
+  int status = 0;
+  while (waitpid(pid, &status, 0) == -1)
+  {
+    if (errno != EINTR)
+      return false;
+  }
+
+  return (WIFEXITED(status) && WEXITSTATUS(status) == 0);
+}
+
+#endif
+
+/// The emulator state is global, so rendering files in parallel means running more than one copy of ourselves.
+static bool RenderFilesInChildProcesses()
+{
+  std::vector<std::string> base_args;
+  base_args.reserve(s_child_args.size() + 3);
+  base_args.push_back(FileSystem::GetProgramPath());
+  base_args.insert(base_args.end(), s_child_args.begin(), s_child_args.end());
+  base_args.push_back("--");
+
+  const u32 num_threads = std::min<u32>(s_num_jobs, static_cast<u32>(s_input_files.size()));
+  Log_InfoPrintf("Rendering %zu files with %u jobs...", s_input_files.size(), num_threads);
+
+  std::atomic<u32> next_file{0};
+  std::atomic<u32> failed_files{0};
+  auto worker = [&base_args, &next_file, &failed_files]() {
+    for (;;)
+    {
+      const u32 index = next_file.fetch_add(1);
+      if (index >= s_input_files.size())
+        break;
+
+      std::vector<std::string> args(base_args);
+      args.push_back(s_input_files[index]);
+      if (!RunChildProcess(args))
+      {
+        Log_ErrorPrintf("Failed to render '%s'", s_input_files[index].c_str());
+        failed_files.fetch_add(1);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (u32 i = 1; i < num_threads; i++)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  return (failed_files.load() == 0);
+}
+
+static bool RenderFiles()
+{
+  InitializeSettings();
+
+  u32 failed_files = 0;
+  for (const std::string& path : s_input_files)
+  {
+    if (!RenderFile(path))
+    {
+      Log_ErrorPrintf("Failed to render '%s'", path.c_str());
+      failed_files++;
+    }
+  }
+
+  if (failed_files > 0)
+    Log_ErrorPrintf("%u of %zu files failed to render.", failed_files, s_input_files.size());
+
+  return (failed_files == 0);
+}
+
+int main(int argc, char* argv[])
+{
+  Log::SetConsoleOutputParams(true, nullptr, LOGLEVEL_INFO);
+
+  if (!ParseCommandLineArgs(argc, argv))
+    return -1;
+
+  if (!s_output_directory.empty() && !FileSystem::EnsureDirectoryExists(s_output_directory.c_str(), true))
+  {
+    Log_ErrorPrintf("Failed to create output directory '%s'", s_output_directory.c_str());
+    return -1;
+  }
+
+  Common::Timer timer;
+  const bool result = (s_num_jobs > 1 && s_input_files.size() > 1) ? RenderFilesInChildProcesses() : RenderFiles();
+  Log_InfoPrintf("Finished in %.2f seconds.", timer.GetTimeSeconds());
+  return result ? 0 : -1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+// Host Interface
+//////////////////////////////////////////////////////////////////////////
+
+std::optional<std::vector<u8>> Host::ReadResourceFile(const char* filename)
+{
+  const std::string path(Path::Combine(EmuFolders::Resources, filename));
+  std::optional<std::vector<u8>> ret(FileSystem::ReadBinaryFile(path.c_str()));
+  if (!ret.has_value())
+    Log_ErrorPrintf("Failed to read resource file '%s'", filename);
+  return ret;
+}
+
+std::optional<std::string> Host::ReadResourceFileToString(const char* filename)
+{
+  const std::string path(Path::Combine(EmuFolders::Resources, filename));
+  std::optional<std::string> ret(FileSystem::ReadFileToString(path.c_str()));
+  if (!ret.has_value())
+    Log_ErrorPrintf("Failed to read resource file to string '%s'", filename);
+  return ret;
+}
+
+std::optional<std::time_t> Host::GetResourceFileTimestamp(const char* filename)
+{
+  const std::string path(Path::Combine(EmuFolders::Resources, filename));
+  FILESYSTEM_STAT_DATA sd;
+  if (!FileSystem::StatFile(path.c_str(), &sd))
+    return std::nullopt;
+
+  return sd.ModificationTime;
+}
+
+TinyString Host::TranslateString(const char* context, const char* str, const char* disambiguation /*= nullptr*/,
+                                 int n /*= -1*/)
+{
+  return str;
+}
+
+std::string Host::TranslateStdString(const char* context, const char* str, const char* disambiguation /*= nullptr*/,
+                                     int n /*= -1*/)
+{
+  return str;
+}
+
+void Host::ReportErrorAsync(const std::string_view& title, const std::string_view& message)
+{
+  Log_ErrorPrintf("%.*s: %.*s", static_cast<int>(title.size()), title.data(), static_cast<int>(message.size()),
+                  message.data());
+}
+
+bool Host::ConfirmMessage(const std::string_view& title, const std::string_view& message)
+{
+  Log_InfoPrintf("Confirm: %.*s: %.*s", static_cast<int>(title.size()), title.data(), static_cast<int>(message.size()),
+                 message.data());
+  return false;
+}
+
+void Host::ReportDebuggerMessage(const std::string_view& message)
+{
+  Log_DevPrintf("Debugger: %.*s", static_cast<int>(message.size()), message.data());
+}
+
+void Host::SetMouseMode(bool relative, bool hide_cursor) {}
+
+void Host::RunOnCPUThread(std::function<void()> function, bool block /* = false */)
+{
+  function();
+}
+
+void Host::SetBaseStringSettingValue(const char* section, const char* key, const char* value)
+{
+  auto lock = Host::GetSettingsLock();
+  s_base_settings_interface.SetStringValue(section, key, value);
+}
+
+void Host::DeleteBaseSettingValue(const char* section, const char* key)
+{
+  auto lock = Host::GetSettingsLock();
+  s_base_settings_interface.DeleteValue(section, key);
+}
+
+void Host::CommitBaseSettingChanges()
+{
+  // Settings are never saved.
+}
+
+void Host::LoadSettings(SettingsInterface& si, std::unique_lock<std::mutex>& lock) {}
+
+void Host::CheckForSettingsChanges(const Settings& old_settings) {}
+
+bool Host::AcquireHostDisplay(HostDisplay::RenderAPI api)
+{
+  g_host_display = std::make_unique<NullHostDisplay>();
+  return true;
+}
+
+void Host::ReleaseHostDisplay()
+{
+  g_host_display.reset();
+}
+
+void Host::RenderDisplay() {}
+
+void Host::InvalidateDisplay() {}
+
+void Host::OnSystemStarting() {}
+
+void Host::OnSystemStarted() {}
+
+void Host::OnSystemDestroyed() {}
+
+void Host::OnSystemPaused() {}
+
+void Host::OnSystemResumed() {}
+
+void Host::OnPerformanceCountersUpdated() {}
+
+void Host::OnGameChanged(const std::string& disc_path, const std::string& game_serial, const std::string& game_name)
+{
+}
+
+void Host::PumpMessagesOnCPUThread() {}
+
+void Host::RequestResizeHostDisplay(s32 width, s32 height) {}
+
+void Host::RequestExit(bool save_state_if_running) {}
+
+void Host::RequestSystemShutdown(bool allow_confirm, bool allow_save_state) {}
+
+bool Host::IsFullscreen()
+{
+  return false;
+}
+
+void Host::SetFullscreen(bool enabled) {}
+
+void Host::RefreshGameListAsync(bool invalidate_cache) {}
+
+void Host::CancelGameListRefresh() {}
+
+void Host::OnAchievementsRefreshed() {}
+
+void Host::OnAchievementsChallengeModeChanged() {}
+
+std::optional<u32> InputManager::ConvertHostKeyboardStringToCode(const std::string_view& str)
+{
+  return std::nullopt;
+}
+
+std::optional<std::string> InputManager::ConvertHostKeyboardCodeToString(u32 code)
+{
+  return std::nullopt;
+}
+
+BEGIN_HOTKEY_LIST(g_host_hotkeys)
+END_HOTKEY_LIST()
@@ -17,14 +17,25 @@ AudioSettingsWidget::AudioSettingsWidget(SettingsDialog* dialog, QWidget* parent
       qApp->translate("AudioBackend", Settings::GetAudioBackendDisplayName(static_cast<AudioBackend>(i))));
   }
 
+  for (u32 i = 0; i < static_cast<u32>(AudioResampler::Count); i++)
+  {
+    m_ui.resampler->addItem(
+      qApp->translate("AudioResampler", Settings::GetAudioResamplerDisplayName(static_cast<AudioResampler>(i))));
+  }
+
   SettingWidgetBinder::BindWidgetToEnumSetting(sif, m_ui.audioBackend, "Audio", "Backend", &Settings::ParseAudioBackend,
                                                &Settings::GetAudioBackendName, Settings::DEFAULT_AUDIO_BACKEND);
+  SettingWidgetBinder::BindWidgetToEnumSetting(sif, m_ui.resampler, "Audio", "Resampler",
+                                               &Settings::ParseAudioResampler, &Settings::GetAudioResamplerName,
+                                               Settings::DEFAULT_AUDIO_RESAMPLER);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.syncToOutput, "Audio", "Sync", true);
   SettingWidgetBinder::BindWidgetToIntSetting(sif, m_ui.bufferSize, "Audio", "BufferSize",
                                               Settings::DEFAULT_AUDIO_BUFFER_SIZE);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.startDumpingOnBoot, "Audio", "DumpOnBoot", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.muteCDAudio, "CDROM", "MuteCDAudio", false);
   SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.resampling, "Audio", "Resampling", true);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.spuThread, "Audio", "UseSPUThread", false);
+  SettingWidgetBinder::BindWidgetToBoolSetting(sif, m_ui.timeStretch, "Audio", "TimeStretch", false);
 
   connect(m_ui.bufferSize, &QSlider::valueChanged, this, &AudioSettingsWidget::updateBufferingLabel);
   updateBufferingLabel();
@@ -78,6 +89,18 @@ AudioSettingsWidget::AudioSettingsWidget(SettingsDialog* dialog, QWidget* parent
     m_ui.resampling, tr("Resampling"), tr("Checked"),
     tr("When running outside of 100% speed, resamples audio from the target speed instead of dropping frames. Produces "
        "much nicer fast forward/slowdown audio at a small cost to performance."));
+  dialog->registerWidgetHelp(
+    m_ui.spuThread, tr("SPU On Thread"), tr("Unchecked"),
+    tr("Mixes the SPU voices and reverb on a worker thread, which frees up time on the emulation thread on multi-core "
+       "systems. Only used while the game has SPU interrupts disabled, since interrupt timing must stay exact."));
+  dialog->registerWidgetHelp(
+    m_ui.resampler, tr("Resampler"), tr("libsamplerate (Sinc)"),
+    tr("Selects the resampler used when running outside of 100% speed. The polyphase resamplers work directly on "
+       "16-bit samples and are much cheaper than libsamplerate, at a small cost to quality on the lower settings."));
+  dialog->registerWidgetHelp(
+    m_ui.timeStretch, tr("Time Stretch"), tr("Unchecked"),
+    tr("When running outside of 100% speed, changes the tempo of the audio without changing its pitch, instead of "
+       "resampling it. Keeps audio continuous when fast forwarding or slowing down."));
 }
 
 AudioSettingsWidget::~AudioSettingsWidget() = default;
@@ -24,6 +24,7 @@ static const char* SUPPORTED_FORMATS_STRING =
                                     ".ecm (Error Code Modeling Image)\n"
                                     ".mds (Media Descriptor Sidecar)\n"
                                     ".chd (Compressed Hunks of Data)\n"
+                                    ".dci (DuckStation Compressed Image)\n"
                                     ".pbp (PlayStation Portable, Only Decrypted)");
 
 class GameListSortModel final : public QSortFilterProxyModel
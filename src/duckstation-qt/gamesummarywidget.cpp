@@ -213,6 +213,8 @@ void GameSummaryWidget::onComputeHashClicked()
     return;
   }
 
+  image->SetSectorCacheEnabled(false);
+
 #ifndef _DEBUGFAST
   // Kick off hash preparation asynchronously, as building the map of results may take a while
   // This breaks for DebugFast because of the iterator debug level mismatch.
@@ -221,41 +223,26 @@ void GameSummaryWidget::onComputeHashClicked()
 #endif
 
   QtProgressCallback progress_callback(this);
-  progress_callback.SetProgressRange(image->GetTrackCount());
 
+  // Calculate hashes, tracks are hashed in parallel
   std::vector<CDImageHasher::Hash> track_hashes;
-  track_hashes.reserve(image->GetTrackCount());
-
-  // Calculate hashes
-  bool calculate_hash_success = true;
-  for (u8 track = 1; track <= image->GetTrackCount(); track++)
-  {
-    progress_callback.SetProgressValue(track - 1);
-    progress_callback.PushState();
-
-    CDImageHasher::Hash hash;
-    if (!CDImageHasher::GetTrackHash(image.get(), track, &hash, &progress_callback))
-    {
-      progress_callback.PopState();
-      calculate_hash_success = false;
-      break;
-    }
-    track_hashes.emplace_back(hash);
-
-    QTableWidgetItem* item = m_ui.tracks->item(track - 1, 4);
-    item->setText(QString::fromStdString(CDImageHasher::HashToString(hash)));
-
-    progress_callback.PopState();
-  }
+  const bool calculate_hash_success = CDImageHasher::GetTrackHashes(image.get(), &track_hashes, &progress_callback);
 
   // Verify hashes against gamedb
   std::vector<bool> verification_results(image->GetTrackCount(), false);
   if (calculate_hash_success)
   {
+    for (u8 track = 1; track <= image->GetTrackCount(); track++)
+    {
+      QTableWidgetItem* item = m_ui.tracks->item(track - 1, 4);
+      item->setText(QString::fromStdString(CDImageHasher::HashToString(track_hashes[track - 1])));
+    }
+
     std::string found_revision;
     m_redump_search_keyword = CDImageHasher::HashToString(track_hashes.front());
 
     progress_callback.SetStatusText("Verifying hashes...");
+    progress_callback.SetProgressRange(image->GetTrackCount());
     progress_callback.SetProgressValue(image->GetTrackCount());
 
     // Verification strategy used:
@@ -0,0 +1,389 @@
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/string_util.h"
+#include "common/timer.h"
+#include "common/vulkan/shader_cache.h"
+#include "core/gpu_hw_shadergen.h"
+#include "core/shader_cache_version.h"
+#include "scmversion/scmversion.h"
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <iterator>
+#include <thread>
+#include <vector>
+Log_SetChannel(ShaderCacheGenerator);
+
+namespace {
+struct Configuration
+{
+  u32 resolution_scale;
+  u32 multisamples;
+  bool per_sample_shading;
+  bool true_color;
+  bool scaled_dithering;
+  GPUTextureFilter texture_filter;
+  bool uv_limits;
+  bool pgxp_depth;
+  bool dual_source_blend;
+};
+} // namespace
+
+static std::string s_output_directory;
+static std::vector<u32> s_resolution_scales = {1, 2, 3, 4};
+static std::vector<u32> s_multisamples = {1};
+static std::vector<GPUTextureFilter> s_texture_filters;
+static bool s_pgxp_depth = false;
+static bool s_dual_source_blend = true;
+static bool s_debug = false;
+static u32 s_num_threads = 0;
+
+static std::atomic_bool s_failed{false};
+
+// Same names as Settings::ParseTextureFilterName(), which would pull in the rest of the emulator.
+static constexpr const char* s_texture_filter_names[] = {"Nearest",       "Bilinear", "BilinearBinAlpha", "JINC2",
+                                                         "JINC2BinAlpha", "xBR",      "xBRBinAlpha"};
+static_assert(std::size(s_texture_filter_names) == static_cast<size_t>(GPUTextureFilter::Count));
+
+static void PrintCommandLineVersion()
+{
+  std::fprintf(stderr, "DuckStation Shader Cache Generator Version %s (%s)\n", g_scm_tag_str, g_scm_branch_str);
+  std::fprintf(stderr, "https://github.com/stenzek/duckstation\n");
+  std::fprintf(stderr, "\n");
+}
+
+static void PrintCommandLineHelp(const char* progname)
+{
+  PrintCommandLineVersion();
+  std::fprintf(stderr, "Usage: %s [parameters] <output directory>\n", progname);
+  std::fprintf(stderr, "\n");
+  std::fprintf(stderr, "  -help: Displays this information and exits.\n");
+  std::fprintf(stderr, "  -version: Displays version information and exits.\n");
+  std::fprintf(stderr, "  -scales <list>: Resolution scales to generate, e.g. 1,2,4 or 1-8. Defaults to 1-4.\n");
+  std::fprintf(stderr, "  -msaa <list>: Multisample counts to generate, e.g. 1,2,4. Defaults to 1.\n");
+  std::fprintf(stderr, "  -filters <list>: Texture filters to generate, e.g. Nearest,Bilinear. Defaults to all.\n");
+  std::fprintf(stderr, "  -pgxp-depth: Also generate shaders for the PGXP depth buffer.\n");
+  std::fprintf(stderr, "  -no-dual-source-blend: Generate shaders for devices without dual-source blending.\n");
+  std::fprintf(stderr, "  -debug: Writes the debug device shader cache instead.\n");
+  std::fprintf(stderr, "  -threads <count>: Number of compiler threads. Defaults to the number of CPUs.\n");
+  std::fprintf(stderr, "  -verbose: Enables verbose logging.\n");
+  std::fprintf(stderr, "\n");
+}
+
+static bool ParseScaleList(const char* str, std::vector<u32>* values)
+{
+  values->clear();
+  for (const std::string_view& part : StringUtil::SplitString(str, ','))
+  {
+    const std::string_view::size_type dash = part.find('-');
+    const std::optional<u32> first = StringUtil::FromChars<u32>(part.substr(0, dash));
+    const std::optional<u32> last =
+      (dash != std::string_view::npos) ? StringUtil::FromChars<u32>(part.substr(dash + 1)) : first;
+    if (!first.has_value() || !last.has_value() || first.value() == 0 || first.value() > last.value())
+      return false;
+
+    for (u32 value = first.value(); value <= last.value(); value++)
+      values->push_back(value);
+  }
+
+  return !values->empty();
+}
+
+static bool ParseCommandLineArgs(int argc, char* argv[])
+{
+  for (int i = 1; i < argc; i++)
+  {
+#define CHECK_ARG(str) !std::strcmp(argv[i], str)
+#define CHECK_ARG_PARAM(str) (!std::strcmp(argv[i], str) && ((i + 1) < argc))
+
+    if (CHECK_ARG("-help"))
+    {
+      PrintCommandLineHelp(argv[0]);
+      return false;
+    }
+    else if (CHECK_ARG("-version"))
+    {
+      PrintCommandLineVersion();
+      return false;
+    }
+    else if (CHECK_ARG_PARAM("-scales"))
+    {
+      if (!ParseScaleList(argv[++i], &s_resolution_scales))
+      {
+        Log_ErrorPrintf("Invalid resolution scale list: %s", argv[i]);
+        return false;
+      }
+      continue;
+    }
+    else if (CHECK_ARG_PARAM("-msaa"))
+    {
+      if (!ParseScaleList(argv[++i], &s_multisamples))
+      {
+        Log_ErrorPrintf("Invalid multisample list: %s", argv[i]);
+        return false;
+      }
+      continue;
+    }
+    else if (CHECK_ARG_PARAM("-filters"))
+    {
+      s_texture_filters.clear();
+      for (const std::string_view& name : StringUtil::SplitString(argv[++i], ','))
+      {
+        u32 index = 0;
+        while (index < std::size(s_texture_filter_names) &&
+               StringUtil::Strncasecmp(s_texture_filter_names[index], name.data(), name.size()) != 0)
+        {
+          index++;
+        }
+        if (index == std::size(s_texture_filter_names) || s_texture_filter_names[index][name.size()] != '\0')
+        {
+          Log_ErrorPrintf("Invalid texture filter: %.*s", static_cast<int>(name.size()), name.data());
+          return false;
+        }
+
+        s_texture_filters.push_back(static_cast<GPUTextureFilter>(index));
+      }
+      continue;
+    }
+    else if (CHECK_ARG("-pgxp-depth"))
+    {
+      s_pgxp_depth = true;
+      continue;
+    }
+    else if (CHECK_ARG("-no-dual-source-blend"))
+    {
+      s_dual_source_blend = false;
+      continue;
+    }
+    else if (CHECK_ARG("-debug"))
+    {
+      s_debug = true;
+      continue;
+    }
+    else if (CHECK_ARG_PARAM("-threads"))
+    {
+      s_num_threads = StringUtil::FromChars<u32>(argv[++i]).value_or(0);
+      if (s_num_threads == 0)
+      {
+        Log_ErrorPrintf("Invalid thread count: %s", argv[i]);
+        return false;
+      }
+      continue;
+    }
+    else if (CHECK_ARG("-verbose"))
+    {
+      Log::SetConsoleOutputParams(true, nullptr, LOGLEVEL_VERBOSE);
+      continue;
+    }
+    else if (argv[i][0] == '-')
+    {
+      Log_ErrorPrintf("Unknown parameter: '%s'", argv[i]);
+      return false;
+    }
+
+#undef CHECK_ARG
+#undef CHECK_ARG_PARAM
+
+    s_output_directory = argv[i];
+  }
+
+  if (s_output_directory.empty())
+  {
+    PrintCommandLineHelp(argv[0]);
+    return false;
+  }
+
+  if (s_texture_filters.empty())
+  {
+    for (u32 i = 0; i < static_cast<u32>(GPUTextureFilter::Count); i++)
+      s_texture_filters.push_back(static_cast<GPUTextureFilter>(i));
+  }
+
+  return true;
+}
+
+static std::vector<Configuration> EnumerateConfigurations()
+{
+  std::vector<Configuration> configs;
+
+  for (const u32 resolution_scale : s_resolution_scales)
+  {
+    for (const u32 multisamples : s_multisamples)
+    {
+      for (u8 per_sample_shading = 0; per_sample_shading < ((multisamples > 1) ? 2 : 1); per_sample_shading++)
+      {
+        for (const GPUTextureFilter texture_filter : s_texture_filters)
+        {
+          // Filters which need dual-source blending fall back to nearest at runtime.
+          if (!s_dual_source_blend &&
+              (texture_filter == GPUTextureFilter::Bilinear || texture_filter == GPUTextureFilter::JINC2 ||
+               texture_filter == GPUTextureFilter::xBR))
+          {
+            continue;
+          }
+
+          for (u8 pgxp_depth = 0; pgxp_depth < (s_pgxp_depth ? 2 : 1); pgxp_depth++)
+          {
+            // UV limits are always used with filtering, and with PGXP otherwise.
+            const bool uv_limits_required = (texture_filter != GPUTextureFilter::Nearest || pgxp_depth);
+            for (u8 uv_limits = uv_limits_required ? 1 : 0; uv_limits < 2; uv_limits++)
+            {
+              for (u8 true_color = 0; true_color < 2; true_color++)
+              {
+                for (u8 scaled_dithering = 0; scaled_dithering < 2; scaled_dithering++)
+                {
+                  configs.push_back(Configuration{resolution_scale, multisamples, per_sample_shading != 0,
+                                                  true_color != 0, scaled_dithering != 0, texture_filter,
+                                                  uv_limits != 0, pgxp_depth != 0, s_dual_source_blend});
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  return configs;
+}
+
+static void AddShader(Vulkan::ShaderCache& cache, Vulkan::ShaderCompiler::Type type, const std::string& source)
+{
+  if (!cache.GetShaderSPV(type, source).has_value())
+    s_failed.store(true);
+}
+
+// Must match the shaders which GPU_HW_Vulkan::CompilePipelines() requests.
+static void GenerateShaders(Vulkan::ShaderCache& cache, const Configuration& config)
+{
+  using Vulkan::ShaderCompiler::Type;
+
+  GPU_HW_ShaderGen shadergen(HostDisplay::RenderAPI::Vulkan, config.resolution_scale, config.multisamples,
+                             config.per_sample_shading, config.true_color, config.scaled_dithering,
+                             config.texture_filter, config.uv_limits, config.pgxp_depth, config.dual_source_blend);
+
+  for (u8 textured = 0; textured < 2; textured++)
+    AddShader(cache, Type::Vertex, shadergen.GenerateBatchVertexShader(ConvertToBoolUnchecked(textured)));
+
+  for (u8 render_mode = 0; render_mode < 4; render_mode++)
+  {
+    for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
+    {
+      for (u8 dithering = 0; dithering < 2; dithering++)
+      {
+        for (u8 interlacing = 0; interlacing < 2; interlacing++)
+        {
+          AddShader(cache, Type::Fragment,
+                    shadergen.GenerateBatchFragmentShader(
+                      static_cast<GPU_HW::BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
+                      ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing)));
+        }
+      }
+    }
+  }
+
+  AddShader(cache, Type::Vertex, shadergen.GenerateScreenQuadVertexShader());
+  AddShader(cache, Type::Vertex, shadergen.GenerateUVQuadVertexShader());
+
+  for (u8 wrapped = 0; wrapped < 2; wrapped++)
+  {
+    for (u8 interlaced = 0; interlaced < 2; interlaced++)
+    {
+      AddShader(cache, Type::Fragment,
+                shadergen.GenerateVRAMFillFragmentShader(ConvertToBoolUnchecked(wrapped),
+                                                         ConvertToBoolUnchecked(interlaced)));
+    }
+  }
+
+  AddShader(cache, Type::Fragment, shadergen.GenerateVRAMCopyFragmentShader());
+  for (u8 use_ssbo = 0; use_ssbo < 2; use_ssbo++)
+    AddShader(cache, Type::Fragment, shadergen.GenerateVRAMWriteFragmentShader(ConvertToBoolUnchecked(use_ssbo)));
+  AddShader(cache, Type::Fragment, shadergen.GenerateVRAMUpdateDepthFragmentShader());
+  AddShader(cache, Type::Fragment, shadergen.GenerateVRAMReadFragmentShader());
+
+  for (u8 depth_24 = 0; depth_24 < 2; depth_24++)
+  {
+    for (u8 interlace_mode = 0; interlace_mode < 3; interlace_mode++)
+    {
+      for (u8 smooth_chroma = 0; smooth_chroma < 2; smooth_chroma++)
+      {
+        AddShader(cache, Type::Fragment,
+                  shadergen.GenerateDisplayFragmentShader(ConvertToBoolUnchecked(depth_24),
+                                                          static_cast<GPU_HW::InterlacedRenderMode>(interlace_mode),
+                                                          ConvertToBoolUnchecked(smooth_chroma)));
+      }
+    }
+  }
+
+  if (config.resolution_scale > 1)
+  {
+    AddShader(cache, Type::Fragment, shadergen.GenerateAdaptiveDownsampleMipFragmentShader(true));
+    AddShader(cache, Type::Fragment, shadergen.GenerateAdaptiveDownsampleMipFragmentShader(false));
+    AddShader(cache, Type::Fragment, shadergen.GenerateAdaptiveDownsampleBlurFragmentShader());
+    AddShader(cache, Type::Fragment, shadergen.GenerateAdaptiveDownsampleCompositeFragmentShader());
+    AddShader(cache, Type::Fragment, shadergen.GenerateBoxSampleDownsampleFragmentShader());
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  Log::SetConsoleOutputParams(true, nullptr, LOGLEVEL_INFO);
+
+  if (!ParseCommandLineArgs(argc, argv))
+    return -1;
+
+  if (!FileSystem::EnsureDirectoryExists(s_output_directory.c_str(), true))
+  {
+    Log_ErrorPrintf("Failed to create output directory '%s'", s_output_directory.c_str());
+    return -1;
+  }
+
+  std::unique_ptr<Vulkan::ShaderCache> cache =
+    Vulkan::ShaderCache::OpenSPIRVCache(s_output_directory, SHADER_CACHE_VERSION, s_debug);
+  if (!cache)
+  {
+    Log_ErrorPrintf("Failed to open shader cache in '%s'", s_output_directory.c_str());
+    return -1;
+  }
+
+  const std::vector<Configuration> configs = EnumerateConfigurations();
+  const u32 num_threads =
+    std::max<u32>((s_num_threads > 0) ? s_num_threads : std::thread::hardware_concurrency(), 1u);
+  const u32 initial_count = cache->GetShaderCount();
+  Log_InfoPrintf("Generating shaders for %zu configurations with %u threads...", configs.size(), num_threads);
+
+  // Shaders shared between configurations are only compiled once, the cache deduplicates them by source.
+  Common::Timer timer;
+  std::atomic<u32> next_config{0};
+  auto worker = [&cache, &configs, &next_config]() {
+    for (;;)
+    {
+      const u32 index = next_config.fetch_add(1);
+      if (index >= configs.size())
+        break;
+
+      GenerateShaders(*cache, configs[index]);
+      if (index > 0 && (index % 100) == 0)
+        Log_InfoPrintf("%u/%zu configurations processed", index, configs.size());
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (u32 i = 1; i < num_threads; i++)
+    threads.emplace_back(worker);
+  worker();
+  for (std::thread& thread : threads)
+    thread.join();
+
+  Log_InfoPrintf("Added %u shaders (%u total) in %.2f seconds.", cache->GetShaderCount() - initial_count,
+                 cache->GetShaderCount(), timer.GetTimeSeconds());
+  cache.reset();
+
+  if (s_failed.load())
+  {
+    Log_ErrorPrintf("One or more shaders failed to compile.");
+    return -1;
+  }
+
+  return 0;
+}
@@ -673,7 +673,7 @@ void FullscreenUI::DestroyResources()
 ImGuiFullscreen::FileSelectorFilters FullscreenUI::GetDiscImageFilters()
 {
   return {"*.bin",   "*.cue",    "*.iso", "*.img", "*.chd",     "*.ecm", "*.mds",
-          "*.psexe", "*.ps-exe", "*.exe", "*.psf", "*.minipsf", "*.m3u", "*.pbp"};
+          "*.psexe", "*.ps-exe", "*.exe", "*.psf", "*.minipsf", "*.m3u", "*.pbp", "*.dci"};
 }
 
 void FullscreenUI::DoStartPath(std::string path, std::string state, std::optional<bool> fast_boot)
@@ -3172,6 +3172,15 @@ void FullscreenUI::DrawAudioSettingsPage()
     "Resampling",
     "When running outside of 100% speed, resamples audio from the target speed instead of dropping frames.", "Audio",
     "Resampling", true);
+  DrawEnumSetting("Resampler", "Selects the resampler used when running outside of 100% speed.", "Audio", "Resampler",
+                  Settings::DEFAULT_AUDIO_RESAMPLER, &Settings::ParseAudioResampler, &Settings::GetAudioResamplerName,
+                  &Settings::GetAudioResamplerDisplayName, AudioResampler::Count);
+  DrawToggleSetting("Time Stretch",
+                    "When running outside of 100% speed, changes the tempo of the audio without changing its pitch.",
+                    "Audio", "TimeStretch", false);
+  DrawToggleSetting("SPU On Thread",
+                    "Mixes the SPU voices and reverb on a worker thread, when the game isn't using SPU interrupts.",
+                    "Audio", "UseSPUThread", false);
 
   EndMenuButtons();
 }
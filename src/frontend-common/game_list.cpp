@@ -14,9 +14,11 @@
 #include "core/settings.h"
 #include "core/system.h"
 #include "util/cd_image.h"
+#include "util/cd_image_hasher.h"
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <cinttypes>
 #include <ctime>
 #include <string_view>
 #include <tinyxml2.h>
@@ -26,7 +28,7 @@ Log_SetChannel(GameList);
 enum : u32
 {
   GAME_LIST_CACHE_SIGNATURE = 0x45434C47,
-  GAME_LIST_CACHE_VERSION = 32
+  GAME_LIST_CACHE_VERSION = 33
 };
 
 namespace GameList {
@@ -34,6 +36,7 @@ using CacheMap = std::unordered_map<std::string, Entry>;
 
 static bool GetExeListEntry(const std::string& path, Entry* entry);
 static bool GetPsfListEntry(const std::string& path, Entry* entry);
+static std::string GetImageHashCode(CDImage* cdi);
 static bool GetDiscListEntry(const std::string& path, Entry* entry);
 
 static bool GetGameListEntryFromCache(const std::string& path, Entry* entry);
@@ -161,12 +164,29 @@ bool GameList::GetPsfListEntry(const std::string& path, Entry* entry)
   return true;
 }
 
+std::string GameList::GetImageHashCode(CDImage* cdi)
+{
+  // no executable to identify the disc by (e.g. audio discs), so fall back to hashing the whole image
+  CDImageHasher::Hash hash;
+  if (!CDImageHasher::GetImageFastHash(cdi, &hash))
+    return {};
+
+  u64 code = 0;
+  for (u32 i = 0; i < sizeof(code); i++)
+    code = (code << 8) | hash[i];
+
+  return StringUtil::StdStringFromFormat("HASH-%" PRIX64, code);
+}
+
 bool GameList::GetDiscListEntry(const std::string& path, Entry* entry)
 {
   std::unique_ptr<CDImage> cdi = CDImage::Open(path.c_str(), nullptr);
   if (!cdi)
     return false;
 
+  // each image is only read once while scanning, which shouldn't evict the running game's sectors
+  cdi->SetSectorCacheEnabled(false);
+
   entry->path = path;
   entry->total_size = static_cast<u64>(CDImage::RAW_SECTOR_SIZE) * static_cast<u64>(cdi->GetLBACount());
   entry->type = EntryType::Disc;
@@ -196,6 +216,8 @@ bool GameList::GetDiscListEntry(const std::string& path, Entry* entry)
 
     // no game code, so use the filename title
     entry->serial = System::GetGameCodeForImage(cdi.get(), true);
+    if (entry->serial.empty())
+      entry->serial = GetImageHashCode(cdi.get());
     entry->title = Path::GetFileTitle(display_name);
     entry->compatibility = GameDatabase::CompatibilityRating::Unknown;
     entry->release_date = 0;
@@ -7,6 +7,7 @@
 #include "common/string_util.h"
 #include "common/timer.h"
 #include "common_host.h"
+#include "core/cdrom.h"
 #include "core/controller.h"
 #include "core/gpu.h"
 #include "core/host.h"
@@ -172,6 +173,19 @@ void ImGuiManager::DrawPerformanceOverlay()
         FormatProcessorStat(text, System::GetSWThreadUsage(), System::GetSWThreadAverageTime());
         DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
       }
+
+      text.Fmt("Display: {:.1f}% unchanged", System::GetSkippedDisplayUpdatePercentage());
+      DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+
+      if (g_cdrom.HasMedia() && g_cdrom.IsUsingReadThread())
+      {
+        const CDROMAsyncReader::Statistics stats = g_cdrom.GetReaderStatistics();
+        const u32 lookups = stats.hits + stats.misses;
+        text.Fmt("CD: {:.1f}% hit | {} waits ({:.2f}ms) | RA {}",
+                 (lookups > 0) ? (static_cast<float>(stats.hits) * 100.0f / static_cast<float>(lookups)) : 0.0f,
+                 stats.waits, stats.wait_time_ms, stats.readahead_depth);
+        DRAW_LINE(fixed_font, text, IM_COL32(255, 255, 255, 255));
+      }
     }
 
     if (g_settings.display_show_status_indicators)
@@ -6,7 +6,7 @@
 #include <cstring>
 Log_SetChannel(AudioStream);
 
-AudioStream::AudioStream() = default;
+AudioStream::AudioStream() : m_buffer(std::make_unique<SampleType[]>(MaxSamples)) {}
 
 AudioStream::~AudioStream()
 {
@@ -17,13 +17,15 @@ bool AudioStream::Reconfigure(u32 input_sample_rate /* = DefaultInputSampleRate
                               u32 output_sample_rate /* = DefaultOutputSampleRate */, u32 channels /* = 1 */,
                               u32 buffer_size /* = DefaultBufferSize */)
 {
-  std::unique_lock<std::mutex> buffer_lock(m_buffer_mutex);
   std::unique_lock<std::mutex> resampler_Lock(m_resampler_mutex);
 
   DestroyResampler();
   if (IsDeviceOpen())
     CloseDevice();
 
+  // Device is closed, so nothing is reading from the ring.
+  ResetBuffers();
+
   m_output_sample_rate = output_sample_rate;
   m_channels = channels;
   m_buffer_size = buffer_size;
@@ -35,7 +37,6 @@ bool AudioStream::Reconfigure(u32 input_sample_rate /* = DefaultInputSampleRate
 
   if (!OpenDevice())
   {
-    LockedEmptyBuffers();
     m_buffer_size = 0;
     m_output_sample_rate = 0;
     m_channels = 0;
@@ -50,17 +51,27 @@ bool AudioStream::Reconfigure(u32 input_sample_rate /* = DefaultInputSampleRate
 
 void AudioStream::SetInputSampleRate(u32 sample_rate)
 {
-  std::unique_lock<std::mutex> buffer_lock(m_buffer_mutex);
   std::unique_lock<std::mutex> resampler_lock(m_resampler_mutex);
 
   InternalSetInputSampleRate(sample_rate);
 }
 
+void AudioStream::SetStretchTempo(float tempo)
+{
+  std::unique_lock<std::mutex> resampler_lock(m_resampler_mutex);
+  if (m_stretch_tempo == tempo)
+    return;
+
+  m_stretch_tempo = tempo;
+  m_stretching.store(tempo != 1.0f);
+  if (m_resampler_state)
+    ResetResampler();
+}
+
 void AudioStream::SetWaitForBufferFill(bool enabled)
 {
-  std::unique_lock<std::mutex> buffer_lock(m_buffer_mutex);
-  m_wait_for_buffer_fill = enabled;
-  if (enabled && m_buffer.IsEmpty())
+  m_wait_for_buffer_fill.store(enabled);
+  if (enabled && GetBufferedSamples() == 0)
     m_buffer_filling.store(true);
 }
 
@@ -72,13 +83,28 @@ void AudioStream::InternalSetInputSampleRate(u32 sample_rate)
   m_input_sample_rate = sample_rate;
   m_resampler_ratio = static_cast<double>(m_output_sample_rate) / static_cast<double>(sample_rate);
   src_set_ratio(static_cast<SRC_STATE*>(m_resampler_state), m_resampler_ratio);
+  m_polyphase_resampler.SetRates(sample_rate, m_output_sample_rate);
   ResetResampler();
 }
 
+void AudioStream::SetResampler(ResamplerType type, PolyphaseResampler::Quality polyphase_quality)
+{
+  std::unique_lock<std::mutex> resampler_lock(m_resampler_mutex);
+  if (m_resampler_type == type && m_polyphase_quality == polyphase_quality)
+    return;
+
+  m_resampler_type = type;
+  m_polyphase_quality = polyphase_quality;
+  if (m_resampler_state)
+  {
+    ConfigurePolyphaseResampler();
+    ResetResampler();
+  }
+}
+
 void AudioStream::SetOutputVolume(u32 volume)
 {
-  std::unique_lock<std::mutex> lock(m_buffer_mutex);
-  m_output_volume = volume;
+  m_output_volume.store(volume);
 }
 
 void AudioStream::PauseOutput(bool paused)
@@ -100,7 +126,10 @@ void AudioStream::Shutdown()
     return;
 
   CloseDevice();
-  EmptyBuffers();
+  ResetBuffers();
+
+  Log_DevPrintf("Audio stream shut down with %u underflows and %u overflows", GetUnderflowCount(), GetOverflowCount());
+
   m_buffer_size = 0;
   m_output_sample_rate = 0;
   m_channels = 0;
@@ -109,37 +138,61 @@ void AudioStream::Shutdown()
 
 void AudioStream::BeginWrite(SampleType** buffer_ptr, u32* num_frames)
 {
-  m_buffer_mutex.lock();
-
   const u32 requested_frames = std::min(*num_frames, m_buffer_size);
-  EnsureBuffer(requested_frames * m_channels);
+  if (!EnsureBuffer(requested_frames * m_channels))
+  {
+    // Ring is full and we're not syncing. The producer can't remove samples from the ring, so these frames get
+    // written to scratch space and dropped in EndWrite() instead.
+    m_writing_to_overflow_buffer = true;
+    *buffer_ptr = m_overflow_buffer.data();
+    *num_frames = requested_frames;
+    return;
+  }
 
-  *buffer_ptr = m_buffer.GetWritePointer();
-  *num_frames = std::min(m_buffer_size, m_buffer.GetContiguousSpace() / m_channels);
+  const u32 offset = m_write_position.load(std::memory_order_relaxed) & (MaxSamples - 1);
+  *buffer_ptr = &m_buffer[offset];
+  *num_frames = std::min(m_buffer_size, std::min(GetBufferSpace(), MaxSamples - offset) / m_channels);
 }
 
 void AudioStream::WriteFrames(const SampleType* frames, u32 num_frames)
 {
   Assert(num_frames <= m_buffer_size);
   const u32 num_samples = num_frames * m_channels;
+  if (!EnsureBuffer(num_samples))
   {
-    std::unique_lock<std::mutex> lock(m_buffer_mutex);
-    EnsureBuffer(num_samples);
-    m_buffer.PushRange(frames, num_samples);
+    m_overflow_count.fetch_add(1, std::memory_order_relaxed);
+    Log_VerbosePrintf("Audio buffer overflow, dropped %u frames", num_frames);
+    return;
   }
 
+  const u32 write_pos = m_write_position.load(std::memory_order_relaxed);
+  const u32 offset = write_pos & (MaxSamples - 1);
+  const u32 first_part = std::min(num_samples, MaxSamples - offset);
+  std::memcpy(&m_buffer[offset], frames, sizeof(SampleType) * first_part);
+  if (first_part < num_samples)
+    std::memcpy(&m_buffer[0], frames + first_part, sizeof(SampleType) * (num_samples - first_part));
+
+  m_write_position.store(write_pos + num_samples, std::memory_order_release);
   FramesAvailable();
 }
 
 void AudioStream::EndWrite(u32 num_frames)
 {
-  m_buffer.AdvanceTail(num_frames * m_channels);
+  if (m_writing_to_overflow_buffer)
+  {
+    m_writing_to_overflow_buffer = false;
+    m_overflow_count.fetch_add(1, std::memory_order_relaxed);
+    Log_VerbosePrintf("Audio buffer overflow, dropped %u frames", num_frames);
+    return;
+  }
+
+  m_write_position.store(m_write_position.load(std::memory_order_relaxed) + (num_frames * m_channels),
+                         std::memory_order_release);
   if (m_buffer_filling.load())
   {
-    if ((m_buffer.GetSize() / m_channels) >= m_buffer_size)
+    if ((GetBufferedSamples() / m_channels) >= m_buffer_size)
       m_buffer_filling.store(false);
   }
-  m_buffer_mutex.unlock();
   FramesAvailable();
 }
 
@@ -152,62 +205,87 @@ bool AudioStream::SetBufferSize(u32 buffer_size)
 {
   const u32 buffer_size_in_samples = buffer_size * m_channels;
   const u32 max_samples = buffer_size_in_samples * 2u;
-  if (max_samples > m_buffer.GetCapacity())
+  if (max_samples > MaxSamples)
     return false;
 
   m_buffer_size = buffer_size;
   m_max_samples = max_samples;
+  m_overflow_buffer.resize(buffer_size_in_samples);
   return true;
 }
 
 u32 AudioStream::GetSamplesAvailable() const
 {
-  // TODO: Use atomic loads
-  u32 available_samples;
+  return GetBufferedSamples() / m_channels;
+}
+
+void AudioStream::HandleDiscardRequest()
+{
+  if (!m_discard_requested.load(std::memory_order_relaxed) ||
+      !m_discard_requested.exchange(false, std::memory_order_acquire))
   {
-    std::unique_lock<std::mutex> lock(m_buffer_mutex);
-    available_samples = m_buffer.GetSize();
+    return;
   }
 
-  return available_samples / m_channels;
+  // We may have already read past the requested position, never move backwards.
+  const u32 discard_pos = m_discard_position.load(std::memory_order_relaxed);
+  if (static_cast<s32>(discard_pos - m_read_position.load(std::memory_order_relaxed)) > 0)
+    AdvanceReadPosition(discard_pos);
+
+  std::unique_lock<std::mutex> resampler_lock(m_resampler_mutex);
+  ResetResampler();
+}
+
+u32 AudioStream::PopSamples(SampleType* samples, u32 count)
+{
+  const u32 read_pos = m_read_position.load(std::memory_order_relaxed);
+  count = std::min(count, m_write_position.load(std::memory_order_acquire) - read_pos);
+  if (count == 0)
+    return 0;
+
+  const u32 offset = read_pos & (MaxSamples - 1);
+  const u32 first_part = std::min(count, MaxSamples - offset);
+  std::memcpy(samples, &m_buffer[offset], sizeof(SampleType) * first_part);
+  if (first_part < count)
+    std::memcpy(samples + first_part, &m_buffer[0], sizeof(SampleType) * (count - first_part));
+
+  AdvanceReadPosition(read_pos + count);
+  return count;
 }
 
-u32 AudioStream::GetSamplesAvailableLocked() const
+void AudioStream::AdvanceReadPosition(u32 new_read_position)
 {
-  return m_buffer.GetSize() / m_channels;
+  // Pairs with the store to m_write_waiting in EnsureBuffer(). Both are sequentially consistent, so either the
+  // producer sees the new position when it rechecks, or we see the flag and wake it.
+  m_read_position.store(new_read_position);
+  if (m_write_waiting.load())
+    m_buffer_draining_event.Signal();
 }
 
 void AudioStream::ReadFrames(SampleType* samples, u32 num_frames, bool apply_volume)
 {
+  HandleDiscardRequest();
+
   const u32 total_samples = num_frames * m_channels;
   u32 samples_copied = 0;
-  std::unique_lock<std::mutex> buffer_lock(m_buffer_mutex);
   if (!m_buffer_filling.load())
   {
-    if (m_input_sample_rate == m_output_sample_rate)
+    if (m_input_sample_rate.load(std::memory_order_relaxed) == m_output_sample_rate &&
+        !m_stretching.load(std::memory_order_relaxed))
     {
-      samples_copied = std::min(m_buffer.GetSize(), total_samples);
-      if (samples_copied > 0)
-        m_buffer.PopRange(samples, samples_copied);
-
-      ReleaseBufferLock(std::move(buffer_lock));
+      samples_copied = PopSamples(samples, total_samples);
     }
     else
     {
+      std::unique_lock<std::mutex> resampler_lock(m_resampler_mutex);
       if (m_resampled_buffer.GetSize() < total_samples)
-        ResampleInput(std::move(buffer_lock));
-      else
-        ReleaseBufferLock(std::move(buffer_lock));
+        ResampleInput();
 
       samples_copied = std::min(m_resampled_buffer.GetSize(), total_samples);
       if (samples_copied > 0)
         m_resampled_buffer.PopRange(samples, samples_copied);
     }
   }
-  else
-  {
-    ReleaseBufferLock(std::move(buffer_lock));
-  }
 
   if (samples_copied < total_samples)
   {
@@ -236,68 +314,91 @@ void AudioStream::ReadFrames(SampleType* samples, u32 num_frames, bool apply_vol
       }
 
       Log_VerbosePrintf("Audio buffer underflow, resampled %u frames to %u", samples_copied / m_channels, num_frames);
-      m_underflow_flag.store(true);
+      m_underflow_count.fetch_add(1, std::memory_order_relaxed);
     }
     else
     {
       // read nothing, so zero-fill
       std::memset(samples, 0, sizeof(SampleType) * total_samples);
       Log_VerbosePrintf("Audio buffer underflow with no samples, added %u frames silence", num_frames);
-      m_underflow_flag.store(true);
+      m_underflow_count.fetch_add(1, std::memory_order_relaxed);
     }
 
     m_buffer_filling.store(m_wait_for_buffer_fill);
   }
 
-  if (apply_volume && m_output_volume != FullVolume)
+  const u32 output_volume = m_output_volume.load(std::memory_order_relaxed);
+  if (apply_volume && output_volume != FullVolume)
   {
     SampleType* current_ptr = samples;
     const SampleType* end_ptr = samples + (num_frames * m_channels);
     while (current_ptr != end_ptr)
     {
-      *current_ptr = ApplyVolume(*current_ptr, m_output_volume);
+      *current_ptr = ApplyVolume(*current_ptr, output_volume);
       current_ptr++;
     }
   }
 }
 
-void AudioStream::EnsureBuffer(u32 size)
+bool AudioStream::EnsureBuffer(u32 size)
 {
   DebugAssert(size <= (m_buffer_size * m_channels));
   if (GetBufferSpace() >= size)
-    return;
+    return true;
+  else if (!m_sync)
+    return false;
 
-  if (m_sync)
+  for (;;)
   {
-    std::unique_lock<std::mutex> lock(m_buffer_mutex, std::adopt_lock);
-    m_buffer_draining_cv.wait(lock, [this, size]() { return GetBufferSpace() >= size; });
-    lock.release();
-  }
-  else
-  {
-    m_buffer.Remove(size);
+    m_buffer_draining_event.Reset();
+    m_write_waiting.store(true);
+    if (GetBufferSpace() >= size)
+      break;
+
+    m_buffer_draining_event.Wait();
   }
+
+  m_write_waiting.store(false);
+  return true;
 }
 
 void AudioStream::DropFrames(u32 count)
 {
-  std::unique_lock<std::mutex> lock(m_buffer_mutex);
-  m_buffer.Remove(count);
+  const u32 read_pos = m_read_position.load(std::memory_order_relaxed);
+  const u32 available = m_write_position.load(std::memory_order_acquire) - read_pos;
+  AdvanceReadPosition(read_pos + std::min(count * m_channels, available));
 }
 
 void AudioStream::EmptyBuffers()
 {
-  std::unique_lock<std::mutex> lock(m_buffer_mutex);
-  std::unique_lock<std::mutex> resampler_lock(m_resampler_mutex);
-  LockedEmptyBuffers();
+  m_last_underflow_count = m_underflow_count.load(std::memory_order_relaxed);
+  m_buffer_filling.store(m_wait_for_buffer_fill.load());
+
+  if (m_output_paused)
+  {
+    // Device isn't calling back, so we're the only one touching the ring.
+    std::unique_lock<std::mutex> resampler_lock(m_resampler_mutex);
+    m_discard_requested.store(false, std::memory_order_relaxed);
+    AdvanceReadPosition(m_write_position.load(std::memory_order_relaxed));
+    ResetResampler();
+    return;
+  }
+
+  // Everything written up to now gets dropped the next time the device reads.
+  m_discard_position.store(m_write_position.load(std::memory_order_relaxed), std::memory_order_relaxed);
+  m_discard_requested.store(true, std::memory_order_release);
 }
 
-void AudioStream::LockedEmptyBuffers()
+void AudioStream::ResetBuffers()
 {
-  m_buffer.Clear();
-  m_underflow_flag.store(false);
-  m_buffer_filling.store(m_wait_for_buffer_fill);
-  ResetResampler();
+  m_write_position.store(0, std::memory_order_relaxed);
+  m_read_position.store(0, std::memory_order_relaxed);
+  m_discard_requested.store(false, std::memory_order_relaxed);
+  m_writing_to_overflow_buffer = false;
+  m_last_underflow_count = m_underflow_count.load(std::memory_order_relaxed);
+  m_buffer_filling.store(m_wait_for_buffer_fill.load());
+  if (m_resampler_state)
+    ResetResampler();
 }
 
 void AudioStream::CreateResampler()
@@ -305,6 +406,16 @@ void AudioStream::CreateResampler()
   m_resampler_state = src_new(SRC_SINC_MEDIUM_QUALITY, static_cast<int>(m_channels), nullptr);
   if (!m_resampler_state)
     Panic("Failed to allocate resampler");
+
+  ConfigurePolyphaseResampler();
+  m_time_stretcher.Configure(m_output_sample_rate, m_channels);
+}
+
+void AudioStream::ConfigurePolyphaseResampler()
+{
+  m_polyphase_resampler.Configure(m_channels, m_polyphase_quality);
+  if (m_input_sample_rate > 0)
+    m_polyphase_resampler.SetRates(m_input_sample_rate, m_output_sample_rate);
 }
 
 void AudioStream::DestroyResampler()
@@ -322,34 +433,48 @@ void AudioStream::ResetResampler()
   m_resample_in_buffer.clear();
   m_resample_out_buffer.clear();
   src_reset(static_cast<SRC_STATE*>(m_resampler_state));
+  m_polyphase_resampler.Reset();
+  m_time_stretcher.Reset();
+  m_stretch_fill_average = 1.0f;
 }
 
-void AudioStream::ResampleInput(std::unique_lock<std::mutex> buffer_lock)
+void AudioStream::ResampleInput()
 {
-  std::unique_lock<std::mutex> resampler_lock(m_resampler_mutex);
+  if (m_stretching.load(std::memory_order_relaxed))
+  {
+    StretchInput();
+    return;
+  }
+  else if (m_resampler_type == ResamplerType::Polyphase)
+  {
+    ProcessInput(m_polyphase_resampler);
+    return;
+  }
 
-  const u32 input_space_from_output = (m_resampled_buffer.GetSpace() * m_output_sample_rate) / m_input_sample_rate;
-  u32 remaining = std::min(m_buffer.GetSize(), input_space_from_output);
+  const u32 input_sample_rate = m_input_sample_rate.load(std::memory_order_relaxed);
+  const u32 input_space_from_output = (m_resampled_buffer.GetSpace() * m_output_sample_rate) / input_sample_rate;
+  u32 read_pos = m_read_position.load(std::memory_order_relaxed);
+  u32 remaining = std::min(m_write_position.load(std::memory_order_acquire) - read_pos, input_space_from_output);
   if (m_resample_in_buffer.size() < remaining)
   {
     remaining -= static_cast<u32>(m_resample_in_buffer.size());
     m_resample_in_buffer.reserve(m_resample_in_buffer.size() + remaining);
     while (remaining > 0)
     {
-      const u32 read_len = std::min(m_buffer.GetContiguousSize(), remaining);
+      const u32 offset = read_pos & (MaxSamples - 1);
+      const u32 read_len = std::min(MaxSamples - offset, remaining);
       const size_t old_pos = m_resample_in_buffer.size();
       m_resample_in_buffer.resize(m_resample_in_buffer.size() + read_len);
-      src_short_to_float_array(m_buffer.GetReadPointer(), m_resample_in_buffer.data() + old_pos,
-                               static_cast<int>(read_len));
-      m_buffer.Remove(read_len);
+      src_short_to_float_array(&m_buffer[offset], m_resample_in_buffer.data() + old_pos, static_cast<int>(read_len));
+      read_pos += read_len;
       remaining -= read_len;
     }
-  }
 
-  ReleaseBufferLock(std::move(buffer_lock));
+    AdvanceReadPosition(read_pos);
+  }
 
   const u32 potential_output_size =
-    (static_cast<u32>(m_resample_in_buffer.size()) * m_input_sample_rate) / m_output_sample_rate;
+    (static_cast<u32>(m_resample_in_buffer.size()) * input_sample_rate) / m_output_sample_rate;
   const u32 output_size = std::min(potential_output_size, m_resampled_buffer.GetSpace());
   m_resample_out_buffer.resize(output_size);
 
@@ -384,4 +509,46 @@ void AudioStream::ResampleInput(std::unique_lock<std::mutex> buffer_lock)
   }
   m_resample_out_buffer.erase(m_resample_out_buffer.begin(),
                               m_resample_out_buffer.begin() + (static_cast<u32>(sd.output_frames_gen) * m_channels));
-}
\ No newline at end of file
+}
+
+void AudioStream::StretchInput()
+{
+  // The emulator produces at roughly the tempo already, so nudge it slightly to keep the ring around one buffer full.
+  // This absorbs drift and jitter which would otherwise under/overflow the buffer.
+  static constexpr float FILL_SMOOTHING = 0.1f;
+  static constexpr float MIN_TEMPO_ADJUSTMENT = 0.8f;
+  static constexpr float MAX_TEMPO_ADJUSTMENT = 1.25f;
+  const float fill = static_cast<float>(GetBufferedSamples() / m_channels) / static_cast<float>(m_buffer_size);
+  m_stretch_fill_average += (fill - m_stretch_fill_average) * FILL_SMOOTHING;
+  m_time_stretcher.SetTempo(
+    m_stretch_tempo *
+    std::clamp(0.5f + (0.5f * m_stretch_fill_average), MIN_TEMPO_ADJUSTMENT, MAX_TEMPO_ADJUSTMENT));
+
+  ProcessInput(m_time_stretcher);
+}
+
+template<typename T>
+void AudioStream::ProcessInput(T& processor)
+{
+  // Reads straight out of the ring and writes straight into the resampled buffer, no intermediate copies.
+  u32 read_pos = m_read_position.load(std::memory_order_relaxed);
+  u32 available = (m_write_position.load(std::memory_order_acquire) - read_pos) / m_channels;
+  while (m_resampled_buffer.GetSpace() > 0)
+  {
+    const u32 offset = read_pos & (MaxSamples - 1);
+    const u32 in_frames = std::min(available, (MaxSamples - offset) / m_channels);
+    const u32 out_frames = m_resampled_buffer.GetContiguousSpace() / m_channels;
+    u32 in_frames_used, out_frames_generated;
+    if (!processor.Process(&m_buffer[offset], in_frames, m_resampled_buffer.GetWritePointer(), out_frames,
+                           &in_frames_used, &out_frames_generated))
+    {
+      break;
+    }
+
+    read_pos += in_frames_used * m_channels;
+    available -= in_frames_used;
+    m_resampled_buffer.AdvanceTail(out_frames_generated * m_channels);
+  }
+
+  AdvanceReadPosition(read_pos);
+}
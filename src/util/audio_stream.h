@@ -1,8 +1,10 @@
 #pragma once
+#include "common/event.h"
 #include "common/fifo_queue.h"
 #include "common/types.h"
+#include "polyphase_resampler.h"
+#include "time_stretcher.h"
 #include <atomic>
-#include <condition_variable>
 #include <memory>
 #include <mutex>
 #include <vector>
@@ -23,6 +25,12 @@ public:
     FullVolume = 100
   };
 
+  enum class ResamplerType : u8
+  {
+    LibSampleRate,
+    Polyphase
+  };
+
   AudioStream();
   virtual ~AudioStream();
 
@@ -37,6 +45,12 @@ public:
   void SetSync(bool enable) { m_sync = enable; }
 
   void SetInputSampleRate(u32 sample_rate);
+  void SetResampler(ResamplerType type, PolyphaseResampler::Quality polyphase_quality);
+
+  /// Changes the tempo of the audio without changing its pitch. Used instead of resampling when the emulator isn't
+  /// running at 100% speed. A tempo of 1.0 disables stretching.
+  void SetStretchTempo(float tempo);
+  bool IsStretching() const { return m_stretching.load(std::memory_order_relaxed); }
   void SetWaitForBufferFill(bool enabled);
 
   virtual void SetOutputVolume(u32 volume);
@@ -50,12 +64,21 @@ public:
   void WriteFrames(const SampleType* frames, u32 num_frames);
   void EndWrite(u32 num_frames);
 
+  /// Returns true if the output device ran out of samples since the last call. Only call from the emulation thread.
   bool DidUnderflow()
   {
-    bool expected = true;
-    return m_underflow_flag.compare_exchange_strong(expected, false);
+    const u32 count = m_underflow_count.load(std::memory_order_relaxed);
+    if (count == m_last_underflow_count)
+      return false;
+
+    m_last_underflow_count = count;
+    return true;
   }
 
+  /// Number of times the output device ran out of samples, and the number of writes dropped because the buffer was full.
+  u32 GetUnderflowCount() const { return m_underflow_count.load(std::memory_order_relaxed); }
+  u32 GetOverflowCount() const { return m_overflow_count.load(std::memory_order_relaxed); }
+
   static std::unique_ptr<AudioStream> CreateNullAudioStream();
 
   // Latency computation - returns values in seconds
@@ -72,53 +95,85 @@ protected:
     return s16((s32(sample) * s32(volume)) / 100);
   }
 
-  ALWAYS_INLINE u32 GetBufferSpace() const { return (m_max_samples - m_buffer.GetSize()); }
-  ALWAYS_INLINE void ReleaseBufferLock(std::unique_lock<std::mutex> lock)
+  ALWAYS_INLINE u32 GetBufferedSamples() const
   {
-    // lock is released implicitly by destruction
-    m_buffer_draining_cv.notify_one();
+    return (m_write_position.load(std::memory_order_acquire) - m_read_position.load(std::memory_order_acquire));
   }
+  ALWAYS_INLINE u32 GetBufferSpace() const { return (m_max_samples - GetBufferedSamples()); }
 
   bool SetBufferSize(u32 buffer_size);
   bool IsDeviceOpen() const { return (m_output_sample_rate > 0); }
 
-  void EnsureBuffer(u32 size);
-  void LockedEmptyBuffers();
+  bool EnsureBuffer(u32 size);
+  void ResetBuffers();
   u32 GetSamplesAvailable() const;
-  u32 GetSamplesAvailableLocked() const;
   void ReadFrames(SampleType* samples, u32 num_frames, bool apply_volume);
   void DropFrames(u32 count);
 
+  // Consumer side of the sample ring, called from the output device's thread.
+  void HandleDiscardRequest();
+  u32 PopSamples(SampleType* samples, u32 count);
+  void AdvanceReadPosition(u32 new_read_position);
+
   void CreateResampler();
   void DestroyResampler();
   void ResetResampler();
+  void ConfigurePolyphaseResampler();
   void InternalSetInputSampleRate(u32 sample_rate);
-  void ResampleInput(std::unique_lock<std::mutex> buffer_lock);
+  void ResampleInput();
+  void StretchInput();
+  template<typename T>
+  void ProcessInput(T& processor);
 
-  u32 m_input_sample_rate = 0;
+  std::atomic<u32> m_input_sample_rate{0};
   u32 m_output_sample_rate = 0;
   u32 m_channels = 0;
   u32 m_buffer_size = 0;
 
   // volume, 0-100
-  u32 m_output_volume = FullVolume;
+  std::atomic<u32> m_output_volume{FullVolume};
+
+  // Single-producer single-consumer sample ring. Only the emulation thread advances the write position, and only the
+  // output device's callback advances the read position, so neither side locks. Positions are free-running, and
+  // wrapped to the ring with (MaxSamples - 1). Each sits on its own cache line so the two threads don't share one.
+  std::unique_ptr<SampleType[]> m_buffer;
+  alignas(64) std::atomic<u32> m_write_position{0};
+  alignas(64) std::atomic<u32> m_read_position{0};
+
+  // Set by the producer while it is blocked waiting for the consumer to free up space.
+  alignas(64) std::atomic_bool m_write_waiting{false};
+  Common::Event m_buffer_draining_event{true};
+
+  // EmptyBuffers() can't move the read position itself while the device is running, so it asks the consumer to.
+  std::atomic<u32> m_discard_position{0};
+  std::atomic_bool m_discard_requested{false};
 
-  HeapFIFOQueue<SampleType, MaxSamples> m_buffer;
-  mutable std::mutex m_buffer_mutex;
-  std::condition_variable m_buffer_draining_cv;
   std::vector<SampleType> m_resample_buffer;
+  std::vector<SampleType> m_overflow_buffer;
+  bool m_writing_to_overflow_buffer = false;
 
-  std::atomic_bool m_underflow_flag{false};
+  std::atomic<u32> m_underflow_count{0};
+  std::atomic<u32> m_overflow_count{0};
+  u32 m_last_underflow_count = 0;
   std::atomic_bool m_buffer_filling{false};
   u32 m_max_samples = 0;
 
   bool m_output_paused = true;
   bool m_sync = true;
-  bool m_wait_for_buffer_fill = false;
+  std::atomic_bool m_wait_for_buffer_fill{false};
 
   // Resampling
   double m_resampler_ratio = 1.0;
   void* m_resampler_state = nullptr;
+  ResamplerType m_resampler_type = ResamplerType::LibSampleRate;
+  PolyphaseResampler::Quality m_polyphase_quality = PolyphaseResampler::Quality::Medium;
+  PolyphaseResampler m_polyphase_resampler;
+
+  // Time stretching, which replaces resampling when enabled.
+  TimeStretcher m_time_stretcher;
+  float m_stretch_tempo = 1.0f;
+  float m_stretch_fill_average = 1.0f;
+  std::atomic_bool m_stretching{false};
   std::mutex m_resampler_mutex;
   HeapFIFOQueue<SampleType, MaxSamples> m_resampled_buffer;
   std::vector<float> m_resample_in_buffer;
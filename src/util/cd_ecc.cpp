@@ -0,0 +1,267 @@
+#include "cd_ecc.h"
+#include "cd_image.h"
+#include "common/assert.h"
+#include <array>
+#include <cstring>
+
+// unecm.c by Neill Corlett (c) 2002, GPL licensed
+
+/* LUTs used for computing ECC/EDC */
+
+static constexpr std::array<u8, 256> ComputeECCFLUT()
+{
+  std::array<u8, 256> ecc_lut{};
+  for (u32 i = 0; i < 256; i++)
+  {
+    u32 j = (i << 1) ^ (i & 0x80 ? 0x11D : 0);
+    ecc_lut[i] = static_cast<u8>(j);
+  }
+  return ecc_lut;
+}
+
+static constexpr std::array<u8, 256> ComputeECCBLUT()
+{
+  std::array<u8, 256> ecc_lut{};
+  for (u32 i = 0; i < 256; i++)
+  {
+    u32 j = (i << 1) ^ (i & 0x80 ? 0x11D : 0);
+    ecc_lut[i ^ j] = static_cast<u8>(i);
+  }
+  return ecc_lut;
+}
+
+// EDC is a CRC, so it's computed 8 bytes at a time with slicing tables instead of one byte at a time.
+static constexpr u32 EDC_SLICES = 8;
+
+static constexpr std::array<std::array<u32, 256>, EDC_SLICES> ComputeEDCLUT()
+{
+  std::array<std::array<u32, 256>, EDC_SLICES> edc_lut{};
+  for (u32 i = 0; i < 256; i++)
+  {
+    u32 edc = i;
+    for (u32 k = 0; k < 8; k++)
+      edc = (edc >> 1) ^ (edc & 1 ? 0xD8018001 : 0);
+    edc_lut[0][i] = edc;
+  }
+  for (u32 slice = 1; slice < EDC_SLICES; slice++)
+  {
+    for (u32 i = 0; i < 256; i++)
+      edc_lut[slice][i] = (edc_lut[slice - 1][i] >> 8) ^ edc_lut[0][edc_lut[slice - 1][i] & 0xFF];
+  }
+  return edc_lut;
+}
+
+static constexpr std::array<u8, 256> ecc_f_lut = ComputeECCFLUT();
+static constexpr std::array<u8, 256> ecc_b_lut = ComputeECCBLUT();
+static constexpr std::array<std::array<u32, 256>, EDC_SLICES> edc_lut = ComputeEDCLUT();
+
+/***************************************************************************/
+/*
+** Compute EDC for a block
+*/
+static u32 edc_partial_computeblock(u32 edc, const u8* src, u16 size)
+{
+  while (size >= EDC_SLICES)
+  {
+    // the register is little endian, so the first byte goes in the low bits
+    const u32 lo = edc ^ (src[0] | (src[1] << 8) | (src[2] << 16) | (static_cast<u32>(src[3]) << 24));
+    const u32 hi = src[4] | (src[5] << 8) | (src[6] << 16) | (static_cast<u32>(src[7]) << 24);
+    edc = edc_lut[7][lo & 0xFF] ^ edc_lut[6][(lo >> 8) & 0xFF] ^ edc_lut[5][(lo >> 16) & 0xFF] ^ edc_lut[4][lo >> 24] ^
+          edc_lut[3][hi & 0xFF] ^ edc_lut[2][(hi >> 8) & 0xFF] ^ edc_lut[1][(hi >> 16) & 0xFF] ^ edc_lut[0][hi >> 24];
+    src += EDC_SLICES;
+    size -= EDC_SLICES;
+  }
+  while (size--)
+    edc = (edc >> 8) ^ edc_lut[0][(edc ^ (*src++)) & 0xFF];
+  return edc;
+}
+
+static void edc_computeblock(const u8* src, u16 size, u8* dest)
+{
+  u32 edc = edc_partial_computeblock(0, src, size);
+  dest[0] = (edc >> 0) & 0xFF;
+  dest[1] = (edc >> 8) & 0xFF;
+  dest[2] = (edc >> 16) & 0xFF;
+  dest[3] = (edc >> 24) & 0xFF;
+}
+
+/***************************************************************************/
+/*
+** Compute ECC for a block (can do either P or Q)
+*/
+// Multiplies each byte by alpha in GF(2^8), i.e. ecc_f_lut for eight bytes at once.
+static u64 ecc_multiply_alpha(u64 value)
+{
+  const u64 high_bits = value & UINT64_C(0x8080808080808080);
+  return ((value & UINT64_C(0x7F7F7F7F7F7F7F7F)) << 1) ^ ((high_bits >> 7) * 0x1D);
+}
+
+static u16 ecc_read_pair(const u8* src)
+{
+  u16 value;
+  std::memcpy(&value, src, sizeof(value));
+  return value;
+}
+
+static void ecc_computeblock(u8* src, u32 major_count, u32 minor_count, u32 major_mult, u32 minor_inc, u8* dest)
+{
+  // Majors are computed eight at a time, one per byte of a 64-bit word. Each even/odd pair of majors reads adjacent
+  // bytes, which never straddle the end of the block since the indices are always even.
+  static constexpr u32 MAX_SIZE = 52 * 43;
+  static constexpr u32 MAX_COPIES = 3;
+  static constexpr u32 MAX_GROUP_COUNT = (86 + 7) / 8;
+  u32 size = major_count * minor_count;
+  u32 pair_count = major_count / 2;
+  u32 major, minor, pair, group;
+
+  // Q wraps around the end of the block, reading consecutive copies of it is cheaper than wrapping every index.
+  u8 wrapped_src[MAX_SIZE * MAX_COPIES];
+  const u8* data = src;
+  const u32 last_index = (pair_count - 1) * major_mult + (minor_count - 1) * minor_inc + 1;
+  if (last_index >= size)
+  {
+    const u32 copies = last_index / size + 1;
+    DebugAssert(size <= MAX_SIZE && copies <= MAX_COPIES);
+    for (u32 i = 0; i < copies; i++)
+      std::memcpy(&wrapped_src[i * size], src, size);
+    data = wrapped_src;
+  }
+
+  // the last word is padded with pairs which aren't used
+  const u32 group_count = (pair_count + 3) / 4;
+  u32 pair_offset[MAX_GROUP_COUNT * 4];
+  for (pair = 0; pair < group_count * 4; pair++)
+    pair_offset[pair] = (pair < pair_count) ? (pair * major_mult) : 0;
+
+  // minors are the outer loop so the words don't depend on each other, the multiplies are too slow back to back
+  u64 ecc_a[MAX_GROUP_COUNT] = {};
+  u64 ecc_b[MAX_GROUP_COUNT] = {};
+  for (minor = 0; minor < minor_count; minor++)
+  {
+    const u8* row = data + minor * minor_inc;
+    for (group = 0; group < group_count; group++)
+    {
+      const u32* group_offset = &pair_offset[group * 4];
+      const u64 temp = static_cast<u64>(ecc_read_pair(row + group_offset[0])) |
+                       (static_cast<u64>(ecc_read_pair(row + group_offset[1])) << 16) |
+                       (static_cast<u64>(ecc_read_pair(row + group_offset[2])) << 32) |
+                       (static_cast<u64>(ecc_read_pair(row + group_offset[3])) << 48);
+      ecc_a[group] = ecc_multiply_alpha(ecc_a[group] ^ temp);
+      ecc_b[group] ^= temp;
+    }
+  }
+
+  for (major = 0; major < major_count; major++)
+  {
+    u8 a = static_cast<u8>(ecc_a[major / 8] >> ((major % 8) * 8));
+    u8 b = static_cast<u8>(ecc_b[major / 8] >> ((major % 8) * 8));
+    a = ecc_b_lut[ecc_f_lut[a] ^ b];
+    dest[major] = a;
+    dest[major + major_count] = a ^ b;
+  }
+}
+
+/*
+** Generate ECC P and Q codes for a block
+*/
+static void ecc_generate(u8* sector, int zeroaddress)
+{
+  u8 address[4], i;
+  /* Save the address and zero it out */
+  if (zeroaddress)
+    for (i = 0; i < 4; i++)
+    {
+      address[i] = sector[12 + i];
+      sector[12 + i] = 0;
+    }
+  /* Compute ECC P code */
+  ecc_computeblock(sector + 0xC, 86, 24, 2, 86, sector + 0x81C);
+  /* Compute ECC Q code */
+  ecc_computeblock(sector + 0xC, 52, 43, 86, 88, sector + 0x8C8);
+  /* Restore the address */
+  if (zeroaddress)
+    for (i = 0; i < 4; i++)
+      sector[12 + i] = address[i];
+}
+
+/***************************************************************************/
+
+// Offset of the first EDC/ECC byte, everything from there to the end of the sector is generated.
+static u32 GetEDCECCOffset(CDECC::SectorType type)
+{
+  switch (type)
+  {
+    case CDECC::SectorType::Mode1:
+      return 0x810;
+    case CDECC::SectorType::Mode2Form1:
+      return 0x818;
+    case CDECC::SectorType::Mode2Form2:
+    default:
+      return 0x92C;
+  }
+}
+
+bool CDECC::GetSectorType(const u8* sector, SectorType* type)
+{
+  static constexpr u8 sync[CDImage::SECTOR_SYNC_SIZE] = {0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+                                                         0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00};
+  if (std::memcmp(sector, sync, sizeof(sync)) != 0)
+    return false;
+
+  switch (sector[0x0F])
+  {
+    case 0x01:
+      *type = SectorType::Mode1;
+      return true;
+
+    case 0x02:
+      // form 2 is bit 5 of the submode
+      *type = (sector[0x12] & 0x20) ? SectorType::Mode2Form2 : SectorType::Mode2Form1;
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+void CDECC::GenerateEDCECC(u8* sector, SectorType type)
+{
+  switch (type)
+  {
+    case SectorType::Mode1:
+      /* Compute EDC */
+      edc_computeblock(sector + 0x00, 0x810, sector + 0x810);
+      /* Write out zero bytes */
+      for (u32 i = 0; i < 8; i++)
+        sector[0x814 + i] = 0;
+      /* Generate ECC P/Q codes */
+      ecc_generate(sector, 0);
+      break;
+    case SectorType::Mode2Form1:
+      /* Compute EDC */
+      edc_computeblock(sector + 0x10, 0x808, sector + 0x818);
+      /* Generate ECC P/Q codes */
+      ecc_generate(sector, 1);
+      break;
+    case SectorType::Mode2Form2:
+      /* Compute EDC */
+      edc_computeblock(sector + 0x10, 0x91C, sector + 0x92C);
+      break;
+  }
+}
+
+void CDECC::ClearEDCECC(u8* sector, SectorType type)
+{
+  const u32 offset = GetEDCECCOffset(type);
+  std::memset(sector + offset, 0, CDImage::RAW_SECTOR_SIZE - offset);
+}
+
+bool CDECC::IsEDCECCRegenerable(const u8* sector, SectorType type)
+{
+  std::array<u8, CDImage::RAW_SECTOR_SIZE> generated;
+  std::memcpy(generated.data(), sector, CDImage::RAW_SECTOR_SIZE);
+  GenerateEDCECC(generated.data(), type);
+
+  const u32 offset = GetEDCECCOffset(type);
+  return (std::memcmp(generated.data() + offset, sector + offset, CDImage::RAW_SECTOR_SIZE - offset) == 0);
+}
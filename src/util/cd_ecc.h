@@ -0,0 +1,28 @@
+#pragma once
+#include "common/types.h"
+
+// EDC/ECC of raw CD-ROM data sectors. Both only depend on the rest of the sector, so images can drop them and
+// regenerate them when the sector is read.
+namespace CDECC {
+
+enum class SectorType : u8
+{
+  Mode1,      // EDC over the sync, header and data, followed by P/Q ECC.
+  Mode2Form1, // EDC over the subheader and data, followed by P/Q ECC computed with a zero header.
+  Mode2Form2  // EDC over the subheader and data, no ECC.
+};
+
+/// Determines the type of a raw sector from its sync pattern, header and subheader. Returns false for audio sectors and
+/// anything else which doesn't have EDC/ECC.
+bool GetSectorType(const u8* sector, SectorType* type);
+
+/// Writes the EDC/ECC for a raw sector, i.e. every byte that ClearEDCECC() zeroes.
+void GenerateEDCECC(u8* sector, SectorType type);
+
+/// Zeroes the EDC/ECC of a raw sector.
+void ClearEDCECC(u8* sector, SectorType type);
+
+/// Returns true if the sector's EDC/ECC is exactly what GenerateEDCECC() would write, so it doesn't need to be stored.
+bool IsEDCECCRegenerable(const u8* sector, SectorType type);
+
+} // namespace CDECC
@@ -1,4 +1,5 @@
 #include "cd_image.h"
+#include "cd_sector_cache.h"
 #include "common/assert.h"
 #include "common/file_system.h"
 #include "common/log.h"
@@ -7,9 +8,12 @@
 #include <array>
 Log_SetChannel(CDImage);
 
-CDImage::CDImage() = default;
+CDImage::CDImage() : m_sector_cache_id(CDSectorCache::AllocateImageId()) {}
 
-CDImage::~CDImage() = default;
+CDImage::~CDImage()
+{
+  CDSectorCache::RemoveImage(m_sector_cache_id);
+}
 
 u32 CDImage::GetBytesPerSector(TrackMode mode)
 {
@@ -50,6 +54,10 @@ std::unique_ptr<CDImage> CDImage::Open(const char* filename, Common::Error* erro
   {
     return OpenCHDImage(filename, error);
   }
+  else if (StringUtil::Strcasecmp(extension, ".dci") == 0)
+  {
+    return OpenDCIImage(filename, error);
+  }
   else if (StringUtil::Strcasecmp(extension, ".ecm") == 0)
   {
     return OpenEcmImage(filename, error);
@@ -237,38 +245,47 @@ bool CDImage::ReadRawSector(void* buffer, SubChannelQ* subq)
       return false;
   }
 
-  if (buffer)
+  // sectors which are cached don't need to be read or decompressed again
+  const bool use_cache = (m_use_sector_cache && m_current_index->file_sector_size > 0 && CDSectorCache::IsEnabled());
+  const u32 sub_image = use_cache ? GetCurrentSubImage() : 0;
+  if (!use_cache || !CDSectorCache::Lookup(m_sector_cache_id, sub_image, m_position_on_disc, buffer, subq))
   {
-    if (m_current_index->file_sector_size > 0)
+    if (buffer)
     {
-      // TODO: This is where we'd reconstruct the header for other mode tracks.
-      if (!ReadSectorFromIndex(buffer, *m_current_index, m_position_in_index))
+      if (m_current_index->file_sector_size > 0)
       {
-        Log_ErrorPrintf("Read of LBA %u failed", m_position_on_disc);
-        Seek(m_position_on_disc);
-        return false;
-      }
-    }
-    else
-    {
-      if (m_current_index->track_number == LEAD_OUT_TRACK_NUMBER)
-      {
-        // Lead-out area.
-        std::fill(static_cast<u8*>(buffer), static_cast<u8*>(buffer) + RAW_SECTOR_SIZE, u8(0xAA));
+        // TODO: This is where we'd reconstruct the header for other mode tracks.
+        if (!ReadSectorFromIndex(buffer, *m_current_index, m_position_in_index))
+        {
+          Log_ErrorPrintf("Read of LBA %u failed", m_position_on_disc);
+          Seek(m_position_on_disc);
+          return false;
+        }
       }
       else
       {
-        // This in an implicit pregap. Return silence.
-        std::fill(static_cast<u8*>(buffer), static_cast<u8*>(buffer) + RAW_SECTOR_SIZE, u8(0));
+        if (m_current_index->track_number == LEAD_OUT_TRACK_NUMBER)
+        {
+          // Lead-out area.
+          std::fill(static_cast<u8*>(buffer), static_cast<u8*>(buffer) + RAW_SECTOR_SIZE, u8(0xAA));
+        }
+        else
+        {
+          // This in an implicit pregap. Return silence.
+          std::fill(static_cast<u8*>(buffer), static_cast<u8*>(buffer) + RAW_SECTOR_SIZE, u8(0));
+        }
       }
     }
-  }
 
-  if (subq && !ReadSubChannelQ(subq, *m_current_index, m_position_in_index))
-  {
-    Log_ErrorPrintf("Subchannel read of LBA %u failed", m_position_on_disc);
-    Seek(m_position_on_disc);
-    return false;
+    if (subq && !ReadSubChannelQ(subq, *m_current_index, m_position_in_index))
+    {
+      Log_ErrorPrintf("Subchannel read of LBA %u failed", m_position_on_disc);
+      Seek(m_position_on_disc);
+      return false;
+    }
+
+    if (use_cache)
+      CDSectorCache::Insert(m_sector_cache_id, sub_image, m_position_on_disc, buffer, subq);
   }
 
   m_position_on_disc++;
@@ -277,6 +294,16 @@ bool CDImage::ReadRawSector(void* buffer, SubChannelQ* subq)
   return true;
 }
 
+void CDImage::PinSectorCacheRange(LBA start_lba, u32 count) const
+{
+  CDSectorCache::PinRange(m_sector_cache_id, GetCurrentSubImage(), start_lba, count);
+}
+
+void CDImage::UnpinSectorCacheRange(LBA start_lba, u32 count) const
+{
+  CDSectorCache::UnpinRange(m_sector_cache_id, GetCurrentSubImage(), start_lba, count);
+}
+
 bool CDImage::ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index)
 {
   GenerateSubChannelQ(subq, index, lba_in_index);
@@ -216,11 +216,34 @@ public:
   /// Returns true if the specified filename is a CD-ROM device name.
   static bool IsDeviceName(const char* filename);
 
+  /// Sets how many decompressed blocks (CHD hunks, PBP blocks) compressed images keep in memory, and how many blocks past
+  /// sequential reads are decompressed in the background. Only applies to images opened after the call.
+  static void SetBlockCacheParameters(u32 cache_blocks, u32 prefetch_blocks);
+
+  struct SectorCacheStats
+  {
+    u64 hits;
+    u64 misses;
+    u64 evictions;
+    u64 memory_used;
+    u64 memory_budget;
+    u32 sector_count;
+    u32 pinned_sector_count;
+  };
+
+  /// Sets how much memory the sector cache, which is shared by every open image, can use. Zero disables it. Shrinking
+  /// the budget evicts sectors straight away.
+  static void SetSectorCacheBudget(u64 bytes);
+
+  /// Returns the hit/miss counts of the sector cache, and how much of its budget is in use.
+  static SectorCacheStats GetSectorCacheStats();
+
   // Opening disc image.
   static std::unique_ptr<CDImage> Open(const char* filename, Common::Error* error);
   static std::unique_ptr<CDImage> OpenBinImage(const char* filename, Common::Error* error);
   static std::unique_ptr<CDImage> OpenCueSheetImage(const char* filename, Common::Error* error);
   static std::unique_ptr<CDImage> OpenCHDImage(const char* filename, Common::Error* error);
+  static std::unique_ptr<CDImage> OpenDCIImage(const char* filename, Common::Error* error);
   static std::unique_ptr<CDImage> OpenEcmImage(const char* filename, Common::Error* error);
   static std::unique_ptr<CDImage> OpenMdsImage(const char* filename, Common::Error* error);
   static std::unique_ptr<CDImage> OpenPBPImage(const char* filename, Common::Error* error);
@@ -231,8 +254,14 @@ public:
   static std::unique_ptr<CDImage> OverlayPPFPatch(const char* filename, std::unique_ptr<CDImage> parent_image,
                                                   ProgressCallback* progress = ProgressCallback::NullProgressCallback);
 
+  /// Converts an image to DCI, which compresses small frames of sectors independently so they can be read in any order.
+  /// Identical sectors are only stored once. Frames use LZMA if use_lzma is set, otherwise deflate.
+  static bool WriteDCIImage(CDImage* image, const char* filename, u32 sectors_per_frame, bool use_lzma,
+                            ProgressCallback* progress, Common::Error* error);
+
   // Accessors.
   const std::string& GetFileName() const { return m_filename; }
+  const std::string& GetPatchFileName() const { return m_patch_filename; }
   LBA GetPositionOnDisc() const { return m_position_on_disc; }
   Position GetMSFPositionOnDisc() const { return Position::FromLBA(m_position_on_disc); }
   LBA GetPositionInTrack() const { return m_position_in_track; }
@@ -274,6 +303,15 @@ public:
   // Read a single raw sector, and subchannel from the current LBA.
   bool ReadRawSector(void* buffer, SubChannelQ* subq);
 
+  // Keeps sectors in the range of the current sub-image in the sector cache once they've been read, e.g. while
+  // streaming an FMV.
+  void PinSectorCacheRange(LBA start_lba, u32 count) const;
+  void UnpinSectorCacheRange(LBA start_lba, u32 count) const;
+
+  // Readers which go through the image once (scanning, hashing, verifying) turn this off, so they don't evict the
+  // sectors of images which are being played.
+  void SetSectorCacheEnabled(bool enabled) { m_use_sector_cache = enabled; }
+
   // Reads sub-channel Q for the specified index+LBA.
   virtual bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index);
 
@@ -302,6 +340,7 @@ public:
   virtual std::string GetSubImageMetadata(u32 index, const std::string_view& type) const;
 
   // Returns true if the source supports precaching, which may be more optimal than an in-memory copy.
+  // Compressed formats decompress in the background and return straight away, reads are served as blocks complete.
   virtual PrecacheResult Precache(ProgressCallback* progress = ProgressCallback::NullProgressCallback);
 
 protected:
@@ -321,12 +360,21 @@ protected:
   void AddLeadOutIndex();
 
   std::string m_filename;
+
+  // Patch applied on top of the contents of m_filename, e.g. a PPF. Empty for unmodified images.
+  std::string m_patch_filename;
+
   u32 m_lba_count = 0;
 
   std::vector<Track> m_tracks;
   std::vector<Index> m_indices;
 
+  // Images which are already in memory don't benefit from the sector cache.
+  bool m_use_sector_cache = true;
+
 private:
+  u32 m_sector_cache_id;
+
   // Position on disc.
   LBA m_position_on_disc = 0;
 
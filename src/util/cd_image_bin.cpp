@@ -3,6 +3,7 @@
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "mapped_file.h"
 #include <cerrno>
 Log_SetChannel(CDImageBin);
 
@@ -16,6 +17,7 @@ public:
 
   bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index) override;
   bool HasNonStandardSubchannel() const override;
+  PrecacheResult Precache(ProgressCallback* progress) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -23,6 +25,7 @@ protected:
 private:
   std::FILE* m_fp = nullptr;
   u64 m_file_position = 0;
+  MappedFile m_mapping;
 
   CDSubChannelReplacement m_sbi;
 };
@@ -56,6 +59,10 @@ bool CDImageBin::Open(const char* filename, Common::Error* error)
 
   m_lba_count = file_size / track_sector_size;
 
+  // falls back to stdio if the file can't be mapped, e.g. out of address space on 32-bit
+  if (!m_mapping.Map(m_fp))
+    Log_WarningPrintf("Failed to map '%s', reading through stdio instead", filename);
+
   SubChannelQ::Control control = {};
   TrackMode mode = TrackMode::Mode2Raw;
   control.data = mode != TrackMode::Audio;
@@ -112,9 +119,22 @@ bool CDImageBin::HasNonStandardSubchannel() const
   return (m_sbi.GetReplacementSectorCount() > 0);
 }
 
+CDImage::PrecacheResult CDImageBin::Precache(ProgressCallback* progress)
+{
+  if (!m_mapping.IsValid())
+    return CDImage::PrecacheResult::Unsupported;
+
+  const std::string_view title(FileSystem::GetDisplayNameFromPath(m_filename));
+  progress->SetFormattedStatusText("Precaching %.*s...", static_cast<int>(title.size()), title.data());
+  return m_mapping.TouchAllPages(progress) ? CDImage::PrecacheResult::Success : CDImage::PrecacheResult::ReadError;
+}
+
 bool CDImageBin::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
   const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  if (m_mapping.IsValid())
+    return m_mapping.Read(buffer, file_position, index.file_sector_size);
+
   if (m_file_position != file_position)
   {
     if (std::fseek(m_fp, static_cast<long>(file_position), SEEK_SET) != 0)
@@ -4,6 +4,7 @@
 
 #include "cd_image.h"
 #include "cd_subchannel_replacement.h"
+#include "compressed_block_cache.h"
 #include "common/align.h"
 #include "common/assert.h"
 #include "common/error.h"
@@ -17,6 +18,7 @@
 #include <cstring>
 #include <limits>
 #include <map>
+#include <mutex>
 #include <optional>
 Log_SetChannel(CDImageCHD);
 
@@ -64,16 +66,30 @@ private:
     CHD_CD_TRACK_ALIGNMENT = 4
   };
 
+  // libchdr handles carry their decompression state, so each prefetch worker needs its own.
+  struct PrefetchHandle
+  {
+    std::FILE* fp;
+    chd_file* chd;
+  };
+
   bool ReadHunk(u32 hunk_index);
+  bool PrefetchHunk(u32 hunk_index, u8* dst);
+  bool OpenPrefetchHandle(PrefetchHandle* handle);
 
   std::FILE* m_fp = nullptr;
   chd_file* m_chd = nullptr;
   u32 m_hunk_size = 0;
+  u32 m_hunk_count = 0;
   u32 m_sectors_per_hunk = 0;
 
   std::vector<u8> m_hunk_buffer;
   u32 m_current_hunk_index = static_cast<u32>(-1);
 
+  CompressedBlockCache m_hunk_cache;
+  std::mutex m_prefetch_handles_mutex;
+  std::vector<PrefetchHandle> m_prefetch_handles;
+
   CDSubChannelReplacement m_sbi;
 };
 
@@ -81,6 +97,14 @@ CDImageCHD::CDImageCHD() = default;
 
 CDImageCHD::~CDImageCHD()
 {
+  // drain any outstanding prefetches before their handles go away
+  m_hunk_cache.Clear();
+  for (const PrefetchHandle& handle : m_prefetch_handles)
+  {
+    chd_close(handle.chd);
+    std::fclose(handle.fp);
+  }
+
   if (m_chd)
     chd_close(m_chd);
   if (m_fp)
@@ -121,9 +145,12 @@ bool CDImageCHD::Open(const char* filename, Common::Error* error)
     return false;
   }
 
+  m_hunk_count = header->totalhunks;
   m_sectors_per_hunk = m_hunk_size / CHD_CD_SECTOR_DATA_SIZE;
   m_hunk_buffer.resize(m_hunk_size);
   m_filename = filename;
+  m_hunk_cache.Initialize(m_hunk_size, m_hunk_count,
+                         [this](u32 hunk_index, u8* dst) { return PrefetchHunk(hunk_index, dst); });
 
   u32 disc_lba = 0;
   u64 file_lba = 0;
@@ -303,16 +330,18 @@ bool CDImageCHD::HasNonStandardSubchannel() const
 
 CDImage::PrecacheResult CDImageCHD::Precache(ProgressCallback* progress)
 {
+  // hunks are decompressed in the background on their own handles, so the disc can be read in the meantime
+  if (!m_hunk_cache.StartPrecache())
+    return CDImage::PrecacheResult::ReadError;
+
+  // the callback can only be used from this thread, so with a progress bar to show, wait for the workers here
+  if (progress == ProgressCallback::NullProgressCallback)
+    return CDImage::PrecacheResult::Success;
+
   const std::string_view title(FileSystem::GetDisplayNameFromPath(m_filename));
   progress->SetFormattedStatusText("Precaching %.*s...", static_cast<int>(title.size()), title.data());
-  progress->SetProgressRange(100);
-
-  auto callback = [](size_t pos, size_t total, void* param) {
-    const u32 percent = static_cast<u32>((pos * 100) / total);
-    static_cast<ProgressCallback*>(param)->SetProgressValue(std::min<u32>(percent, 100));
-  };
-  return (chd_precache_progress(m_chd, callback, progress) == CHDERR_NONE) ? CDImage::PrecacheResult::Success :
-                                                                             CDImage::PrecacheResult::ReadError;
+  return m_hunk_cache.WaitForPrecache(progress) ? CDImage::PrecacheResult::Success :
+                                                  CDImage::PrecacheResult::ReadError;
 }
 
 // There's probably a more efficient way of doing this with vectorization...
@@ -376,6 +405,12 @@ bool CDImageCHD::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
 
 bool CDImageCHD::ReadHunk(u32 hunk_index)
 {
+  if (m_hunk_cache.IsEnabled() && m_hunk_cache.Lookup(hunk_index, m_hunk_buffer.data()))
+  {
+    m_current_hunk_index = hunk_index;
+    return true;
+  }
+
   const chd_error err = chd_read(m_chd, hunk_index, m_hunk_buffer.data());
   if (err != CHDERR_NONE)
   {
@@ -387,6 +422,54 @@ bool CDImageCHD::ReadHunk(u32 hunk_index)
   }
 
   m_current_hunk_index = hunk_index;
+  if (m_hunk_cache.IsEnabled())
+    m_hunk_cache.Insert(hunk_index, m_hunk_buffer.data());
+
+  return true;
+}
+
+bool CDImageCHD::PrefetchHunk(u32 hunk_index, u8* dst)
+{
+  PrefetchHandle handle = {};
+  {
+    std::unique_lock lock(m_prefetch_handles_mutex);
+    if (!m_prefetch_handles.empty())
+    {
+      handle = m_prefetch_handles.back();
+      m_prefetch_handles.pop_back();
+    }
+  }
+
+  if (!handle.chd && !OpenPrefetchHandle(&handle))
+    return false;
+
+  // errors are reported when the reader falls back to reading the hunk itself
+  const bool result = (chd_read(handle.chd, hunk_index, dst) == CHDERR_NONE);
+
+  std::unique_lock lock(m_prefetch_handles_mutex);
+  m_prefetch_handles.push_back(handle);
+  return result;
+}
+
+bool CDImageCHD::OpenPrefetchHandle(PrefetchHandle* handle)
+{
+  handle->fp = FileSystem::OpenCFile(m_filename.c_str(), "rb");
+  if (!handle->fp)
+  {
+    Log_ErrorPrintf("Failed to reopen CHD '%s' for prefetching: errno %d", m_filename.c_str(), errno);
+    return false;
+  }
+
+  const chd_error err = chd_open_file(handle->fp, CHD_OPEN_READ, nullptr, &handle->chd);
+  if (err != CHDERR_NONE)
+  {
+    Log_ErrorPrintf("Failed to reopen CHD '%s' for prefetching: %s", m_filename.c_str(), chd_error_string(err));
+    std::fclose(handle->fp);
+    handle->fp = nullptr;
+    handle->chd = nullptr;
+    return false;
+  }
+
   return true;
 }
 
@@ -6,6 +6,7 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "cue_parser.h"
+#include "mapped_file.h"
 #include <algorithm>
 #include <cerrno>
 #include <cinttypes>
@@ -22,6 +23,7 @@ public:
 
   bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index) override;
   bool HasNonStandardSubchannel() const override;
+  PrecacheResult Precache(ProgressCallback* progress) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -32,6 +34,7 @@ private:
     std::string filename;
     std::FILE* file;
     u64 file_position;
+    MappedFile mapping;
   };
 
   std::vector<TrackFile> m_files;
@@ -118,7 +121,12 @@ bool CDImageCueSheet::OpenAndParse(const char* filename, Common::Error* error)
         return false;
       }
 
-      m_files.push_back(TrackFile{std::move(track_filename), track_fp, 0});
+      // falls back to stdio if the file can't be mapped, e.g. out of address space on 32-bit
+      MappedFile mapping;
+      if (!mapping.Map(track_fp))
+        Log_WarningPrintf("Failed to map '%s', reading through stdio instead", track_full_filename.c_str());
+
+      m_files.push_back(TrackFile{std::move(track_filename), track_fp, 0, std::move(mapping)});
     }
 
     // data type determines the sector size
@@ -306,12 +314,31 @@ bool CDImageCueSheet::HasNonStandardSubchannel() const
   return (m_sbi.GetReplacementSectorCount() > 0);
 }
 
+CDImage::PrecacheResult CDImageCueSheet::Precache(ProgressCallback* progress)
+{
+  if (std::any_of(m_files.begin(), m_files.end(), [](const TrackFile& t) { return !t.mapping.IsValid(); }))
+    return CDImage::PrecacheResult::Unsupported;
+
+  const std::string_view title(FileSystem::GetDisplayNameFromPath(m_filename));
+  progress->SetFormattedStatusText("Precaching %.*s...", static_cast<int>(title.size()), title.data());
+  for (TrackFile& tf : m_files)
+  {
+    if (!tf.mapping.TouchAllPages(progress))
+      return CDImage::PrecacheResult::ReadError;
+  }
+
+  return CDImage::PrecacheResult::Success;
+}
+
 bool CDImageCueSheet::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
   DebugAssert(index.file_index < m_files.size());
 
   TrackFile& tf = m_files[index.file_index];
   const u64 file_position = index.file_offset + (static_cast<u64>(lba_in_index) * index.file_sector_size);
+  if (tf.mapping.IsValid())
+    return tf.mapping.Read(buffer, file_position, index.file_sector_size);
+
   if (tf.file_position != file_position)
   {
     if (std::fseek(tf.file, static_cast<long>(file_position), SEEK_SET) != 0)
@@ -0,0 +1,892 @@
+#include "Alloc.h"
+#include "LzmaDec.h"
+#include "LzmaEnc.h"
+#include "cd_ecc.h"
+#include "cd_image.h"
+#include "cd_subchannel_replacement.h"
+#include "common/assert.h"
+#include "common/error.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/path.h"
+#include "common/thirdparty/thread_pool.h"
+#include "common/timer.h"
+#include "compressed_block_cache.h"
+#include "dci_types.h"
+#include "mapped_file.h"
+#include "xxhash.h"
+#include "zlib.h"
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cinttypes>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+Log_SetChannel(CDImageDCI);
+
+using namespace DCI;
+using FileSystem::FSeek64;
+
+static constexpr u8 FILE_MAGIC[4] = {'D', 'C', 'I', 0x1A};
+
+static bool DecompressFrame(Codec codec, const u8* src, u32 src_size, u8* dst, u32 dst_size)
+{
+  switch (codec)
+  {
+    case Codec::Stored:
+    {
+      if (src_size != dst_size)
+        return false;
+
+      std::memcpy(dst, src, dst_size);
+      return true;
+    }
+
+    case Codec::Deflate:
+    {
+      z_stream stream = {};
+      if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return false;
+
+      stream.next_in = const_cast<Bytef*>(src);
+      stream.avail_in = static_cast<uInt>(src_size);
+      stream.next_out = dst;
+      stream.avail_out = static_cast<uInt>(dst_size);
+
+      const int err = inflate(&stream, Z_FINISH);
+      inflateEnd(&stream);
+      if (err != Z_STREAM_END || stream.avail_out != 0)
+      {
+        Log_ErrorPrintf("Inflate error %d", err);
+        return false;
+      }
+
+      return true;
+    }
+
+    case Codec::LZMA:
+    {
+      if (src_size < LZMA_PROPS_SIZE)
+        return false;
+
+      SizeT dst_len = dst_size;
+      SizeT src_len = src_size - LZMA_PROPS_SIZE;
+      ELzmaStatus status;
+      const SRes res = LzmaDecode(dst, &dst_len, src + LZMA_PROPS_SIZE, &src_len, src, LZMA_PROPS_SIZE,
+                                  LZMA_FINISH_END, &status, &g_Alloc);
+      if (res != SZ_OK || dst_len != dst_size)
+      {
+        Log_ErrorPrintf("LZMA decode error %d", res);
+        return false;
+      }
+
+      return true;
+    }
+
+    default:
+      return false;
+  }
+}
+
+// Falls back to storing the frame if it doesn't get any smaller.
+static void CompressFrame(const u8* src, u32 src_size, bool use_lzma, std::vector<u8>* dst, Codec* codec)
+{
+  if (use_lzma)
+  {
+    CLzmaEncProps props;
+    LzmaEncProps_Init(&props);
+    props.level = 9;
+    props.reduceSize = src_size;
+    props.numThreads = 1;
+
+    dst->resize(LZMA_PROPS_SIZE + src_size);
+    SizeT dst_len = src_size;
+    SizeT props_size = LZMA_PROPS_SIZE;
+    if (LzmaEncode(dst->data() + LZMA_PROPS_SIZE, &dst_len, src, src_size, &props, dst->data(), &props_size, 0,
+                   nullptr, &g_Alloc, &g_Alloc) == SZ_OK &&
+        props_size == LZMA_PROPS_SIZE && (LZMA_PROPS_SIZE + dst_len) < src_size)
+    {
+      dst->resize(LZMA_PROPS_SIZE + dst_len);
+      *codec = Codec::LZMA;
+      return;
+    }
+  }
+  else
+  {
+    z_stream stream = {};
+    if (deflateInit2(&stream, Z_BEST_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 9, Z_DEFAULT_STRATEGY) == Z_OK)
+    {
+      dst->resize(deflateBound(&stream, static_cast<uLong>(src_size)));
+      stream.next_in = const_cast<Bytef*>(src);
+      stream.avail_in = static_cast<uInt>(src_size);
+      stream.next_out = dst->data();
+      stream.avail_out = static_cast<uInt>(dst->size());
+
+      const int err = deflate(&stream, Z_FINISH);
+      deflateEnd(&stream);
+      if (err == Z_STREAM_END && stream.total_out < src_size)
+      {
+        dst->resize(stream.total_out);
+        *codec = Codec::Deflate;
+        return;
+      }
+    }
+  }
+
+  dst->assign(src, src + src_size);
+  *codec = Codec::Stored;
+}
+
+class CDImageDCI final : public CDImage
+{
+public:
+  CDImageDCI() = default;
+  ~CDImageDCI() override;
+
+  bool Open(const char* filename, Common::Error* error);
+
+  bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index) override;
+  bool HasNonStandardSubchannel() const override;
+  PrecacheResult Precache(ProgressCallback* progress) override;
+
+protected:
+  bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
+
+private:
+  template<typename T>
+  bool ReadTable(u64 offset, u32 count, std::vector<T>* table);
+
+  /// Number of decompressed bytes in a frame, only the last one can be short.
+  u32 GetFrameDataSize(u32 frame_index) const;
+
+  bool DecodeFrame(u32 frame_index, const u8* src, u8* dst) const;
+  bool ReadFrame(u32 frame_index, u8* dst);
+  bool DecompressFrameFromMapping(u32 frame_index, u8* dst) const;
+
+  std::FILE* m_fp = nullptr;
+  u64 m_file_size = 0;
+
+  MappedFile m_mapping;
+  CompressedBlockCache m_block_cache;
+
+  std::vector<FrameEntry> m_frames;
+  std::vector<u32> m_sector_map;
+  std::vector<u8> m_ecc_map;
+  u32 m_sectors_per_frame = 0;
+  u32 m_unique_sector_count = 0;
+
+  std::vector<u8> m_frame_buffer;
+  std::vector<u8> m_compressed_buffer;
+  u32 m_current_frame = static_cast<u32>(-1);
+
+  CDSubChannelReplacement m_sbi;
+};
+
+CDImageDCI::~CDImageDCI()
+{
+  // workers read from the mapping
+  m_block_cache.Clear();
+
+  if (m_fp)
+    std::fclose(m_fp);
+}
+
+bool CDImageDCI::Open(const char* filename, Common::Error* error)
+{
+  m_fp = FileSystem::OpenCFile(filename, "rb");
+  if (!m_fp)
+  {
+    Log_ErrorPrintf("Failed to open '%s'", filename);
+    if (error)
+      error->SetErrno(errno);
+
+    return false;
+  }
+
+  m_filename = filename;
+  m_file_size = static_cast<u64>(std::max<s64>(FileSystem::FSize64(m_fp), 0));
+
+  FileHeader header;
+  if (std::fread(&header, sizeof(header), 1, m_fp) != 1 ||
+      std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0)
+  {
+    Log_ErrorPrintf("Invalid header in '%s'", filename);
+    if (error)
+      error->SetMessage("Invalid DCI header");
+
+    return false;
+  }
+
+  if (header.version != FILE_VERSION)
+  {
+    Log_ErrorPrintf("Unsupported version %u in '%s'", header.version, filename);
+    if (error)
+      error->SetFormattedMessage("Unsupported DCI version %u", header.version);
+
+    return false;
+  }
+
+  if (header.sectors_per_frame == 0 || header.sectors_per_frame > MAX_SECTORS_PER_FRAME ||
+      header.frame_count != ((header.unique_sector_count + header.sectors_per_frame - 1) / header.sectors_per_frame) ||
+      header.unique_sector_count > header.sector_count || header.track_count == 0 || header.track_count > 99 ||
+      header.index_count == 0)
+  {
+    Log_ErrorPrintf("Invalid layout in '%s'", filename);
+    if (error)
+      error->SetMessage("Invalid DCI layout");
+
+    return false;
+  }
+
+  std::vector<TrackEntry> tracks;
+  std::vector<IndexEntry> indices;
+  std::vector<SubChannelQEntry> subq_entries;
+  if (!ReadTable(header.frame_table_offset, header.frame_count, &m_frames) ||
+      !ReadTable(header.sector_map_offset, header.sector_count, &m_sector_map) ||
+      !ReadTable(header.track_table_offset, header.track_count, &tracks) ||
+      !ReadTable(header.index_table_offset, header.index_count, &indices) ||
+      !ReadTable(header.subq_table_offset, header.subq_count, &subq_entries) ||
+      !ReadTable(header.ecc_map_offset, (header.unique_sector_count + 7) / 8, &m_ecc_map))
+  {
+    Log_ErrorPrintf("Failed to read tables from '%s'", filename);
+    if (error)
+      error->SetMessage("Failed to read DCI tables");
+
+    return false;
+  }
+
+  m_sectors_per_frame = header.sectors_per_frame;
+  m_unique_sector_count = header.unique_sector_count;
+
+  for (const FrameEntry& frame : m_frames)
+  {
+    if (frame.offset > m_file_size || (m_file_size - frame.offset) < frame.size ||
+        frame.codec > static_cast<u8>(Codec::LZMA))
+    {
+      Log_ErrorPrintf("Invalid frame table in '%s'", filename);
+      if (error)
+        error->SetMessage("Invalid DCI frame table");
+
+      return false;
+    }
+  }
+
+  if (std::any_of(m_sector_map.begin(), m_sector_map.end(),
+                  [this](u32 unique_sector) { return (unique_sector >= m_unique_sector_count); }))
+  {
+    Log_ErrorPrintf("Invalid sector map in '%s'", filename);
+    if (error)
+      error->SetMessage("Invalid DCI sector map");
+
+    return false;
+  }
+
+  for (const TrackEntry& te : tracks)
+  {
+    if (te.mode > static_cast<u8>(TrackMode::Mode2Raw))
+    {
+      Log_ErrorPrintf("Invalid track mode %u in '%s'", te.mode, filename);
+      if (error)
+        error->SetMessage("Invalid DCI track table");
+
+      return false;
+    }
+
+    Track track = {};
+    track.track_number = te.track_number;
+    track.start_lba = te.start_lba;
+    track.first_index = te.first_index;
+    track.length = te.length;
+    track.mode = static_cast<TrackMode>(te.mode);
+    track.control.bits = te.control;
+    m_tracks.push_back(track);
+  }
+
+  for (const IndexEntry& ie : indices)
+  {
+    if (ie.mode > static_cast<u8>(TrackMode::Mode2Raw) ||
+        (ie.is_stored &&
+         (ie.first_sector > header.sector_count || (header.sector_count - ie.first_sector) < ie.length)))
+    {
+      Log_ErrorPrintf("Invalid index in '%s'", filename);
+      if (error)
+        error->SetMessage("Invalid DCI index table");
+
+      return false;
+    }
+
+    Index index = {};
+    index.file_offset = ie.is_stored ? ie.first_sector : 0;
+    index.file_index = 0;
+    index.file_sector_size = ie.is_stored ? static_cast<u32>(RAW_SECTOR_SIZE) : 0u;
+    index.start_lba_on_disc = ie.start_lba_on_disc;
+    index.track_number = ie.track_number;
+    index.index_number = ie.index_number;
+    index.start_lba_in_track = static_cast<LBA>(ie.start_lba_in_track);
+    index.length = ie.length;
+    index.mode = static_cast<TrackMode>(ie.mode);
+    index.control.bits = ie.control;
+    index.is_pregap = (ie.is_pregap != 0);
+    m_indices.push_back(index);
+  }
+
+  m_lba_count = header.lba_count;
+
+  // a sidecar sbi takes priority over what was stored when the image was converted
+  m_sbi.LoadSBI(Path::ReplaceExtension(m_filename, "sbi").c_str());
+  for (const SubChannelQEntry& entry : subq_entries)
+  {
+    SubChannelQ subq;
+    if (m_sbi.GetReplacementSubChannelQ(entry.lba, &subq))
+      continue;
+
+    std::copy(std::begin(entry.data), std::end(entry.data), subq.data.begin());
+    m_sbi.AddReplacementSubChannelQ(entry.lba, subq);
+  }
+
+  // without the mapping we can still read through m_fp, but nothing can be decompressed in parallel
+  if (!m_mapping.Map(m_fp))
+    Log_WarningPrintf("Failed to map '%s', prefetching and precaching will be unavailable", filename);
+
+  const u32 frame_size = m_sectors_per_frame * RAW_SECTOR_SIZE;
+  m_frame_buffer.resize(frame_size);
+  if (m_mapping.IsValid())
+  {
+    m_block_cache.Initialize(frame_size, header.frame_count, [this](u32 frame_index, u8* dst) {
+      return DecompressFrameFromMapping(frame_index, dst);
+    });
+  }
+  else
+  {
+    m_block_cache.Initialize(frame_size, header.frame_count, {});
+  }
+
+  Log_DevPrintf("%u sectors, %u unique in %u frames of %u", header.sector_count, header.unique_sector_count,
+                header.frame_count, m_sectors_per_frame);
+  return Seek(1, Position{0, 0, 0});
+}
+
+template<typename T>
+bool CDImageDCI::ReadTable(u64 offset, u32 count, std::vector<T>* table)
+{
+  const u64 size = static_cast<u64>(count) * sizeof(T);
+  if (offset > m_file_size || (m_file_size - offset) < size)
+    return false;
+
+  table->resize(count);
+  return (count == 0 || (FSeek64(m_fp, static_cast<s64>(offset), SEEK_SET) == 0 &&
+                         std::fread(table->data(), sizeof(T), count, m_fp) == count));
+}
+
+u32 CDImageDCI::GetFrameDataSize(u32 frame_index) const
+{
+  const u32 first_sector = frame_index * m_sectors_per_frame;
+  return std::min(m_sectors_per_frame, m_unique_sector_count - first_sector) * RAW_SECTOR_SIZE;
+}
+
+bool CDImageDCI::DecodeFrame(u32 frame_index, const u8* src, u8* dst) const
+{
+  const FrameEntry& frame = m_frames[frame_index];
+  const u32 data_size = GetFrameDataSize(frame_index);
+  std::memset(dst + data_size, 0, (m_sectors_per_frame * RAW_SECTOR_SIZE) - data_size);
+  if (!DecompressFrame(static_cast<Codec>(frame.codec), src, frame.size, dst, data_size))
+    return false;
+
+  const u32 first_sector = frame_index * m_sectors_per_frame;
+  const u32 num_sectors = data_size / RAW_SECTOR_SIZE;
+  for (u32 i = 0; i < num_sectors; i++)
+  {
+    const u32 unique_sector = first_sector + i;
+    if (!(m_ecc_map[unique_sector / 8] & (1u << (unique_sector % 8))))
+      continue;
+
+    u8* sector = dst + i * RAW_SECTOR_SIZE;
+    CDECC::SectorType type;
+    if (!CDECC::GetSectorType(sector, &type))
+      return false;
+
+    CDECC::GenerateEDCECC(sector, type);
+  }
+
+  return true;
+}
+
+bool CDImageDCI::ReadFrame(u32 frame_index, u8* dst)
+{
+  const FrameEntry& frame = m_frames[frame_index];
+  m_compressed_buffer.resize(frame.size);
+  if (FSeek64(m_fp, static_cast<s64>(frame.offset), SEEK_SET) != 0 ||
+      std::fread(m_compressed_buffer.data(), frame.size, 1, m_fp) != 1)
+  {
+    return false;
+  }
+
+  return DecodeFrame(frame_index, m_compressed_buffer.data(), dst);
+}
+
+bool CDImageDCI::DecompressFrameFromMapping(u32 frame_index, u8* dst) const
+{
+  return DecodeFrame(frame_index, m_mapping.GetData() + m_frames[frame_index].offset, dst);
+}
+
+CDImage::PrecacheResult CDImageDCI::Precache(ProgressCallback* progress)
+{
+  if (!m_mapping.IsValid())
+    return CDImage::PrecacheResult::Unsupported;
+
+  if (!m_block_cache.StartPrecache())
+    return CDImage::PrecacheResult::ReadError;
+
+  if (progress == ProgressCallback::NullProgressCallback)
+    return CDImage::PrecacheResult::Success;
+
+  const std::string_view title(FileSystem::GetDisplayNameFromPath(m_filename));
+  progress->SetFormattedStatusText("Precaching %.*s...", static_cast<int>(title.size()), title.data());
+  return m_block_cache.WaitForPrecache(progress) ? CDImage::PrecacheResult::Success :
+                                                   CDImage::PrecacheResult::ReadError;
+}
+
+bool CDImageDCI::ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index)
+{
+  if (m_sbi.GetReplacementSubChannelQ(index.start_lba_on_disc + lba_in_index, subq))
+    return true;
+
+  return CDImage::ReadSubChannelQ(subq, index, lba_in_index);
+}
+
+bool CDImageDCI::HasNonStandardSubchannel() const
+{
+  return (m_sbi.GetReplacementSectorCount() > 0);
+}
+
+bool CDImageDCI::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
+{
+  DebugAssert(index.file_sector_size > 0);
+  const u32 unique_sector = m_sector_map[static_cast<u32>(index.file_offset) + lba_in_index];
+  const u32 frame_index = unique_sector / m_sectors_per_frame;
+
+  if (m_current_frame != frame_index)
+  {
+    if (!m_block_cache.IsEnabled() || !m_block_cache.Lookup(frame_index, m_frame_buffer.data()))
+    {
+      const bool result = m_mapping.IsValid() ? DecompressFrameFromMapping(frame_index, m_frame_buffer.data()) :
+                                                ReadFrame(frame_index, m_frame_buffer.data());
+      if (!result)
+      {
+        Log_ErrorPrintf("Failed to decompress frame %u", frame_index);
+        m_current_frame = static_cast<u32>(-1);
+        return false;
+      }
+
+      if (m_block_cache.IsEnabled())
+        m_block_cache.Insert(frame_index, m_frame_buffer.data());
+    }
+
+    m_current_frame = frame_index;
+  }
+
+  std::memcpy(buffer, &m_frame_buffer[(unique_sector % m_sectors_per_frame) * RAW_SECTOR_SIZE], RAW_SECTOR_SIZE);
+  return true;
+}
+
+std::unique_ptr<CDImage> CDImage::OpenDCIImage(const char* filename, Common::Error* error)
+{
+  std::unique_ptr<CDImageDCI> image = std::make_unique<CDImageDCI>();
+  if (!image->Open(filename, error))
+    return {};
+
+  return image;
+}
+
+namespace {
+class DCIWriter
+{
+public:
+  DCIWriter(std::FILE* fp, u32 sectors_per_frame, bool use_lzma);
+  ~DCIWriter();
+
+  bool Write(CDImage* image, ProgressCallback* progress, Common::Error* error);
+
+private:
+  struct SectorHash
+  {
+    u64 low;
+    u64 high;
+
+    bool operator==(const SectorHash& rhs) const { return (low == rhs.low && high == rhs.high); }
+  };
+  struct SectorHashHasher
+  {
+    size_t operator()(const SectorHash& hash) const { return static_cast<size_t>(hash.low); }
+  };
+
+  // Where a unique sector was first seen, so later hash matches can be compared against it.
+  struct UniqueSector
+  {
+    u32 unique_sector;
+    u32 index;
+    u32 lba;
+  };
+
+  struct PendingFrame
+  {
+    std::vector<u8> data;
+    std::vector<u8> compressed;
+    Codec codec;
+  };
+
+  bool AddSector(const u8* data, u32 index, u32 lba);
+  bool IsSameAsUniqueSector(const u8* data, const UniqueSector& us);
+  bool FlushFrames();
+  bool WriteData(const void* data, size_t size);
+
+  template<typename T>
+  bool WriteTable(const std::vector<T>& table, u64* offset);
+
+  std::FILE* m_fp;
+  CDImage* m_image = nullptr;
+  u64 m_file_offset = 0;
+  u32 m_sectors_per_frame;
+  bool m_use_lzma;
+
+  std::unordered_map<SectorHash, UniqueSector, SectorHashHasher> m_unique_sectors;
+  std::array<u8, CDImage::RAW_SECTOR_SIZE> m_compare_buffer;
+  std::vector<u32> m_sector_map;
+  std::vector<u8> m_ecc_map;
+  std::vector<FrameEntry> m_frames;
+  u32 m_unique_sector_count = 0;
+  u32 m_ecc_sector_count = 0;
+
+  // Frames are compressed in batches across the pool, then written in order.
+  std::unique_ptr<cb::ThreadPool> m_pool;
+  std::vector<PendingFrame> m_pending_frames;
+  u32 m_num_pending_frames = 0;
+};
+} // namespace
+
+DCIWriter::DCIWriter(std::FILE* fp, u32 sectors_per_frame, bool use_lzma)
+  : m_fp(fp), m_sectors_per_frame(sectors_per_frame), m_use_lzma(use_lzma)
+{
+  const u32 num_workers = std::max(cb::ThreadPool::GetNumLogicalCores(), 1u);
+  m_pool = std::make_unique<cb::ThreadPool>(static_cast<int>(num_workers));
+  m_pending_frames.resize(num_workers * 4);
+  for (PendingFrame& frame : m_pending_frames)
+    frame.data.reserve(sectors_per_frame * CDImage::RAW_SECTOR_SIZE);
+}
+
+DCIWriter::~DCIWriter() = default;
+
+bool DCIWriter::Write(CDImage* image, ProgressCallback* progress, Common::Error* error)
+{
+  const std::vector<CDImage::Index>& indices = image->GetIndices();
+  m_image = image;
+
+  // same layout as memory images, pregaps which aren't in the source image aren't stored
+  u32 sector_count = 0;
+  for (const CDImage::Index& index : indices)
+  {
+    if (index.file_sector_size > 0)
+      sector_count += index.length;
+  }
+
+  // header is written last, once the table offsets are known
+  FileHeader header = {};
+  if (!WriteData(&header, sizeof(header)))
+  {
+    if (error)
+      error->SetErrno(errno);
+
+    return false;
+  }
+
+  progress->SetStatusText("Compressing sectors...");
+  progress->SetProgressRange(sector_count);
+  progress->SetProgressValue(0);
+
+  std::vector<IndexEntry> index_table;
+  std::array<u8, CDImage::RAW_SECTOR_SIZE> sector;
+  m_sector_map.reserve(sector_count);
+  for (u32 i = 0; i < static_cast<u32>(indices.size()); i++)
+  {
+    const CDImage::Index& index = indices[i];
+
+    IndexEntry ie = {};
+    ie.first_sector = static_cast<u32>(m_sector_map.size());
+    ie.start_lba_on_disc = index.start_lba_on_disc;
+    ie.track_number = index.track_number;
+    ie.index_number = index.index_number;
+    ie.start_lba_in_track = static_cast<s32>(index.start_lba_in_track);
+    ie.length = index.length;
+    ie.mode = static_cast<u8>(index.mode);
+    ie.control = index.control.bits;
+    ie.is_pregap = index.is_pregap;
+    ie.is_stored = (index.file_sector_size > 0);
+    index_table.push_back(ie);
+
+    if (index.file_sector_size == 0)
+      continue;
+
+    for (u32 lba = 0; lba < index.length; lba++)
+    {
+      if (progress->IsCancelled())
+      {
+        if (error)
+          error->SetMessage("Conversion was cancelled");
+
+        return false;
+      }
+
+      if (!image->ReadSectorFromIndex(sector.data(), index, lba))
+      {
+        Log_ErrorPrintf("Failed to read LBA %u in index %u", lba, i);
+        if (error)
+          error->SetFormattedMessage("Failed to read LBA %u in index %u", lba, i);
+
+        return false;
+      }
+
+      if (!AddSector(sector.data(), i, lba))
+      {
+        if (error)
+          error->SetErrno(errno);
+
+        return false;
+      }
+
+      progress->SetProgressValue(static_cast<u32>(m_sector_map.size()));
+    }
+  }
+
+  if (!FlushFrames())
+  {
+    if (error)
+      error->SetErrno(errno);
+
+    return false;
+  }
+
+  // only keep sub-channel Q which can't be generated from the TOC, i.e. from an sbi or subchannel in the source image
+  progress->SetStatusText("Scanning sub-channel...");
+  progress->SetProgressRange(static_cast<u32>(indices.size()));
+  progress->SetProgressValue(0);
+
+  std::vector<SubChannelQEntry> subq_table;
+  for (u32 i = 0; i < static_cast<u32>(indices.size()); i++)
+  {
+    const CDImage::Index& index = indices[i];
+    for (u32 lba = 0; lba < index.length; lba++)
+    {
+      CDImage::SubChannelQ subq, generated_subq;
+      if (!image->ReadSubChannelQ(&subq, index, lba) || !image->CDImage::ReadSubChannelQ(&generated_subq, index, lba))
+      {
+        Log_ErrorPrintf("Failed to read sub-channel Q for LBA %u in index %u", lba, i);
+        if (error)
+          error->SetFormattedMessage("Failed to read sub-channel Q for LBA %u in index %u", lba, i);
+
+        return false;
+      }
+
+      if (subq.data != generated_subq.data)
+      {
+        SubChannelQEntry entry;
+        entry.lba = index.start_lba_on_disc + lba;
+        std::copy(subq.data.begin(), subq.data.end(), entry.data);
+        subq_table.push_back(entry);
+      }
+    }
+
+    progress->SetProgressValue(i + 1);
+  }
+  std::sort(subq_table.begin(), subq_table.end(),
+            [](const SubChannelQEntry& lhs, const SubChannelQEntry& rhs) { return (lhs.lba < rhs.lba); });
+
+  std::vector<TrackEntry> track_table;
+  for (const CDImage::Track& track : image->GetTracks())
+  {
+    TrackEntry te = {};
+    te.track_number = track.track_number;
+    te.start_lba = track.start_lba;
+    te.first_index = track.first_index;
+    te.length = track.length;
+    te.mode = static_cast<u8>(track.mode);
+    te.control = track.control.bits;
+    track_table.push_back(te);
+  }
+
+  std::memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+  header.version = FILE_VERSION;
+  header.sectors_per_frame = m_sectors_per_frame;
+  header.lba_count = image->GetLBACount();
+  header.sector_count = static_cast<u32>(m_sector_map.size());
+  header.unique_sector_count = m_unique_sector_count;
+  header.frame_count = static_cast<u32>(m_frames.size());
+  header.track_count = static_cast<u32>(track_table.size());
+  header.index_count = static_cast<u32>(index_table.size());
+  header.subq_count = static_cast<u32>(subq_table.size());
+  if (!WriteTable(m_frames, &header.frame_table_offset) || !WriteTable(m_sector_map, &header.sector_map_offset) ||
+      !WriteTable(track_table, &header.track_table_offset) || !WriteTable(index_table, &header.index_table_offset) ||
+      !WriteTable(subq_table, &header.subq_table_offset) || !WriteTable(m_ecc_map, &header.ecc_map_offset) ||
+      FSeek64(m_fp, 0, SEEK_SET) != 0 ||
+      std::fwrite(&header, sizeof(header), 1, m_fp) != 1 || std::fflush(m_fp) != 0)
+  {
+    if (error)
+      error->SetErrno(errno);
+
+    return false;
+  }
+
+  Log_InfoPrintf("%u sectors, %u unique in %u frames, %u with regenerated EDC/ECC, %u sub-channel Q replacements, "
+                 "%" PRIu64 " bytes",
+                 header.sector_count, header.unique_sector_count, header.frame_count, m_ecc_sector_count,
+                 header.subq_count, m_file_offset);
+  return true;
+}
+
+bool DCIWriter::AddSector(const u8* data, u32 index, u32 lba)
+{
+  const XXH128_hash_t xxh = XXH3_128bits(data, CDImage::RAW_SECTOR_SIZE);
+  const SectorHash hash{xxh.low64, xxh.high64};
+  const auto iter = m_unique_sectors.find(hash);
+  if (iter != m_unique_sectors.end())
+  {
+    if (IsSameAsUniqueSector(data, iter->second))
+    {
+      m_sector_map.push_back(iter->second.unique_sector);
+      return true;
+    }
+
+    // keep the first sector in the map, this one is just stored again
+    Log_WarningPrintf("Hash collision between LBA %u in index %u and LBA %u in index %u", lba, index,
+                      iter->second.lba, iter->second.index);
+  }
+
+  const u32 unique_sector = m_unique_sector_count++;
+  if (iter == m_unique_sectors.end())
+    m_unique_sectors.emplace(hash, UniqueSector{unique_sector, index, lba});
+  m_sector_map.push_back(unique_sector);
+
+  PendingFrame& frame = m_pending_frames[m_num_pending_frames];
+  frame.data.insert(frame.data.end(), data, data + CDImage::RAW_SECTOR_SIZE);
+
+  if ((unique_sector % 8) == 0)
+    m_ecc_map.push_back(0);
+
+  CDECC::SectorType type;
+  if (CDECC::GetSectorType(data, &type) && CDECC::IsEDCECCRegenerable(data, type))
+  {
+    CDECC::ClearEDCECC(&frame.data[frame.data.size() - CDImage::RAW_SECTOR_SIZE], type);
+    m_ecc_map.back() |= static_cast<u8>(1u << (unique_sector % 8));
+    m_ecc_sector_count++;
+  }
+
+  if (frame.data.size() < (m_sectors_per_frame * CDImage::RAW_SECTOR_SIZE))
+    return true;
+
+  m_num_pending_frames++;
+  return (m_num_pending_frames < m_pending_frames.size() || FlushFrames());
+}
+
+bool DCIWriter::IsSameAsUniqueSector(const u8* data, const UniqueSector& us)
+{
+  // the compressed frames don't keep the sector around, so read it from the source image again
+  return (m_image->ReadSectorFromIndex(m_compare_buffer.data(), m_image->GetIndices()[us.index], us.lba) &&
+          std::memcmp(data, m_compare_buffer.data(), CDImage::RAW_SECTOR_SIZE) == 0);
+}
+
+bool DCIWriter::FlushFrames()
+{
+  // include the partially filled last frame
+  if (m_num_pending_frames < m_pending_frames.size() && !m_pending_frames[m_num_pending_frames].data.empty())
+    m_num_pending_frames++;
+
+  for (u32 i = 0; i < m_num_pending_frames; i++)
+  {
+    PendingFrame* frame = &m_pending_frames[i];
+    m_pool->Schedule([frame, use_lzma = m_use_lzma]() {
+      CompressFrame(frame->data.data(), static_cast<u32>(frame->data.size()), use_lzma, &frame->compressed,
+                    &frame->codec);
+    });
+  }
+  m_pool->Wait();
+
+  for (u32 i = 0; i < m_num_pending_frames; i++)
+  {
+    PendingFrame& frame = m_pending_frames[i];
+
+    FrameEntry fe = {};
+    fe.offset = m_file_offset;
+    fe.size = static_cast<u32>(frame.compressed.size());
+    fe.codec = static_cast<u8>(frame.codec);
+    if (!WriteData(frame.compressed.data(), frame.compressed.size()))
+      return false;
+
+    m_frames.push_back(fe);
+    frame.data.clear();
+  }
+
+  m_num_pending_frames = 0;
+  return true;
+}
+
+bool DCIWriter::WriteData(const void* data, size_t size)
+{
+  if (size > 0 && std::fwrite(data, size, 1, m_fp) != 1)
+    return false;
+
+  m_file_offset += size;
+  return true;
+}
+
+template<typename T>
+bool DCIWriter::WriteTable(const std::vector<T>& table, u64* offset)
+{
+  *offset = m_file_offset;
+  return WriteData(table.data(), table.size() * sizeof(T));
+}
+
+bool CDImage::WriteDCIImage(CDImage* image, const char* filename, u32 sectors_per_frame, bool use_lzma,
+                            ProgressCallback* progress, Common::Error* error)
+{
+  if (sectors_per_frame == 0 || sectors_per_frame > MAX_SECTORS_PER_FRAME)
+  {
+    if (error)
+      error->SetFormattedMessage("Frames must be between 1 and %u sectors", static_cast<u32>(MAX_SECTORS_PER_FRAME));
+
+    return false;
+  }
+
+  std::FILE* fp = FileSystem::OpenCFile(filename, "wb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open '%s' for writing", filename);
+    if (error)
+      error->SetErrno(errno);
+
+    return false;
+  }
+
+  Common::Timer timer;
+  bool result;
+  {
+    DCIWriter writer(fp, sectors_per_frame, use_lzma);
+    result = writer.Write(image, progress, error);
+  }
+
+  if (std::fclose(fp) != 0 && result)
+  {
+    if (error)
+      error->SetErrno(errno);
+
+    result = false;
+  }
+
+  if (!result)
+  {
+    FileSystem::DeleteFile(filename);
+    return false;
+  }
+
+  Log_InfoPrintf("Wrote '%s' in %.2f ms", filename, timer.GetTimeMilliseconds());
+  return true;
+}
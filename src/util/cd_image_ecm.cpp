@@ -1,160 +1,18 @@
+#include "cd_ecc.h"
 #include "cd_image.h"
 #include "cd_subchannel_replacement.h"
 #include "common/assert.h"
 #include "common/error.h"
 #include "common/file_system.h"
 #include "common/log.h"
+#include "common/path.h"
+#include "compressed_block_cache.h"
+#include "mapped_file.h"
+#include <algorithm>
 #include <array>
 #include <cerrno>
-#include <map>
 Log_SetChannel(CDImageEcm);
 
-// unecm.c by Neill Corlett (c) 2002, GPL licensed
-
-/* LUTs used for computing ECC/EDC */
-
-static constexpr std::array<u8, 256> ComputeECCFLUT()
-{
-  std::array<u8, 256> ecc_lut{};
-  for (u32 i = 0; i < 256; i++)
-  {
-    u32 j = (i << 1) ^ (i & 0x80 ? 0x11D : 0);
-    ecc_lut[i] = static_cast<u8>(j);
-  }
-  return ecc_lut;
-}
-
-static constexpr std::array<u8, 256> ComputeECCBLUT()
-{
-  std::array<u8, 256> ecc_lut{};
-  for (u32 i = 0; i < 256; i++)
-  {
-    u32 j = (i << 1) ^ (i & 0x80 ? 0x11D : 0);
-    ecc_lut[i ^ j] = static_cast<u8>(i);
-  }
-  return ecc_lut;
-}
-
-static constexpr std::array<u32, 256> ComputeEDCLUT()
-{
-  std::array<u32, 256> edc_lut{};
-  for (u32 i = 0; i < 256; i++)
-  {
-    u32 edc = i;
-    for (u32 k = 0; k < 8; k++)
-      edc = (edc >> 1) ^ (edc & 1 ? 0xD8018001 : 0);
-    edc_lut[i] = edc;
-  }
-  return edc_lut;
-}
-
-static constexpr std::array<u8, 256> ecc_f_lut = ComputeECCFLUT();
-static constexpr std::array<u8, 256> ecc_b_lut = ComputeECCBLUT();
-static constexpr std::array<u32, 256> edc_lut = ComputeEDCLUT();
-
-/***************************************************************************/
-/*
-** Compute EDC for a block
-*/
-static u32 edc_partial_computeblock(u32 edc, const u8* src, u16 size)
-{
-  while (size--)
-    edc = (edc >> 8) ^ edc_lut[(edc ^ (*src++)) & 0xFF];
-  return edc;
-}
-
-static void edc_computeblock(const u8* src, u16 size, u8* dest)
-{
-  u32 edc = edc_partial_computeblock(0, src, size);
-  dest[0] = (edc >> 0) & 0xFF;
-  dest[1] = (edc >> 8) & 0xFF;
-  dest[2] = (edc >> 16) & 0xFF;
-  dest[3] = (edc >> 24) & 0xFF;
-}
-
-/***************************************************************************/
-/*
-** Compute ECC for a block (can do either P or Q)
-*/
-static void ecc_computeblock(u8* src, u32 major_count, u32 minor_count, u32 major_mult, u32 minor_inc, u8* dest)
-{
-  u32 size = major_count * minor_count;
-  u32 major, minor;
-  for (major = 0; major < major_count; major++)
-  {
-    u32 index = (major >> 1) * major_mult + (major & 1);
-    u8 ecc_a = 0;
-    u8 ecc_b = 0;
-    for (minor = 0; minor < minor_count; minor++)
-    {
-      u8 temp = src[index];
-      index += minor_inc;
-      if (index >= size)
-        index -= size;
-      ecc_a ^= temp;
-      ecc_b ^= temp;
-      ecc_a = ecc_f_lut[ecc_a];
-    }
-    ecc_a = ecc_b_lut[ecc_f_lut[ecc_a] ^ ecc_b];
-    dest[major] = ecc_a;
-    dest[major + major_count] = ecc_a ^ ecc_b;
-  }
-}
-
-/*
-** Generate ECC P and Q codes for a block
-*/
-static void ecc_generate(u8* sector, int zeroaddress)
-{
-  u8 address[4], i;
-  /* Save the address and zero it out */
-  if (zeroaddress)
-    for (i = 0; i < 4; i++)
-    {
-      address[i] = sector[12 + i];
-      sector[12 + i] = 0;
-    }
-  /* Compute ECC P code */
-  ecc_computeblock(sector + 0xC, 86, 24, 2, 86, sector + 0x81C);
-  /* Compute ECC Q code */
-  ecc_computeblock(sector + 0xC, 52, 43, 86, 88, sector + 0x8C8);
-  /* Restore the address */
-  if (zeroaddress)
-    for (i = 0; i < 4; i++)
-      sector[12 + i] = address[i];
-}
-
-/***************************************************************************/
-/*
-** Generate ECC/EDC information for a sector (must be 2352 = 0x930 bytes)
-** Returns 0 on success
-*/
-static void eccedc_generate(u8* sector, int type)
-{
-  switch (type)
-  {
-    case 1: /* Mode 1 */
-      /* Compute EDC */
-      edc_computeblock(sector + 0x00, 0x810, sector + 0x810);
-      /* Write out zero bytes */
-      for (u32 i = 0; i < 8; i++)
-        sector[0x814 + i] = 0;
-      /* Generate ECC P/Q codes */
-      ecc_generate(sector, 0);
-      break;
-    case 2: /* Mode 2 form 1 */
-      /* Compute EDC */
-      edc_computeblock(sector + 0x10, 0x808, sector + 0x818);
-      /* Generate ECC P/Q codes */
-      ecc_generate(sector, 1);
-      break;
-    case 3: /* Mode 2 form 2 */
-      /* Compute EDC */
-      edc_computeblock(sector + 0x10, 0x91C, sector + 0x92C);
-      break;
-  }
-}
-
 class CDImageEcm : public CDImage
 {
 public:
@@ -165,12 +23,26 @@ public:
 
   bool ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index) override;
   bool HasNonStandardSubchannel() const override;
+  PrecacheResult Precache(ProgressCallback* progress) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
 
 private:
+  // Sectors are decoded in blocks for the block cache, with the same number of sectors as a CHD hunk.
+  static constexpr u32 SECTORS_PER_BLOCK = 8;
+  static constexpr u32 BLOCK_SIZE = SECTORS_PER_BLOCK * RAW_SECTOR_SIZE;
+
+  struct SectorEntry;
+
+  bool ScanChunks(s64 file_size, Common::Error* error);
+  bool LoadIndexCache(const std::string& path, const FILESYSTEM_STAT_DATA& sd);
+  void SaveIndexCache(const std::string& path, const FILESYSTEM_STAT_DATA& sd) const;
+
   bool ReadChunks(u32 disc_offset, u32 size);
+  bool ReadFileData(u32 file_offset, void* dst, u32 size) const;
+  bool DecodeChunk(const SectorEntry& entry, u8* dst) const;
+  bool DecodeBlock(u32 block_index, u8* dst) const;
 
   std::FILE* m_fp = nullptr;
 
@@ -199,17 +71,28 @@ private:
 
   struct SectorEntry
   {
+    u32 disc_offset;
     u32 file_offset;
     u32 chunk_size;
     SectorType type;
   };
 
-  using DataMap = std::map<u32, SectorEntry>;
+  // sorted by disc offset
+  using DataMap = std::vector<SectorEntry>;
+
+  DataMap::const_iterator FindChunk(u32 disc_offset) const;
 
   DataMap m_data_map;
   std::vector<u8> m_chunk_buffer;
   u32 m_chunk_start = 0;
 
+  // Mapping the file lets the prefetch and precache workers decode blocks without sharing m_fp.
+  MappedFile m_mapping;
+  CompressedBlockCache m_block_cache;
+  std::vector<u8> m_block_buffer;
+  u32 m_current_block = static_cast<u32>(-1);
+  u32 m_last_block_index = static_cast<u32>(-1);
+
   CDSubChannelReplacement m_sbi;
 };
 
@@ -217,6 +100,9 @@ CDImageEcm::CDImageEcm() = default;
 
 CDImageEcm::~CDImageEcm()
 {
+  // drain any outstanding prefetches before the data map goes away
+  m_block_cache.Clear();
+
   if (m_fp)
     std::fclose(m_fp);
 }
@@ -256,7 +142,96 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
     return false;
   }
 
-  // build sector map
+  // scanning the whole file for the chunk headers is slow, so the result is kept next to the image
+  const std::string index_cache_path(Path::ReplaceExtension(filename, "ecmidx"));
+  FILESYSTEM_STAT_DATA sd;
+  const bool has_stat = FileSystem::StatFile(m_fp, &sd);
+  if (!has_stat || !LoadIndexCache(index_cache_path, sd))
+  {
+    if (!ScanChunks(file_size, error))
+      return false;
+
+    if (has_stat && !m_data_map.empty())
+      SaveIndexCache(index_cache_path, sd);
+  }
+
+  if (m_data_map.empty())
+  {
+    Log_ErrorPrintf("No data in image '%s'", filename);
+    if (error)
+      error->SetFormattedMessage("No data in image '%s'", filename);
+
+    return false;
+  }
+
+  const u32 disc_size = m_data_map.back().disc_offset + m_data_map.back().chunk_size;
+  m_lba_count = disc_size / RAW_SECTOR_SIZE;
+  if ((disc_size % RAW_SECTOR_SIZE) != 0)
+    Log_WarningPrintf("ECM image is misaligned with offset %u", disc_size);
+  if (m_lba_count == 0)
+    return false;
+
+  SubChannelQ::Control control = {};
+  TrackMode mode = TrackMode::Mode2Raw;
+  control.data = mode != TrackMode::Audio;
+
+  // Two seconds default pregap.
+  const u32 pregap_frames = 2 * FRAMES_PER_SECOND;
+  Index pregap_index = {};
+  pregap_index.file_sector_size = RAW_SECTOR_SIZE;
+  pregap_index.start_lba_on_disc = 0;
+  pregap_index.start_lba_in_track = static_cast<LBA>(-static_cast<s32>(pregap_frames));
+  pregap_index.length = pregap_frames;
+  pregap_index.track_number = 1;
+  pregap_index.index_number = 0;
+  pregap_index.mode = mode;
+  pregap_index.control.bits = control.bits;
+  pregap_index.is_pregap = true;
+  m_indices.push_back(pregap_index);
+
+  // Data index.
+  Index data_index = {};
+  data_index.file_index = 0;
+  data_index.file_offset = 0;
+  data_index.file_sector_size = RAW_SECTOR_SIZE;
+  data_index.start_lba_on_disc = pregap_index.length;
+  data_index.track_number = 1;
+  data_index.index_number = 1;
+  data_index.start_lba_in_track = 0;
+  data_index.length = m_lba_count;
+  data_index.mode = mode;
+  data_index.control.bits = control.bits;
+  m_indices.push_back(data_index);
+
+  // Assume a single track.
+  m_tracks.push_back(
+    Track{static_cast<u32>(1), data_index.start_lba_on_disc, static_cast<u32>(0), m_lba_count, mode, control});
+
+  AddLeadOutIndex();
+
+  m_sbi.LoadSBIFromImagePath(filename);
+
+  m_chunk_buffer.reserve(RAW_SECTOR_SIZE * 2);
+
+  // without the mapping we can still read through m_fp, but nothing can be decoded in parallel
+  const u32 block_count = (m_lba_count + SECTORS_PER_BLOCK - 1) / SECTORS_PER_BLOCK;
+  m_block_buffer.resize(BLOCK_SIZE);
+  if (m_mapping.Map(m_fp))
+  {
+    m_block_cache.Initialize(BLOCK_SIZE, block_count,
+                             [this](u32 block_index, u8* dst) { return DecodeBlock(block_index, dst); });
+  }
+  else
+  {
+    Log_WarningPrintf("Failed to map '%s', prefetching and precaching will be unavailable", filename);
+    m_block_cache.Initialize(BLOCK_SIZE, block_count, {});
+  }
+
+  return Seek(1, Position{0, 0, 0});
+}
+
+bool CDImageEcm::ScanChunks(s64 file_size, Common::Error* error)
+{
   u32 file_offset = static_cast<u32>(std::ftell(m_fp));
   u32 disc_offset = 0;
 
@@ -313,7 +288,7 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
       while (count > 0)
       {
         const u32 size = std::min<u32>(count, 2352);
-        m_data_map.emplace(disc_offset, SectorEntry{file_offset, size, type});
+        m_data_map.push_back(SectorEntry{disc_offset, file_offset, size, type});
         disc_offset += size;
         file_offset += size;
         count -= size;
@@ -332,7 +307,7 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
       const u32 chunk_size = s_chunk_sizes[static_cast<u32>(type)];
       for (u32 i = 0; i < count; i++)
       {
-        m_data_map.emplace(disc_offset, SectorEntry{file_offset, chunk_size, type});
+        m_data_map.push_back(SectorEntry{disc_offset, file_offset, chunk_size, type});
         disc_offset += chunk_size;
         file_offset += size;
 
@@ -355,160 +330,294 @@ bool CDImageEcm::Open(const char* filename, Common::Error* error)
     }
   }
 
-  if (m_data_map.empty())
-  {
-    Log_ErrorPrintf("No data in image '%s'", filename);
-    if (error)
-      error->SetFormattedMessage("No data in image '%s'", filename);
+  return true;
+}
+
+namespace {
+#pragma pack(push, 1)
+struct IndexCacheHeader
+{
+  u8 magic[4];
+  u32 version;
+  s64 file_size;
+  s64 modification_time;
+  u32 run_count;
+  u32 disc_size;
+};
+
+// Consecutive chunks of the same type, which is what the headers in the ECM file describe.
+struct IndexCacheRun
+{
+  u32 disc_offset;
+  u32 file_offset;
+  u32 length;
+  u8 type;
+  u8 reserved[3];
+};
+#pragma pack(pop)
 
+static constexpr u8 INDEX_CACHE_MAGIC[4] = {'E', 'C', 'M', 'I'};
+static constexpr u32 INDEX_CACHE_VERSION = 1;
+} // namespace
+
+bool CDImageEcm::LoadIndexCache(const std::string& path, const FILESYSTEM_STAT_DATA& sd)
+{
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(path.c_str());
+  if (!data.has_value())
     return false;
-  }
 
-  m_lba_count = disc_offset / RAW_SECTOR_SIZE;
-  if ((disc_offset % RAW_SECTOR_SIZE) != 0)
-    Log_WarningPrintf("ECM image is misaligned with offset %u", disc_offset);
-  if (m_lba_count == 0)
+  IndexCacheHeader header;
+  if (data->size() < sizeof(header))
     return false;
 
-  SubChannelQ::Control control = {};
-  TrackMode mode = TrackMode::Mode2Raw;
-  control.data = mode != TrackMode::Audio;
+  std::memcpy(&header, data->data(), sizeof(header));
+  if (std::memcmp(header.magic, INDEX_CACHE_MAGIC, sizeof(header.magic)) != 0 ||
+      header.version != INDEX_CACHE_VERSION || header.file_size != sd.Size ||
+      header.modification_time != static_cast<s64>(sd.ModificationTime) ||
+      (data->size() - sizeof(header)) != (header.run_count * sizeof(IndexCacheRun)))
+  {
+    Log_WarningPrintf("Index cache '%s' is out of date", path.c_str());
+    return false;
+  }
 
-  // Two seconds default pregap.
-  const u32 pregap_frames = 2 * FRAMES_PER_SECOND;
-  Index pregap_index = {};
-  pregap_index.file_sector_size = RAW_SECTOR_SIZE;
-  pregap_index.start_lba_on_disc = 0;
-  pregap_index.start_lba_in_track = static_cast<LBA>(-static_cast<s32>(pregap_frames));
-  pregap_index.length = pregap_frames;
-  pregap_index.track_number = 1;
-  pregap_index.index_number = 0;
-  pregap_index.mode = mode;
-  pregap_index.control.bits = control.bits;
-  pregap_index.is_pregap = true;
-  m_indices.push_back(pregap_index);
+  DataMap data_map;
+  u32 disc_offset = 0;
+  for (u32 i = 0; i < header.run_count; i++)
+  {
+    IndexCacheRun run;
+    std::memcpy(&run, data->data() + sizeof(header) + i * sizeof(run), sizeof(run));
+    if (run.type >= static_cast<u8>(SectorType::Count) || run.disc_offset != disc_offset || run.length == 0)
+      break;
 
-  // Data index.
-  Index data_index = {};
-  data_index.file_index = 0;
-  data_index.file_offset = 0;
-  data_index.file_sector_size = RAW_SECTOR_SIZE;
-  data_index.start_lba_on_disc = pregap_index.length;
-  data_index.track_number = 1;
-  data_index.index_number = 1;
-  data_index.start_lba_in_track = 0;
-  data_index.length = m_lba_count;
-  data_index.mode = mode;
-  data_index.control.bits = control.bits;
-  m_indices.push_back(data_index);
+    const SectorType type = static_cast<SectorType>(run.type);
+    const u32 chunk_size = (type == SectorType::Raw) ? RAW_SECTOR_SIZE : s_chunk_sizes[run.type];
+    const u32 sector_size = (type == SectorType::Raw) ? RAW_SECTOR_SIZE : s_sector_sizes[run.type];
+    const u32 chunk_count = (run.length + chunk_size - 1) / chunk_size;
+    if ((type != SectorType::Raw && (run.length % chunk_size) != 0) ||
+        (static_cast<s64>(run.file_offset) + static_cast<s64>(chunk_count - 1) * sector_size +
+         std::min(run.length - (chunk_count - 1) * chunk_size, sector_size)) > sd.Size)
+    {
+      break;
+    }
 
-  // Assume a single track.
-  m_tracks.push_back(
-    Track{static_cast<u32>(1), data_index.start_lba_on_disc, static_cast<u32>(0), m_lba_count, mode, control});
+    for (u32 chunk = 0; chunk < chunk_count; chunk++)
+    {
+      data_map.push_back(SectorEntry{disc_offset, run.file_offset + chunk * sector_size,
+                                     std::min(run.length - chunk * chunk_size, chunk_size), type});
+      disc_offset += data_map.back().chunk_size;
+    }
+  }
 
-  AddLeadOutIndex();
+  if (data_map.empty() || disc_offset != header.disc_size)
+  {
+    Log_WarningPrintf("Index cache '%s' is corrupted", path.c_str());
+    return false;
+  }
 
-  m_sbi.LoadSBIFromImagePath(filename);
+  Log_DevPrintf("Loaded %zu chunks from index cache '%s'", data_map.size(), path.c_str());
+  m_data_map = std::move(data_map);
+  return true;
+}
 
-  m_chunk_buffer.reserve(RAW_SECTOR_SIZE * 2);
-  return Seek(1, Position{0, 0, 0});
+void CDImageEcm::SaveIndexCache(const std::string& path, const FILESYSTEM_STAT_DATA& sd) const
+{
+  std::vector<IndexCacheRun> runs;
+  for (const SectorEntry& entry : m_data_map)
+  {
+    if (!runs.empty())
+    {
+      // raw runs are split into sector sized chunks, so only full chunks can be followed by another
+      IndexCacheRun& run = runs.back();
+      const u32 type = static_cast<u32>(entry.type);
+      const u32 chunk_size = (entry.type == SectorType::Raw) ? RAW_SECTOR_SIZE : s_chunk_sizes[type];
+      const u32 sector_size = (entry.type == SectorType::Raw) ? RAW_SECTOR_SIZE : s_sector_sizes[type];
+      if (run.type == type && (run.length % chunk_size) == 0 &&
+          entry.file_offset == (run.file_offset + (run.length / chunk_size) * sector_size))
+      {
+        run.length += entry.chunk_size;
+        continue;
+      }
+    }
+
+    runs.push_back(IndexCacheRun{entry.disc_offset, entry.file_offset, entry.chunk_size, static_cast<u8>(entry.type)});
+  }
+
+  IndexCacheHeader header = {};
+  std::memcpy(header.magic, INDEX_CACHE_MAGIC, sizeof(header.magic));
+  header.version = INDEX_CACHE_VERSION;
+  header.file_size = sd.Size;
+  header.modification_time = static_cast<s64>(sd.ModificationTime);
+  header.run_count = static_cast<u32>(runs.size());
+  header.disc_size = m_data_map.back().disc_offset + m_data_map.back().chunk_size;
+
+  std::vector<u8> data(sizeof(header) + runs.size() * sizeof(IndexCacheRun));
+  std::memcpy(data.data(), &header, sizeof(header));
+  std::memcpy(data.data() + sizeof(header), runs.data(), runs.size() * sizeof(IndexCacheRun));
+
+  // not being able to write next to the image isn't a problem, it'll just be scanned again next time
+  if (!FileSystem::WriteBinaryFile(path.c_str(), data.data(), data.size()))
+    Log_WarningPrintf("Failed to write index cache '%s'", path.c_str());
+}
+
+CDImageEcm::DataMap::const_iterator CDImageEcm::FindChunk(u32 disc_offset) const
+{
+  // last chunk starting at or before the offset
+  DataMap::const_iterator next =
+    std::upper_bound(m_data_map.begin(), m_data_map.end(), disc_offset,
+                     [](u32 offset, const SectorEntry& entry) { return (offset < entry.disc_offset); });
+  return (next == m_data_map.begin()) ? next : std::prev(next);
 }
 
 bool CDImageEcm::ReadChunks(u32 disc_offset, u32 size)
 {
-  DataMap::iterator next =
-    m_data_map.lower_bound((disc_offset > RAW_SECTOR_SIZE) ? (disc_offset - RAW_SECTOR_SIZE) : 0);
-  DataMap::iterator current = m_data_map.begin();
-  while (next != m_data_map.end() && next->first <= disc_offset)
-    current = next++;
+  DataMap::const_iterator current = FindChunk(disc_offset);
 
   // extra bytes if we need to buffer some at the start
-  m_chunk_start = current->first;
+  m_chunk_start = current->disc_offset;
   m_chunk_buffer.clear();
   if (m_chunk_start < disc_offset)
-    size += (disc_offset - current->first);
+    size += (disc_offset - current->disc_offset);
 
   u32 total_bytes_read = 0;
   while (total_bytes_read < size)
   {
-    if (current == m_data_map.end() || std::fseek(m_fp, current->second.file_offset, SEEK_SET) != 0)
+    if (current == m_data_map.end())
       return false;
 
-    const u32 chunk_size = current->second.chunk_size;
+    const u32 chunk_size = current->chunk_size;
     const u32 chunk_start = static_cast<u32>(m_chunk_buffer.size());
     m_chunk_buffer.resize(chunk_start + chunk_size);
+    if (!DecodeChunk(*current, &m_chunk_buffer[chunk_start]))
+      return false;
 
-    if (current->second.type == SectorType::Raw)
+    total_bytes_read += chunk_size;
+    ++current;
+  }
+
+  return true;
+}
+
+bool CDImageEcm::ReadFileData(u32 file_offset, void* dst, u32 size) const
+{
+  // the mapping is safe to read from several threads, m_fp is only ever used by the reader
+  if (m_mapping.IsValid())
+  {
+    if (file_offset >= m_mapping.GetSize() || (m_mapping.GetSize() - file_offset) < size)
+      return false;
+
+    std::memcpy(dst, m_mapping.GetData() + file_offset, size);
+    return true;
+  }
+
+  return (std::fseek(m_fp, file_offset, SEEK_SET) == 0 && std::fread(dst, size, 1, m_fp) == 1);
+}
+
+bool CDImageEcm::DecodeChunk(const SectorEntry& entry, u8* dst) const
+{
+  if (entry.type == SectorType::Raw)
+    return ReadFileData(entry.file_offset, dst, entry.chunk_size);
+
+  u8 sector[RAW_SECTOR_SIZE];
+
+  // TODO: needed?
+  std::memset(sector, 0, RAW_SECTOR_SIZE);
+  std::memset(sector + 1, 0xFF, 10);
+
+  u32 skip;
+  switch (entry.type)
+  {
+    case SectorType::Mode1:
     {
-      if (std::fread(&m_chunk_buffer[chunk_start], chunk_size, 1, m_fp) != 1)
+      sector[0x0F] = 0x01;
+      if (!ReadFileData(entry.file_offset, sector + 0x00C, 0x003) ||
+          !ReadFileData(entry.file_offset + 0x003, sector + 0x010, 0x800))
+      {
         return false;
+      }
 
-      total_bytes_read += chunk_size;
+      CDECC::GenerateEDCECC(sector, CDECC::SectorType::Mode1);
+      skip = 0;
     }
-    else
+    break;
+
+    case SectorType::Mode2Form1:
     {
-      // u8* sector = &m_chunk_buffer[chunk_start];
-      u8 sector[RAW_SECTOR_SIZE];
+      sector[0x0F] = 0x02;
+      if (!ReadFileData(entry.file_offset, sector + 0x014, 0x804))
+        return false;
 
-      // TODO: needed?
-      std::memset(sector, 0, RAW_SECTOR_SIZE);
-      std::memset(sector + 1, 0xFF, 10);
+      sector[0x10] = sector[0x14];
+      sector[0x11] = sector[0x15];
+      sector[0x12] = sector[0x16];
+      sector[0x13] = sector[0x17];
 
-      u32 skip;
-      switch (current->second.type)
-      {
-        case SectorType::Mode1:
-        {
-          sector[0x0F] = 0x01;
-          if (std::fread(sector + 0x00C, 0x003, 1, m_fp) != 1 || std::fread(sector + 0x010, 0x800, 1, m_fp) != 1)
-            return false;
-
-          eccedc_generate(sector, 1);
-          skip = 0;
-        }
-        break;
+      CDECC::GenerateEDCECC(sector, CDECC::SectorType::Mode2Form1);
+      skip = 0x10;
+    }
+    break;
 
-        case SectorType::Mode2Form1:
-        {
-          sector[0x0F] = 0x02;
-          if (std::fread(sector + 0x014, 0x804, 1, m_fp) != 1)
-            return false;
+    case SectorType::Mode2Form2:
+    {
+      sector[0x0F] = 0x02;
+      if (!ReadFileData(entry.file_offset, sector + 0x014, 0x918))
+        return false;
 
-          sector[0x10] = sector[0x14];
-          sector[0x11] = sector[0x15];
-          sector[0x12] = sector[0x16];
-          sector[0x13] = sector[0x17];
+      sector[0x10] = sector[0x14];
+      sector[0x11] = sector[0x15];
+      sector[0x12] = sector[0x16];
+      sector[0x13] = sector[0x17];
 
-          eccedc_generate(sector, 2);
-          skip = 0x10;
-        }
-        break;
+      CDECC::GenerateEDCECC(sector, CDECC::SectorType::Mode2Form2);
+      skip = 0x10;
+    }
+    break;
 
-        case SectorType::Mode2Form2:
-        {
-          sector[0x0F] = 0x02;
-          if (std::fread(sector + 0x014, 0x918, 1, m_fp) != 1)
-            return false;
+    default:
+      UnreachableCode();
+      return false;
+  }
 
-          sector[0x10] = sector[0x14];
-          sector[0x11] = sector[0x15];
-          sector[0x12] = sector[0x16];
-          sector[0x13] = sector[0x17];
+  std::memcpy(dst, sector + skip, entry.chunk_size);
+  return true;
+}
 
-          eccedc_generate(sector, 3);
-          skip = 0x10;
-        }
-        break;
+bool CDImageEcm::DecodeBlock(u32 block_index, u8* dst) const
+{
+  const u32 block_start = block_index * BLOCK_SIZE;
+  const u32 block_end = std::min(block_start + BLOCK_SIZE, m_lba_count * RAW_SECTOR_SIZE);
+
+  // the last block is only partially used
+  if ((block_end - block_start) < BLOCK_SIZE)
+    std::memset(dst + (block_end - block_start), 0, BLOCK_SIZE - (block_end - block_start));
+
+  // chunks don't line up with sectors, so they can straddle the block boundaries
+  u8 chunk[RAW_SECTOR_SIZE];
+  DataMap::const_iterator current = FindChunk(block_start);
+  u32 disc_offset = block_start;
+  while (disc_offset < block_end)
+  {
+    if (current == m_data_map.end() || current->disc_offset > disc_offset ||
+        (current->disc_offset + current->chunk_size) <= disc_offset)
+    {
+      return false;
+    }
 
-        default:
-          UnreachableCode();
-          return false;
-      }
+    const u32 offset_in_chunk = disc_offset - current->disc_offset;
+    const u32 copy_size = std::min(current->disc_offset + current->chunk_size, block_end) - disc_offset;
+    if (current->type == SectorType::Raw)
+    {
+      if (!ReadFileData(current->file_offset + offset_in_chunk, dst + (disc_offset - block_start), copy_size))
+        return false;
+    }
+    else
+    {
+      if (!DecodeChunk(*current, chunk))
+        return false;
 
-      std::memcpy(&m_chunk_buffer[chunk_start], sector + skip, chunk_size);
-      total_bytes_read += chunk_size;
+      std::memcpy(dst + (disc_offset - block_start), chunk + offset_in_chunk, copy_size);
     }
 
+    disc_offset += copy_size;
     ++current;
   }
 
@@ -528,11 +637,63 @@ bool CDImageEcm::HasNonStandardSubchannel() const
   return (m_sbi.GetReplacementSectorCount() > 0);
 }
 
+CDImage::PrecacheResult CDImageEcm::Precache(ProgressCallback* progress)
+{
+  // workers decode from the mapping, the blocks are decoded in the background while the disc is read
+  if (!m_mapping.IsValid())
+    return CDImage::PrecacheResult::Unsupported;
+
+  if (!m_block_cache.StartPrecache())
+    return CDImage::PrecacheResult::ReadError;
+
+  if (progress == ProgressCallback::NullProgressCallback)
+    return CDImage::PrecacheResult::Success;
+
+  const std::string_view title(FileSystem::GetDisplayNameFromPath(m_filename));
+  progress->SetFormattedStatusText("Precaching %.*s...", static_cast<int>(title.size()), title.data());
+  return m_block_cache.WaitForPrecache(progress) ? CDImage::PrecacheResult::Success :
+                                                   CDImage::PrecacheResult::ReadError;
+}
+
 bool CDImageEcm::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index)
 {
   const u32 file_start = static_cast<u32>(index.file_offset) + (lba_in_index * index.file_sector_size);
   const u32 file_end = file_start + RAW_SECTOR_SIZE;
 
+  if (m_block_cache.IsEnabled())
+  {
+    const u32 block_index = file_start / BLOCK_SIZE;
+    const u32 last_block_index = m_last_block_index;
+    m_last_block_index = block_index;
+
+    if (m_current_block != block_index)
+    {
+      if (m_block_cache.Lookup(block_index, m_block_buffer.data()))
+      {
+        m_current_block = block_index;
+      }
+      else if (block_index == (last_block_index + 1))
+      {
+        // decoding a whole block only pays off when reading sequentially, a lone sector is cheaper through the chunks
+        if (!DecodeBlock(block_index, m_block_buffer.data()))
+        {
+          Log_ErrorPrintf("Failed to decode block %u", block_index);
+          m_current_block = static_cast<u32>(-1);
+          return false;
+        }
+
+        m_block_cache.Insert(block_index, m_block_buffer.data());
+        m_current_block = block_index;
+      }
+    }
+
+    if (m_current_block == block_index)
+    {
+      std::memcpy(buffer, &m_block_buffer[file_start % BLOCK_SIZE], RAW_SECTOR_SIZE);
+      return true;
+    }
+  }
+
   if (file_start < m_chunk_start || file_end > (m_chunk_start + m_chunk_buffer.size()))
   {
     if (!ReadChunks(file_start, RAW_SECTOR_SIZE))
@@ -1,80 +1,290 @@
 #include "cd_image_hasher.h"
 #include "cd_image.h"
+#include "common/file_system.h"
 #include "common/md5_digest.h"
 #include "common/string_util.h"
+#include "common/thirdparty/thread_pool.h"
+#include "xxhash.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace CDImageHasher {
 
-static bool ReadIndex(CDImage* image, u8 track, u8 index, MD5Digest* digest, ProgressCallback* progress_callback)
+namespace {
+class Digest
 {
-  const CDImage::LBA index_start = image->GetTrackIndexPosition(track, index);
-  const u32 index_length = image->GetTrackIndexLength(track, index);
-  const u32 update_interval = std::max<u32>(index_length / 100u, 1u);
-
-  progress_callback->SetFormattedStatusText("Computing hash for track %u/index %u...", track, index);
-  progress_callback->SetProgressRange(index_length);
+public:
+  explicit Digest(bool fast) : m_xxh3(fast ? XXH3_createState() : nullptr)
+  {
+    if (m_xxh3)
+      XXH3_128bits_reset(m_xxh3);
+  }
 
-  if (!image->Seek(index_start))
+  ~Digest()
   {
-    progress_callback->DisplayFormattedModalError("Failed to seek to sector %u for track %u index %u", index_start,
-                                                  track, index);
-    return false;
+    if (m_xxh3)
+      XXH3_freeState(m_xxh3);
   }
 
-  std::array<u8, CDImage::RAW_SECTOR_SIZE> sector;
-  for (u32 lba = 0; lba < index_length; lba++)
+  void Update(const void* data, u32 size)
   {
-    if ((lba % update_interval) == 0)
-      progress_callback->SetProgressValue(lba);
+    if (m_xxh3)
+      XXH3_128bits_update(m_xxh3, data, size);
+    else
+      m_md5.Update(data, size);
+  }
 
-    if (!image->ReadRawSector(sector.data(), nullptr))
+  void Final(Hash* hash)
+  {
+    if (m_xxh3)
     {
-      progress_callback->DisplayFormattedModalError("Failed to read sector %u from image", image->GetPositionOnDisc());
-      return false;
+      XXH128_canonical_t canonical;
+      XXH128_canonicalFromHash(&canonical, XXH3_128bits_digest(m_xxh3));
+      std::memcpy(hash->data(), canonical.digest, sizeof(canonical.digest));
     }
+    else
+    {
+      m_md5.Final(hash->data());
+    }
+  }
+
+private:
+  MD5Digest m_md5;
+  XXH3_state_t* m_xxh3;
+};
+
+struct HashState
+{
+  std::atomic<u32> sectors_done{0};
+  std::atomic_bool cancelled{false};
+  std::mutex error_mutex;
+  std::string error;
 
-    digest->Update(sector.data(), static_cast<u32>(sector.size()));
+  void SetError(std::string message)
+  {
+    std::unique_lock lock(error_mutex);
+    if (error.empty())
+      error = std::move(message);
   }
+};
 
-  progress_callback->SetProgressValue(index_length);
-  return true;
+struct FastHashCacheEntry
+{
+  std::time_t modification_time;
+  s64 size;
+  std::time_t patch_modification_time;
+  s64 patch_size;
+  Hash hash;
+};
+} // namespace
+
+static constexpr u8 INDICES_TO_READ = 2;
+static constexpr u32 READ_CHUNK_SECTORS = 64;
+
+static std::mutex s_fast_hash_cache_mutex;
+static std::unordered_map<std::string, FastHashCacheEntry> s_fast_hash_cache;
+
+static u8 GetFirstIndexToRead(u8 track)
+{
+  // skip index 0 if data track
+  return (track == 1) ? 1 : 0;
 }
 
-static bool ReadTrack(CDImage* image, u8 track, MD5Digest* digest, ProgressCallback* progress_callback)
+static u32 GetTrackHashLength(CDImage* image, u8 track)
 {
-  static constexpr u8 INDICES_TO_READ = 2;
+  u32 length = 0;
+  for (u8 index = GetFirstIndexToRead(track); index < INDICES_TO_READ; index++)
+    length += image->GetTrackIndexLength(track, index);
 
-  progress_callback->PushState();
+  return length;
+}
 
-  const bool dataTrack = track == 1;
-  progress_callback->SetProgressRange(dataTrack ? 1 : 2);
+// Reads the track in chunks, hashing each chunk on the pool while the next one is being read.
+static bool HashTrack(CDImage* image, u8 track, Digest* digest, cb::ThreadPool* hash_pool, HashState* state)
+{
+  std::array<std::vector<u8>, 2> buffers;
+  u32 current_buffer = 0;
+  std::future<void> pending_hash;
+  bool result = true;
 
-  u8 progress = 0;
-  for (u8 index = 0; index < INDICES_TO_READ; index++)
+  for (u8 index = GetFirstIndexToRead(track); index < INDICES_TO_READ && result; index++)
   {
-    progress_callback->SetProgressValue(progress);
+    const CDImage::LBA index_start = image->GetTrackIndexPosition(track, index);
+    const u32 index_length = image->GetTrackIndexLength(track, index);
+    if (!image->Seek(index_start))
+    {
+      state->SetError(StringUtil::StdStringFromFormat("Failed to seek to sector %u for track %u index %u", index_start,
+                                                      track, index));
+      result = false;
+      break;
+    }
 
-    // skip index 0 if data track
-    if (dataTrack && index == 0)
-      continue;
+    for (u32 lba = 0; lba < index_length;)
+    {
+      if (state->cancelled.load(std::memory_order_relaxed))
+      {
+        result = false;
+        break;
+      }
+
+      const u32 count = std::min(index_length - lba, READ_CHUNK_SECTORS);
+      std::vector<u8>& buffer = buffers[current_buffer];
+      buffer.resize(count * CDImage::RAW_SECTOR_SIZE);
+      for (u32 i = 0; i < count && result; i++)
+      {
+        if (!image->ReadRawSector(&buffer[i * CDImage::RAW_SECTOR_SIZE], nullptr))
+        {
+          state->SetError(
+            StringUtil::StdStringFromFormat("Failed to read sector %u from image", image->GetPositionOnDisc()));
+          result = false;
+        }
+      }
+      if (!result)
+        break;
+
+      // previous chunk has to be hashed before this one, and its buffer is reused for the next read
+      if (pending_hash.valid())
+        pending_hash.wait();
+      pending_hash = hash_pool->ScheduleAndGetFuture(
+        [digest, &buffer]() { digest->Update(buffer.data(), static_cast<u32>(buffer.size())); });
+
+      current_buffer ^= 1;
+      lba += count;
+      state->sectors_done.fetch_add(count, std::memory_order_relaxed);
+    }
+  }
+
+  if (pending_hash.valid())
+    pending_hash.wait();
+
+  return result;
+}
+
+// Waits for the jobs on the calling thread, which is where the progress callback has to be used from.
+static bool WaitForJobs(std::vector<std::future<bool>>& jobs, HashState* state, u32 total_sectors,
+                        ProgressCallback* progress_callback)
+{
+  progress_callback->SetProgressRange(std::max(total_sectors, 1u));
+  progress_callback->SetProgressValue(0);
 
-    progress++;
-    progress_callback->PushState();
-    if (!ReadIndex(image, track, index, digest, progress_callback))
+  bool result = true;
+  for (std::future<bool>& job : jobs)
+  {
+    while (job.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready)
     {
-      progress_callback->PopState();
-      progress_callback->PopState();
-      return false;
+      progress_callback->SetProgressValue(state->sectors_done.load(std::memory_order_relaxed));
+      if (progress_callback->IsCancelled())
+        state->cancelled.store(true);
     }
 
-    progress_callback->PopState();
+    result &= job.get();
+  }
+
+  if (!result)
+  {
+    if (!state->error.empty())
+      progress_callback->ModalError(state->error.c_str());
+
+    return false;
   }
 
-  progress_callback->SetProgressValue(progress);
-  progress_callback->PopState();
+  progress_callback->SetProgressValue(std::max(total_sectors, 1u));
   return true;
 }
 
+// Hashes a sequence of tracks into a single digest, with reads overlapped with hashing.
+static bool HashTracksSequentially(CDImage* image, u8 first_track, u8 last_track, Digest* digest,
+                                   ProgressCallback* progress_callback)
+{
+  u32 total_sectors = 0;
+  for (u8 track = first_track; track <= last_track; track++)
+    total_sectors += GetTrackHashLength(image, track);
+
+  cb::ThreadPool read_pool(1);
+  cb::ThreadPool hash_pool(1);
+  HashState state;
+  std::vector<std::future<bool>> jobs;
+  jobs.push_back(read_pool.ScheduleAndGetFuture([image, first_track, last_track, digest, &hash_pool, &state]() {
+    for (u8 track = first_track; track <= last_track; track++)
+    {
+      if (!HashTrack(image, track, digest, &hash_pool, &state))
+        return false;
+    }
+
+    return true;
+  }));
+
+  return WaitForJobs(jobs, &state, total_sectors, progress_callback);
+}
+
+// Hashes each track into its own digest. Seeking and reading isn't thread safe, so each worker gets its own instance
+// of the image, and pulls tracks until they're all done.
+static bool HashTracksConcurrently(CDImage* image, bool fast, std::vector<Hash>* out_hashes,
+                                   ProgressCallback* progress_callback)
+{
+  const u32 track_count = image->GetTrackCount();
+  const u32 max_workers = std::min(std::max(cb::ThreadPool::GetNumLogicalCores() / 2, 1u), track_count);
+
+  std::vector<std::unique_ptr<CDImage>> reopened_images;
+  std::vector<CDImage*> images;
+  images.push_back(image);
+  while (images.size() < max_workers)
+  {
+    std::unique_ptr<CDImage> worker_image = CDImage::Open(image->GetFileName().c_str(), nullptr);
+    if (!worker_image ||
+        (image->HasSubImages() && !worker_image->SwitchSubImage(image->GetCurrentSubImage(), nullptr)) ||
+        worker_image->GetTrackCount() != track_count)
+    {
+      // memory images etc can't be opened again, just use what we have
+      break;
+    }
+
+    worker_image->SetSectorCacheEnabled(false);
+    images.push_back(worker_image.get());
+    reopened_images.push_back(std::move(worker_image));
+  }
+
+  u32 total_sectors = 0;
+  for (u32 track = 1; track <= track_count; track++)
+    total_sectors += GetTrackHashLength(image, static_cast<u8>(track));
+
+  const u32 num_workers = static_cast<u32>(images.size());
+  cb::ThreadPool read_pool(static_cast<int>(num_workers));
+  cb::ThreadPool hash_pool(static_cast<int>(num_workers));
+  HashState state;
+  std::atomic<u32> next_track{1};
+  out_hashes->resize(track_count);
+
+  std::vector<std::future<bool>> jobs;
+  for (CDImage* worker_image : images)
+  {
+    jobs.push_back(read_pool.ScheduleAndGetFuture([worker_image, fast, track_count, out_hashes, &hash_pool, &state,
+                                                   &next_track]() {
+      for (;;)
+      {
+        const u32 track = next_track.fetch_add(1);
+        if (track > track_count)
+          return true;
+
+        Digest digest(fast);
+        if (!HashTrack(worker_image, static_cast<u8>(track), &digest, &hash_pool, &state))
+          return false;
+
+        digest.Final(&(*out_hashes)[track - 1]);
+      }
+    }));
+  }
+
+  progress_callback->SetFormattedStatusText("Computing hashes for %u tracks...", track_count);
+  return WaitForJobs(jobs, &state, total_sectors, progress_callback);
+}
+
 std::string HashToString(const Hash& hash)
 {
   return StringUtil::StdStringFromFormat("%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x%02x", hash[0],
@@ -96,35 +306,76 @@ std::optional<Hash> HashFromString(const std::string_view& str) {
 bool GetImageHash(CDImage* image, Hash* out_hash,
                   ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
 {
-  MD5Digest digest;
+  Digest digest(false);
 
-  progress_callback->SetProgressRange(image->GetTrackCount());
-  progress_callback->SetProgressValue(0);
-  progress_callback->PushState();
-
-  for (u32 i = 1; i <= image->GetTrackCount(); i++)
-  {
-    progress_callback->SetProgressValue(i - 1);
-    if (!ReadTrack(image, static_cast<u8>(i), &digest, progress_callback))
-    {
-      progress_callback->PopState();
-      return false;
-    }
-  }
+  progress_callback->SetFormattedStatusText("Computing hash for %u tracks...", image->GetTrackCount());
+  if (!HashTracksSequentially(image, 1, static_cast<u8>(image->GetTrackCount()), &digest, progress_callback))
+    return false;
 
-  progress_callback->SetProgressValue(image->GetTrackCount());
-  digest.Final(out_hash->data());
+  digest.Final(out_hash);
   return true;
 }
 
 bool GetTrackHash(CDImage* image, u8 track, Hash* out_hash,
                   ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
 {
-  MD5Digest digest;
-  if (!ReadTrack(image, track, &digest, progress_callback))
+  Digest digest(false);
+
+  progress_callback->SetFormattedStatusText("Computing hash for track %u...", track);
+  if (!HashTracksSequentially(image, track, track, &digest, progress_callback))
     return false;
 
-  digest.Final(out_hash->data());
+  digest.Final(out_hash);
+  return true;
+}
+
+bool GetTrackHashes(CDImage* image, std::vector<Hash>* out_hashes,
+                    ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
+{
+  return HashTracksConcurrently(image, false, out_hashes, progress_callback);
+}
+
+bool GetImageFastHash(CDImage* image, Hash* out_hash,
+                      ProgressCallback* progress_callback /*= ProgressCallback::NullProgressCallback*/)
+{
+  // a PPF patch changes the contents without touching the image file, so it's part of the key too
+  const std::string& patch_filename = image->GetPatchFileName();
+  const std::string cache_key = StringUtil::StdStringFromFormat(
+    "%s:%u:%s", image->GetFileName().c_str(), image->GetCurrentSubImage(), patch_filename.c_str());
+  FILESYSTEM_STAT_DATA sd = {};
+  FILESYSTEM_STAT_DATA patch_sd = {};
+  const bool has_stat = FileSystem::StatFile(image->GetFileName().c_str(), &sd) &&
+                        (patch_filename.empty() || FileSystem::StatFile(patch_filename.c_str(), &patch_sd));
+  if (has_stat)
+  {
+    std::unique_lock lock(s_fast_hash_cache_mutex);
+    const auto iter = s_fast_hash_cache.find(cache_key);
+    if (iter != s_fast_hash_cache.end() && iter->second.modification_time == sd.ModificationTime &&
+        iter->second.size == sd.Size && iter->second.patch_modification_time == patch_sd.ModificationTime &&
+        iter->second.patch_size == patch_sd.Size)
+    {
+      *out_hash = iter->second.hash;
+      return true;
+    }
+  }
+
+  // tracks are hashed independently so they can be done in parallel, the image hash is the hash of the track hashes
+  std::vector<Hash> track_hashes;
+  if (!HashTracksConcurrently(image, true, &track_hashes, progress_callback))
+    return false;
+
+  Digest digest(true);
+  for (const Hash& track_hash : track_hashes)
+    digest.Update(track_hash.data(), static_cast<u32>(track_hash.size()));
+  digest.Final(out_hash);
+
+  if (has_stat)
+  {
+    std::unique_lock lock(s_fast_hash_cache_mutex);
+    s_fast_hash_cache[cache_key] =
+      FastHashCacheEntry{sd.ModificationTime, sd.Size, patch_sd.ModificationTime, patch_sd.Size, *out_hash};
+  }
+
   return true;
 }
 
@@ -4,6 +4,7 @@
 #include <array>
 #include <optional>
 #include <string>
+#include <vector>
 
 class CDImage;
 
@@ -18,4 +19,14 @@ bool GetImageHash(CDImage* image, Hash* out_hash,
 bool GetTrackHash(CDImage* image, u8 track, Hash* out_hash,
                   ProgressCallback* progress_callback = ProgressCallback::NullProgressCallback);
 
+/// Computes the MD5 of every track, which is what redump lists. Tracks are hashed concurrently on separate instances
+/// of the image, so this is much faster than calling GetTrackHash() for each track.
+bool GetTrackHashes(CDImage* image, std::vector<Hash>* out_hashes,
+                    ProgressCallback* progress_callback = ProgressCallback::NullProgressCallback);
+
+/// Computes a XXH3-128 hash of the whole image, for identifying images when compatibility with MD5/redump isn't needed.
+/// Results are cached by path, patch and modification time, so asking again for an unchanged file doesn't read it.
+bool GetImageFastHash(CDImage* image, Hash* out_hash,
+                      ProgressCallback* progress_callback = ProgressCallback::NullProgressCallback);
+
 } // namespace CDImageHasher
\ No newline at end of file
@@ -28,7 +28,10 @@ private:
   CDSubChannelReplacement m_sbi;
 };
 
-CDImageMemory::CDImageMemory() = default;
+CDImageMemory::CDImageMemory()
+{
+  m_use_sector_cache = false;
+}
 
 CDImageMemory::~CDImageMemory()
 {
@@ -108,6 +111,7 @@ bool CDImageMemory::CopyImage(CDImage* image, ProgressCallback* progress)
 
   Assert(current_offset == m_memory_sectors);
   m_filename = image->GetFileName();
+  m_patch_filename = image->GetPatchFileName();
   m_lba_count = image->GetLBACount();
 
   m_sbi.LoadSBI(Path::ReplaceExtension(m_filename, "sbi").c_str());
@@ -6,6 +6,8 @@
 #include "common/log.h"
 #include "common/path.h"
 #include "common/string_util.h"
+#include "compressed_block_cache.h"
+#include "mapped_file.h"
 #include "pbp_types.h"
 #include "string.h"
 #include "zlib.h"
@@ -35,6 +37,7 @@ public:
   bool SwitchSubImage(u32 index, Common::Error* error) override;
   std::string GetMetadata(const std::string_view& type) const override;
   std::string GetSubImageMetadata(u32 index, const std::string_view& type) const override;
+  PrecacheResult Precache(ProgressCallback* progress) override;
 
 protected:
   bool ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_in_index) override;
@@ -62,6 +65,8 @@ private:
 
   bool InitDecompressionStream();
   bool DecompressBlock(const BlockInfo& block_info);
+  bool DecompressBlockFromMapping(u32 block_index, u8* dst) const;
+  static bool InflateBlock(z_stream* stream, const u8* src, u32 src_size, u8* dst);
 
   bool OpenDisc(u32 index, Common::Error* error);
 
@@ -89,6 +94,10 @@ private:
 
   z_stream m_inflate_stream;
 
+  // Mapping the file lets the prefetch and precache workers read blocks without sharing m_file.
+  MappedFile m_mapping;
+  CompressedBlockCache m_block_cache;
+
   CDSubChannelReplacement m_sbi;
 };
 
@@ -121,6 +130,9 @@ static void SwapByteOrder(T& val)
 
 CDImagePBP::~CDImagePBP()
 {
+  // workers read from the mapping
+  m_block_cache.Clear();
+
   if (m_file)
     fclose(m_file);
 
@@ -338,6 +350,10 @@ bool CDImagePBP::Open(const char* filename, Common::Error* error)
     return false;
   }
 
+  // without the mapping we can still read through m_file, but nothing can be decompressed in parallel
+  if (!m_mapping.Map(m_file))
+    Log_WarningPrintf("Failed to map '%s', prefetching and precaching will be unavailable", filename);
+
   m_filename = filename;
 
   // Read in PBP header
@@ -449,6 +465,7 @@ bool CDImagePBP::OpenDisc(u32 index, Common::Error* error)
     return false;
   }
 
+  m_block_cache.Clear();
   m_current_block = static_cast<u32>(-1);
   m_blockinfo_table.fill({});
   m_toc.fill({});
@@ -682,6 +699,19 @@ bool CDImagePBP::OpenDisc(u32 index, Common::Error* error)
   else
     m_sbi.LoadSBI(Path::ReplaceExtension(m_filename, "sbi").c_str());
 
+  const u32 block_count = std::min<u32>((m_lba_count + SECTORS_PER_BLOCK - 1) / SECTORS_PER_BLOCK,
+                                        BLOCK_TABLE_NUM_ENTRIES);
+  if (m_mapping.IsValid())
+  {
+    m_block_cache.Initialize(DECOMPRESSED_BLOCK_SIZE, block_count, [this](u32 block_index, u8* dst) {
+      return DecompressBlockFromMapping(block_index, dst);
+    });
+  }
+  else
+  {
+    m_block_cache.Initialize(DECOMPRESSED_BLOCK_SIZE, block_count, {});
+  }
+
   m_current_disc = index;
   return Seek(1, Position{0, 0, 0});
 }
@@ -714,6 +744,15 @@ bool CDImagePBP::InitDecompressionStream()
 
 bool CDImagePBP::DecompressBlock(const BlockInfo& block_info)
 {
+  if (m_mapping.IsValid())
+  {
+    if ((static_cast<u64>(block_info.offset) + block_info.size) > m_mapping.GetSize())
+      return false;
+
+    return InflateBlock(&m_inflate_stream, m_mapping.GetData() + block_info.offset, block_info.size,
+                        m_decompressed_block.data());
+  }
+
   if (FSeek64(m_file, block_info.offset, SEEK_SET) != 0)
     return false;
 
@@ -729,15 +768,51 @@ bool CDImagePBP::DecompressBlock(const BlockInfo& block_info)
   if (fread(m_compressed_block.data(), sizeof(u8), m_compressed_block.size(), m_file) != m_compressed_block.size())
     return false;
 
-  m_inflate_stream.next_in = m_compressed_block.data();
-  m_inflate_stream.avail_in = static_cast<uInt>(m_compressed_block.size());
-  m_inflate_stream.next_out = m_decompressed_block.data();
-  m_inflate_stream.avail_out = static_cast<uInt>(m_decompressed_block.size());
+  return InflateBlock(&m_inflate_stream, m_compressed_block.data(), block_info.size, m_decompressed_block.data());
+}
+
+bool CDImagePBP::DecompressBlockFromMapping(u32 block_index, u8* dst) const
+{
+  const BlockInfo& block_info = m_blockinfo_table[block_index];
+
+  // gaps in the block table are never read, but the precache workers still get to them
+  if (block_info.size == 0)
+  {
+    std::memset(dst, 0, DECOMPRESSED_BLOCK_SIZE);
+    return true;
+  }
 
-  if (inflateReset(&m_inflate_stream) != Z_OK)
+  if ((static_cast<u64>(block_info.offset) + block_info.size) > m_mapping.GetSize())
     return false;
 
-  int err = inflate(&m_inflate_stream, Z_FINISH);
+  // m_inflate_stream belongs to the reader, setting up another is cheap next to inflating a whole block
+  z_stream stream = {};
+  if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+    return false;
+
+  const bool result = InflateBlock(&stream, m_mapping.GetData() + block_info.offset, block_info.size, dst);
+  inflateEnd(&stream);
+  return result;
+}
+
+bool CDImagePBP::InflateBlock(z_stream* stream, const u8* src, u32 src_size, u8* dst)
+{
+  // Level 0 blocks are stored as-is.
+  if (src_size == DECOMPRESSED_BLOCK_SIZE)
+  {
+    std::memcpy(dst, src, DECOMPRESSED_BLOCK_SIZE);
+    return true;
+  }
+
+  stream->next_in = const_cast<Bytef*>(src);
+  stream->avail_in = static_cast<uInt>(src_size);
+  stream->next_out = dst;
+  stream->avail_out = static_cast<uInt>(DECOMPRESSED_BLOCK_SIZE);
+
+  if (inflateReset(stream) != Z_OK)
+    return false;
+
+  int err = inflate(stream, Z_FINISH);
   if (err != Z_STREAM_END)
   {
     Log_ErrorPrintf("Inflate error %d", err);
@@ -747,6 +822,24 @@ bool CDImagePBP::DecompressBlock(const BlockInfo& block_info)
   return true;
 }
 
+CDImage::PrecacheResult CDImagePBP::Precache(ProgressCallback* progress)
+{
+  // workers inflate from the mapping, the blocks are decompressed in the background while the disc is read
+  if (!m_mapping.IsValid())
+    return CDImage::PrecacheResult::Unsupported;
+
+  if (!m_block_cache.StartPrecache())
+    return CDImage::PrecacheResult::ReadError;
+
+  if (progress == ProgressCallback::NullProgressCallback)
+    return CDImage::PrecacheResult::Success;
+
+  const std::string_view title(FileSystem::GetDisplayNameFromPath(m_filename));
+  progress->SetFormattedStatusText("Precaching %.*s...", static_cast<int>(title.size()), title.data());
+  return m_block_cache.WaitForPrecache(progress) ? CDImage::PrecacheResult::Success :
+                                                   CDImage::PrecacheResult::ReadError;
+}
+
 bool CDImagePBP::ReadSubChannelQ(SubChannelQ* subq, const Index& index, LBA lba_in_index)
 {
   if (m_sbi.GetReplacementSubChannelQ(index.start_lba_on_disc + lba_in_index, subq))
@@ -774,10 +867,22 @@ bool CDImagePBP::ReadSectorFromIndex(void* buffer, const Index& index, LBA lba_i
     return false;
   }
 
-  if (m_current_block != requested_block && !DecompressBlock(bi))
+  if (m_current_block != requested_block)
   {
-    Log_ErrorPrintf("Failed to decompress block %u", requested_block);
-    return false;
+    if (!m_block_cache.IsEnabled() || !m_block_cache.Lookup(requested_block, m_decompressed_block.data()))
+    {
+      if (!DecompressBlock(bi))
+      {
+        Log_ErrorPrintf("Failed to decompress block %u", requested_block);
+        m_current_block = static_cast<u32>(-1);
+        return false;
+      }
+
+      if (m_block_cache.IsEnabled())
+        m_block_cache.Insert(requested_block, m_decompressed_block.data());
+    }
+
+    m_current_block = requested_block;
   }
 
   std::memcpy(buffer, &m_decompressed_block[offset_in_block], RAW_SECTOR_SIZE);
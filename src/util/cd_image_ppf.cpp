@@ -73,6 +73,7 @@ bool CDImagePPF::Open(const char* filename, std::unique_ptr<CDImage> parent_imag
 
   // copy all the stuff from the parent image
   m_filename = parent_image->GetFileName();
+  m_patch_filename = filename;
   m_tracks = parent_image->GetTracks();
   m_indices = parent_image->GetIndices();
   m_parent_image = std::move(parent_image);
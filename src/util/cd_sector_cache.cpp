@@ -0,0 +1,298 @@
+#include "cd_sector_cache.h"
+#include "common/log.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cinttypes>
+#include <cstring>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+Log_SetChannel(CDSectorCache);
+
+namespace CDSectorCache {
+namespace {
+struct SectorKey
+{
+  u32 image_id;
+  u32 sub_image;
+  CDImage::LBA lba;
+
+  bool operator==(const SectorKey& key) const
+  {
+    return (image_id == key.image_id && sub_image == key.sub_image && lba == key.lba);
+  }
+};
+
+struct SectorKeyHash
+{
+  size_t operator()(const SectorKey& key) const
+  {
+    return std::hash<u64>()((static_cast<u64>(key.image_id) << 40) ^ (static_cast<u64>(key.sub_image) << 24) ^ key.lba);
+  }
+};
+
+struct CachedSector
+{
+  SectorKey key;
+  std::array<u8, CDImage::RAW_SECTOR_SIZE> data;
+  CDImage::SubChannelQ subq;
+  bool has_subq;
+  bool pinned;
+};
+
+// Most recently used at the front. Pinned sectors live in their own list, so eviction never has to skip over them.
+using SectorList = std::list<CachedSector>;
+
+struct PinnedRange
+{
+  u32 image_id;
+  u32 sub_image;
+  CDImage::LBA start_lba;
+  u32 count;
+
+  bool Contains(const SectorKey& key) const
+  {
+    return (key.image_id == image_id && key.sub_image == sub_image && key.lba >= start_lba &&
+            (key.lba - start_lba) < count);
+  }
+};
+} // namespace
+
+// Roughly what each sector costs with the list node and hash map entry.
+static constexpr u64 SECTOR_MEMORY_SIZE = sizeof(CachedSector) + 64;
+
+// Pinned sectors can only use part of the budget, past that they're cached like any other sector. Otherwise one large
+// pin could take the whole budget, and nothing else would be cached.
+static constexpr u64 PINNED_BUDGET_DIVISOR = 2;
+
+static bool IsPinned(const SectorKey& key);
+static bool CanPinSector(u64 budget);
+static void EvictToBudget(u64 budget);
+
+static std::atomic<u64> s_memory_budget{0};
+static std::atomic<u32> s_next_image_id{0};
+
+static std::mutex s_mutex;
+static SectorList s_sectors;
+static SectorList s_pinned_sectors;
+static std::unordered_map<SectorKey, SectorList::iterator, SectorKeyHash> s_sector_map;
+static std::vector<PinnedRange> s_pinned_ranges;
+static u64 s_hits = 0;
+static u64 s_misses = 0;
+static u64 s_evictions = 0;
+
+} // namespace CDSectorCache
+
+bool CDSectorCache::IsEnabled()
+{
+  return (s_memory_budget.load(std::memory_order_relaxed) > 0);
+}
+
+u32 CDSectorCache::AllocateImageId()
+{
+  return s_next_image_id.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool CDSectorCache::IsPinned(const SectorKey& key)
+{
+  return std::any_of(s_pinned_ranges.begin(), s_pinned_ranges.end(),
+                     [&key](const PinnedRange& range) { return range.Contains(key); });
+}
+
+bool CDSectorCache::CanPinSector(u64 budget)
+{
+  return (((s_pinned_sectors.size() + 1) * SECTOR_MEMORY_SIZE) <= (budget / PINNED_BUDGET_DIVISOR));
+}
+
+void CDSectorCache::EvictToBudget(u64 budget)
+{
+  // if the budget shrank, the oldest pinned sectors are the first to go
+  while ((s_pinned_sectors.size() * SECTOR_MEMORY_SIZE) > (budget / PINNED_BUDGET_DIVISOR))
+  {
+    s_pinned_sectors.back().pinned = false;
+    s_sectors.splice(s_sectors.end(), s_pinned_sectors, std::prev(s_pinned_sectors.end()));
+  }
+
+  while (!s_sectors.empty() && (s_sector_map.size() * SECTOR_MEMORY_SIZE) > budget)
+  {
+    s_sector_map.erase(s_sectors.back().key);
+    s_sectors.pop_back();
+    s_evictions++;
+  }
+}
+
+bool CDSectorCache::Lookup(u32 image_id, u32 sub_image, CDImage::LBA lba, void* buffer, CDImage::SubChannelQ* subq)
+{
+  std::unique_lock lock(s_mutex);
+  const auto iter = s_sector_map.find(SectorKey{image_id, sub_image, lba});
+  if (iter == s_sector_map.end() || (subq && !iter->second->has_subq))
+  {
+    s_misses++;
+    return false;
+  }
+
+  const SectorList::iterator sector = iter->second;
+  if (buffer)
+    std::memcpy(buffer, sector->data.data(), CDImage::RAW_SECTOR_SIZE);
+  if (subq)
+    *subq = sector->subq;
+
+  if (!sector->pinned)
+    s_sectors.splice(s_sectors.begin(), s_sectors, sector);
+
+  s_hits++;
+  return true;
+}
+
+void CDSectorCache::Insert(u32 image_id, u32 sub_image, CDImage::LBA lba, const void* buffer,
+                           const CDImage::SubChannelQ* subq)
+{
+  const SectorKey key{image_id, sub_image, lba};
+  const u64 budget = s_memory_budget.load(std::memory_order_relaxed);
+
+  std::unique_lock lock(s_mutex);
+  auto iter = s_sector_map.find(key);
+  if (iter != s_sector_map.end())
+  {
+    SectorList::iterator sector = iter->second;
+    if (buffer)
+      std::memcpy(sector->data.data(), buffer, CDImage::RAW_SECTOR_SIZE);
+    if (subq)
+    {
+      sector->subq = *subq;
+      sector->has_subq = true;
+    }
+
+    return;
+  }
+
+  if (!buffer)
+    return;
+
+  const bool pinned = (IsPinned(key) && CanPinSector(budget));
+  SectorList& list = pinned ? s_pinned_sectors : s_sectors;
+  if (((s_sector_map.size() + 1) * SECTOR_MEMORY_SIZE) > budget)
+  {
+    // only happens when the budget is smaller than a couple of sectors
+    if (s_sectors.empty())
+      return;
+
+    // reuse the least recently used sector rather than freeing it and allocating another
+    s_sector_map.erase(s_sectors.back().key);
+    list.splice(list.begin(), s_sectors, std::prev(s_sectors.end()));
+    s_evictions++;
+  }
+  else
+  {
+    list.emplace_front();
+  }
+
+  CachedSector& sector = list.front();
+  sector.key = key;
+  std::memcpy(sector.data.data(), buffer, CDImage::RAW_SECTOR_SIZE);
+  if (subq)
+    sector.subq = *subq;
+  sector.has_subq = (subq != nullptr);
+  sector.pinned = pinned;
+  s_sector_map.emplace(key, list.begin());
+}
+
+void CDSectorCache::RemoveImage(u32 image_id)
+{
+  std::unique_lock lock(s_mutex);
+  s_pinned_ranges.erase(std::remove_if(s_pinned_ranges.begin(), s_pinned_ranges.end(),
+                                       [image_id](const PinnedRange& range) { return (range.image_id == image_id); }),
+                        s_pinned_ranges.end());
+
+  for (SectorList* list : {&s_sectors, &s_pinned_sectors})
+  {
+    for (auto iter = list->begin(); iter != list->end();)
+    {
+      if (iter->key.image_id == image_id)
+      {
+        s_sector_map.erase(iter->key);
+        iter = list->erase(iter);
+      }
+      else
+      {
+        ++iter;
+      }
+    }
+  }
+}
+
+void CDSectorCache::PinRange(u32 image_id, u32 sub_image, CDImage::LBA start_lba, u32 count)
+{
+  if (count == 0)
+    return;
+
+  const u64 budget = s_memory_budget.load(std::memory_order_relaxed);
+
+  std::unique_lock lock(s_mutex);
+  const PinnedRange& range = s_pinned_ranges.emplace_back(PinnedRange{image_id, sub_image, start_lba, count});
+
+  // sectors which are already cached stay cached
+  for (auto iter = s_sectors.begin(); iter != s_sectors.end() && CanPinSector(budget);)
+  {
+    const auto current = iter++;
+    if (range.Contains(current->key))
+    {
+      current->pinned = true;
+      s_pinned_sectors.splice(s_pinned_sectors.begin(), s_sectors, current);
+    }
+  }
+}
+
+void CDSectorCache::UnpinRange(u32 image_id, u32 sub_image, CDImage::LBA start_lba, u32 count)
+{
+  std::unique_lock lock(s_mutex);
+  const auto range = std::find_if(s_pinned_ranges.begin(), s_pinned_ranges.end(), [&](const PinnedRange& r) {
+    return (r.image_id == image_id && r.sub_image == sub_image && r.start_lba == start_lba && r.count == count);
+  });
+  if (range == s_pinned_ranges.end())
+    return;
+
+  s_pinned_ranges.erase(range);
+
+  // overlapping ranges can still be holding on to some of the sectors
+  for (auto iter = s_pinned_sectors.begin(); iter != s_pinned_sectors.end();)
+  {
+    const auto current = iter++;
+    if (current->key.image_id == image_id && !IsPinned(current->key))
+    {
+      current->pinned = false;
+      s_sectors.splice(s_sectors.begin(), s_pinned_sectors, current);
+    }
+  }
+
+  EvictToBudget(s_memory_budget.load(std::memory_order_relaxed));
+}
+
+void CDImage::SetSectorCacheBudget(u64 bytes)
+{
+  const u64 old_budget = CDSectorCache::s_memory_budget.exchange(bytes);
+  if (old_budget == bytes)
+    return;
+
+  Log_InfoPrintf("Sector cache budget is now %" PRIu64 " KB", bytes / 1024);
+
+  std::unique_lock lock(CDSectorCache::s_mutex);
+  CDSectorCache::EvictToBudget(bytes);
+}
+
+CDImage::SectorCacheStats CDImage::GetSectorCacheStats()
+{
+  std::unique_lock lock(CDSectorCache::s_mutex);
+
+  SectorCacheStats stats;
+  stats.hits = CDSectorCache::s_hits;
+  stats.misses = CDSectorCache::s_misses;
+  stats.evictions = CDSectorCache::s_evictions;
+  stats.memory_used = CDSectorCache::s_sector_map.size() * CDSectorCache::SECTOR_MEMORY_SIZE;
+  stats.memory_budget = CDSectorCache::s_memory_budget.load();
+  stats.sector_count = static_cast<u32>(CDSectorCache::s_sector_map.size());
+  stats.pinned_sector_count = static_cast<u32>(CDSectorCache::s_pinned_sectors.size());
+  return stats;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#include "cd_image.h"
+#include "common/types.h"
+
+// Raw sectors read from any image, shared between all open images and limited by a single memory budget. Sectors are
+// evicted least recently used first, unless they're in a range which was pinned by the image.
+namespace CDSectorCache {
+
+/// Returns false if the budget is zero, in which case nothing is looked up or cached.
+bool IsEnabled();
+
+/// Returns a new identifier for an image's sectors. Identifiers aren't reused, so a new image can't see stale sectors.
+u32 AllocateImageId();
+
+/// Copies a cached sector and/or its sub-channel Q. Only succeeds if everything which was asked for is cached.
+bool Lookup(u32 image_id, u32 sub_image, CDImage::LBA lba, void* buffer, CDImage::SubChannelQ* subq);
+
+/// Caches a sector which was read from the image. Sub-channel Q on its own is only added to sectors which are cached.
+void Insert(u32 image_id, u32 sub_image, CDImage::LBA lba, const void* buffer, const CDImage::SubChannelQ* subq);
+
+/// Drops all sectors and pinned ranges of an image.
+void RemoveImage(u32 image_id);
+
+/// Sectors in pinned ranges aren't evicted until the range is unpinned. Pinned sectors can use half of the budget, any
+/// more are evicted like other sectors.
+void PinRange(u32 image_id, u32 sub_image, CDImage::LBA start_lba, u32 count);
+void UnpinRange(u32 image_id, u32 sub_image, CDImage::LBA start_lba, u32 count);
+
+} // namespace CDSectorCache
\ No newline at end of file
@@ -1,56 +1,169 @@
 #include "cd_xa.h"
 #include "cd_image.h"
+#include "common/platform.h"
 #include <algorithm>
 #include <array>
+#include <cstring>
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
 
 namespace CDXA {
 static constexpr std::array<s32, 4> s_xa_adpcm_filter_table_pos = {{0, 60, 115, 98}};
 static constexpr std::array<s32, 4> s_xa_adpcm_filter_table_neg = {{0, 0, -52, -55}};
 
+// Block samples are padded to a whole number of vectors.
+static constexpr u32 WORDS_PER_BLOCK = 28;
+static constexpr u32 PADDED_WORDS_PER_BLOCK = 32;
+
+template<bool IS_8BIT>
+ALWAYS_INLINE static void UnpackXA_ADPCMBlock(const u8* words_ptr, u32 block, u8 shift, s32* out_samples)
+{
+  // The nibble (or the low nibble of the byte, for 8-bit) is moved to the top of the word and the rest masked off, so
+  // that the arithmetic shift down sign extends it, and is equivalent to ((nibble << 12) >> shift) on a 16-bit value.
+  const u32 left_shift = 28 - (block * (IS_8BIT ? 8 : 4));
+  const u32 right_shift = 16 + shift;
+
+#if defined(CPU_X64)
+  const __m128i left_shift_count = _mm_cvtsi32_si128(static_cast<int>(left_shift));
+  const __m128i right_shift_count = _mm_cvtsi32_si128(static_cast<int>(right_shift));
+  const __m128i mask = _mm_set1_epi32(static_cast<int>(0xF0000000u));
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word += 4)
+  {
+    const __m128i words = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&words_ptr[word * sizeof(u32)]));
+    _mm_store_si128(reinterpret_cast<__m128i*>(&out_samples[word]),
+                    _mm_sra_epi32(_mm_and_si128(_mm_sll_epi32(words, left_shift_count), mask), right_shift_count));
+  }
+#elif defined(CPU_AARCH64)
+  const int32x4_t left_shift_count = vdupq_n_s32(static_cast<s32>(left_shift));
+  const int32x4_t right_shift_count = vdupq_n_s32(-static_cast<s32>(right_shift));
+  const uint32x4_t mask = vdupq_n_u32(0xF0000000u);
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word += 4)
+  {
+    const uint32x4_t words = vreinterpretq_u32_u8(vld1q_u8(&words_ptr[word * sizeof(u32)]));
+    const int32x4_t shifted = vreinterpretq_s32_u32(vandq_u32(vshlq_u32(words, left_shift_count), mask));
+    vst1q_s32(&out_samples[word], vshlq_s32(shifted, right_shift_count));
+  }
+#else
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
+  {
+    // NOTE: assumes LE
+    u32 word_data;
+    std::memcpy(&word_data, &words_ptr[word * sizeof(u32)], sizeof(word_data));
+    out_samples[word] = static_cast<s32>((word_data << left_shift) & 0xF0000000u) >> right_shift;
+  }
+#endif
+}
+
+ALWAYS_INLINE static void FilterXA_ADPCMBlock(s32* samples, u8 filter, s32* prev)
+{
+  // This is the only part which can't be vectorized, as every sample depends on the previous two.
+  const s32 filter_pos = s_xa_adpcm_filter_table_pos[filter];
+  const s32 filter_neg = s_xa_adpcm_filter_table_neg[filter];
+  s32 prev0 = prev[0];
+  s32 prev1 = prev[1];
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
+  {
+    const s32 interp_sample = samples[word] + ((prev0 * filter_pos) + (prev1 * filter_neg) + 32) / 64;
+    prev1 = prev0;
+    prev0 = interp_sample;
+    samples[word] = interp_sample;
+  }
+  prev[0] = prev0;
+  prev[1] = prev1;
+}
+
+ALWAYS_INLINE static void StoreXA_ADPCMMonoBlock(const s32* block_samples, s16* out_samples)
+{
+#if defined(CPU_X64)
+  for (u32 word = 0; word < (WORDS_PER_BLOCK - 4); word += 8)
+  {
+    const __m128i packed = _mm_packs_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(&block_samples[word])),
+                                           _mm_load_si128(reinterpret_cast<const __m128i*>(&block_samples[word + 4])));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&out_samples[word]), packed);
+  }
+  const __m128i last = _mm_load_si128(reinterpret_cast<const __m128i*>(&block_samples[WORDS_PER_BLOCK - 4]));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(&out_samples[WORDS_PER_BLOCK - 4]), _mm_packs_epi32(last, last));
+#elif defined(CPU_AARCH64)
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word += 4)
+    vst1_s16(&out_samples[word], vqmovn_s32(vld1q_s32(&block_samples[word])));
+#else
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
+    out_samples[word] = static_cast<s16>(std::clamp<s32>(block_samples[word], -0x8000, 0x7FFF));
+#endif
+}
+
+ALWAYS_INLINE static void StoreXA_ADPCMStereoBlocks(const s32* left_samples, const s32* right_samples,
+                                                    s16* out_samples)
+{
+#if defined(CPU_X64)
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word += 8)
+  {
+    const __m128i left = _mm_packs_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(&left_samples[word])),
+                                         _mm_load_si128(reinterpret_cast<const __m128i*>(&left_samples[word + 4])));
+    const __m128i right = _mm_packs_epi32(_mm_load_si128(reinterpret_cast<const __m128i*>(&right_samples[word])),
+                                          _mm_load_si128(reinterpret_cast<const __m128i*>(&right_samples[word + 4])));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(&out_samples[word * 2]), _mm_unpacklo_epi16(left, right));
+
+    // Last vector only has four frames in it.
+    if (word < (WORDS_PER_BLOCK - 4))
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(&out_samples[word * 2 + 8]), _mm_unpackhi_epi16(left, right));
+  }
+#elif defined(CPU_AARCH64)
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word += 4)
+  {
+    int16x4x2_t frames;
+    frames.val[0] = vqmovn_s32(vld1q_s32(&left_samples[word]));
+    frames.val[1] = vqmovn_s32(vld1q_s32(&right_samples[word]));
+    vst2_s16(&out_samples[word * 2], frames);
+  }
+#else
+  for (u32 word = 0; word < WORDS_PER_BLOCK; word++)
+  {
+    out_samples[word * 2] = static_cast<s16>(std::clamp<s32>(left_samples[word], -0x8000, 0x7FFF));
+    out_samples[word * 2 + 1] = static_cast<s16>(std::clamp<s32>(right_samples[word], -0x8000, 0x7FFF));
+  }
+#endif
+}
+
 template<bool IS_STEREO, bool IS_8BIT>
 static void DecodeXA_ADPCMChunk(const u8* chunk_ptr, s16* samples, s32* last_samples)
 {
   // The data layout is annoying here. Each word of data is interleaved with the other blocks, requiring multiple
-  // passes to decode the whole chunk.
+  // passes to decode the whole chunk. Each block is unpacked, filtered, and then saturated separately, so that only
+  // the filter has to be done a sample at a time.
   constexpr u32 NUM_BLOCKS = IS_8BIT ? 4 : 8;
-  constexpr u32 WORDS_PER_BLOCK = 28;
 
   const u8* headers_ptr = chunk_ptr + 4;
   const u8* words_ptr = chunk_ptr + 16;
 
+  alignas(16) s32 block_samples[NUM_BLOCKS][PADDED_WORDS_PER_BLOCK];
   for (u32 block = 0; block < NUM_BLOCKS; block++)
   {
     const XA_ADPCMBlockHeader block_header{headers_ptr[block]};
-    const u8 shift = block_header.GetShift();
-    const u8 filter = block_header.GetFilter();
-    const s32 filter_pos = s_xa_adpcm_filter_table_pos[filter];
-    const s32 filter_neg = s_xa_adpcm_filter_table_neg[filter];
-
-    s16* out_samples_ptr =
-      IS_STEREO ? &samples[(block / 2) * (WORDS_PER_BLOCK * 2) + (block % 2)] : &samples[block * WORDS_PER_BLOCK];
-    constexpr u32 out_samples_increment = IS_STEREO ? 2 : 1;
-
-    for (u32 word = 0; word < 28; word++)
-    {
-      // NOTE: assumes LE
-      u32 word_data;
-      std::memcpy(&word_data, &words_ptr[word * sizeof(u32)], sizeof(word_data));
-
-      // extract nibble from block
-      const u32 nibble = IS_8BIT ? ((word_data >> (block * 8)) & 0xFF) : ((word_data >> (block * 4)) & 0x0F);
-      const s16 sample = static_cast<s16>(Truncate16(nibble << 12)) >> shift;
-
-      // mix in previous values
-      s32* prev = IS_STEREO ? &last_samples[(block & 1) * 2] : last_samples;
-      const s32 interp_sample = s32(sample) + ((prev[0] * filter_pos) + (prev[1] * filter_neg) + 32) / 64;
-
-      // update previous values
-      prev[1] = prev[0];
-      prev[0] = interp_sample;
-
-      *out_samples_ptr = static_cast<s16>(std::clamp<s32>(interp_sample, -0x8000, 0x7FFF));
-      out_samples_ptr += out_samples_increment;
-    }
+    UnpackXA_ADPCMBlock<IS_8BIT>(words_ptr, block, block_header.GetShift(), block_samples[block]);
+
+    // Stereo blocks alternate between left and right, which have their own previous values.
+    s32* prev = IS_STEREO ? &last_samples[(block & 1) * 2] : last_samples;
+    FilterXA_ADPCMBlock(block_samples[block], block_header.GetFilter(), prev);
+  }
+
+  if constexpr (IS_STEREO)
+  {
+    for (u32 block = 0; block < NUM_BLOCKS; block += 2)
+      StoreXA_ADPCMStereoBlocks(block_samples[block], block_samples[block + 1], &samples[block * WORDS_PER_BLOCK]);
+  }
+  else
+  {
+    for (u32 block = 0; block < NUM_BLOCKS; block++)
+      StoreXA_ADPCMMonoBlock(block_samples[block], &samples[block * WORDS_PER_BLOCK]);
   }
 }
 
@@ -0,0 +1,349 @@
+#include "compressed_block_cache.h"
+#include "cd_image.h"
+#include "common/log.h"
+#include "common/progress_callback.h"
+#include "common/thirdparty/thread_pool.h"
+#include "common/timer.h"
+#include <algorithm>
+#include <cstring>
+#include <new>
+Log_SetChannel(CompressedBlockCache);
+
+// How many blocks after the last one read the precache workers look at first.
+static constexpr u32 PRECACHE_PRIORITY_BLOCKS = 8;
+
+static std::atomic<u32> s_cache_block_count{0};
+static std::atomic<u32> s_prefetch_block_count{0};
+
+void CDImage::SetBlockCacheParameters(u32 cache_blocks, u32 prefetch_blocks)
+{
+  s_cache_block_count.store(cache_blocks);
+  s_prefetch_block_count.store(prefetch_blocks);
+}
+
+CompressedBlockCache::CompressedBlockCache() = default;
+
+CompressedBlockCache::~CompressedBlockCache()
+{
+  Clear();
+
+  const u32 lookups = m_hits + m_misses;
+  if (lookups > 0)
+  {
+    Log_InfoPrintf("%u hits (%u prefetched, %u waited on), %u misses, %.1f%% hit rate", m_hits, m_prefetch_hits,
+                   m_prefetch_waits, m_misses, (static_cast<double>(m_hits) * 100.0) / static_cast<double>(lookups));
+  }
+}
+
+void CompressedBlockCache::Initialize(u32 block_size, u32 block_count, DecompressFunction decompress)
+{
+  Clear();
+
+  m_block_size = block_size;
+  m_block_count = block_count;
+  m_decompress = std::move(decompress);
+  m_prefetch_count = m_decompress ? s_prefetch_block_count.load() : 0;
+
+  // prefetched blocks have to stay cached until they're read
+  const u32 cache_size = s_cache_block_count.load();
+  if (cache_size > 0 || m_prefetch_count > 0)
+    m_cache.SetMaxCapacity(std::max(cache_size, m_prefetch_count + 1));
+  else
+    m_cache.SetMaxCapacity(0);
+}
+
+void CompressedBlockCache::Clear()
+{
+  // drain any outstanding prefetches, they can't be cancelled once a worker has picked them up
+  if (m_prefetch_pool)
+  {
+    m_prefetch_shutdown.store(true);
+    m_prefetch_pool.reset();
+    m_prefetch_shutdown.store(false);
+  }
+
+  if (m_precache_pool)
+  {
+    m_precache_shutdown.store(true);
+    m_precache_pool.reset();
+    m_precache_shutdown.store(false);
+  }
+
+  m_precache_states.reset();
+  m_precache_buffer.reset();
+  m_cache.Clear();
+  m_last_block_index = static_cast<u32>(-1);
+}
+
+bool CompressedBlockCache::StartPrecache()
+{
+  if (!m_decompress || m_block_count == 0)
+    return false;
+
+  Clear();
+
+  const size_t buffer_size = static_cast<size_t>(m_block_size) * m_block_count;
+  m_precache_buffer.reset(new (std::nothrow) u8[buffer_size]);
+  m_precache_states.reset(new (std::nothrow) std::atomic<PrecacheState>[m_block_count]);
+  if (!m_precache_buffer || !m_precache_states)
+  {
+    Log_ErrorPrintf("Failed to allocate %zu bytes for precaching", buffer_size);
+    m_precache_states.reset();
+    m_precache_buffer.reset();
+    return false;
+  }
+
+  for (u32 i = 0; i < m_block_count; i++)
+    m_precache_states[i].store(PrecacheState::Empty, std::memory_order_relaxed);
+
+  m_precache_next_block.store(0);
+  m_precache_priority_block.store(0);
+  m_precache_remaining_blocks.store(m_block_count);
+  m_precache_start_time = Common::Timer::GetCurrentValue();
+
+  // leave some cores for the emulator, since it's booting at the same time
+  const u32 num_workers = std::max(cb::ThreadPool::GetNumLogicalCores() / 2, 1u);
+  Log_InfoPrintf("Precaching %u blocks (%zu bytes) on %u workers", m_block_count, buffer_size, num_workers);
+  m_precache_pool = std::make_unique<cb::ThreadPool>(static_cast<int>(num_workers));
+  for (u32 i = 0; i < num_workers; i++)
+    m_precache_pool->Schedule([this]() { PrecacheWorker(); });
+
+  return true;
+}
+
+bool CompressedBlockCache::WaitForPrecache(ProgressCallback* progress)
+{
+  if (!m_precache_states)
+    return false;
+
+  progress->SetProgressRange(m_block_count);
+
+  // the callback is only updated from this thread, workers just wake it up
+  u32 remaining_blocks = m_precache_remaining_blocks.load();
+  while (remaining_blocks > 0)
+  {
+    progress->SetProgressValue(m_block_count - remaining_blocks);
+
+    std::unique_lock lock(m_mutex);
+    m_cv.wait(lock, [this, remaining_blocks]() { return m_precache_remaining_blocks.load() != remaining_blocks; });
+    remaining_blocks = m_precache_remaining_blocks.load();
+  }
+  progress->SetProgressValue(m_block_count);
+
+  for (u32 i = 0; i < m_block_count; i++)
+  {
+    if (m_precache_states[i].load() != PrecacheState::Ready)
+      return false;
+  }
+
+  return true;
+}
+
+bool CompressedBlockCache::Lookup(u32 block_index, u8* dst)
+{
+  if (m_precache_buffer)
+    return LookupPrecached(block_index, dst);
+
+  std::unique_lock lock(m_mutex);
+  const CachedBlockPtr* block_ptr = m_cache.Lookup(block_index);
+  if (block_ptr)
+  {
+    const CachedBlockPtr block = *block_ptr;
+    if (block->pending)
+    {
+      m_prefetch_waits++;
+      m_cv.wait(lock, [&block]() { return !block->pending; });
+    }
+
+    // failed prefetches are treated as a miss, so the reader reports the error
+    if (block->valid)
+    {
+      m_hits++;
+      if (block->prefetched)
+      {
+        m_prefetch_hits++;
+        block->prefetched = false;
+      }
+
+      std::memcpy(dst, block->data.data(), m_block_size);
+      lock.unlock();
+      QueuePrefetch(block_index);
+      return true;
+    }
+  }
+
+  m_misses++;
+  return false;
+}
+
+void CompressedBlockCache::Insert(u32 block_index, const u8* data)
+{
+  // only failed blocks miss when precaching, and retrying them on the next read is fine
+  if (m_precache_buffer)
+    return;
+
+  CachedBlockPtr block = std::make_shared<CachedBlock>();
+  block->data.assign(data, data + m_block_size);
+  block->pending = false;
+  block->valid = true;
+  block->prefetched = false;
+
+  {
+    std::unique_lock lock(m_mutex);
+    m_cache.Insert(block_index, std::move(block));
+  }
+
+  QueuePrefetch(block_index);
+}
+
+void CompressedBlockCache::QueuePrefetch(u32 block_index)
+{
+  // only read ahead once two consecutive blocks have been read in the same direction
+  const u32 last_block_index = m_last_block_index;
+  m_last_block_index = block_index;
+  if (m_prefetch_count == 0 || last_block_index == static_cast<u32>(-1))
+    return;
+
+  s32 direction;
+  if (block_index == (last_block_index + 1))
+    direction = 1;
+  else if ((block_index + 1) == last_block_index)
+    direction = -1;
+  else
+    return;
+
+  std::unique_lock lock(m_mutex);
+  for (u32 i = 1; i <= m_prefetch_count; i++)
+  {
+    const s64 next_block_index = static_cast<s64>(block_index) + static_cast<s64>(direction) * static_cast<s64>(i);
+    if (next_block_index < 0 || next_block_index >= static_cast<s64>(m_block_count))
+      break;
+
+    const u32 prefetch_block_index = static_cast<u32>(next_block_index);
+    if (m_cache.Lookup(prefetch_block_index))
+      continue;
+
+    CachedBlockPtr block = std::make_shared<CachedBlock>();
+    block->data.resize(m_block_size);
+    block->pending = true;
+    block->valid = false;
+    block->prefetched = true;
+    m_cache.Insert(prefetch_block_index, block);
+
+    if (!m_prefetch_pool)
+    {
+      const u32 num_workers = std::min(m_prefetch_count, std::max(cb::ThreadPool::GetNumLogicalCores() / 2, 1u));
+      Log_DevPrintf("Starting %u prefetch workers", num_workers);
+      m_prefetch_pool = std::make_unique<cb::ThreadPool>(static_cast<int>(num_workers));
+    }
+
+    m_prefetch_pool->Schedule(
+      [this, prefetch_block_index, block = std::move(block)]() { PrefetchBlock(prefetch_block_index, block); });
+  }
+}
+
+bool CompressedBlockCache::LookupPrecached(u32 block_index, u8* dst)
+{
+  if (block_index >= m_block_count)
+    return false;
+
+  // point the workers at what's likely to be read next
+  m_precache_priority_block.store(block_index + 1);
+
+  std::atomic<PrecacheState>& state = m_precache_states[block_index];
+  PrecacheState current_state = state.load();
+  if (current_state == PrecacheState::Empty)
+  {
+    // not reached yet, so decompress it ourselves rather than waiting for a worker
+    PrecacheBlock(block_index);
+    m_misses++;
+    current_state = state.load();
+  }
+  else
+  {
+    if (current_state == PrecacheState::Decompressing)
+    {
+      std::unique_lock lock(m_mutex);
+      m_prefetch_waits++;
+      m_cv.wait(lock, [&state]() { return (state.load() != PrecacheState::Decompressing); });
+      current_state = state.load();
+    }
+
+    m_hits++;
+    m_prefetch_hits++;
+  }
+
+  // failed blocks are treated as a miss, so the reader reports the error
+  if (current_state != PrecacheState::Ready)
+    return false;
+
+  std::memcpy(dst, &m_precache_buffer[static_cast<size_t>(block_index) * m_block_size], m_block_size);
+  return true;
+}
+
+bool CompressedBlockCache::PrecacheBlock(u32 block_index)
+{
+  std::atomic<PrecacheState>& state = m_precache_states[block_index];
+  PrecacheState expected = PrecacheState::Empty;
+  if (!state.compare_exchange_strong(expected, PrecacheState::Decompressing))
+    return false;
+
+  const bool result =
+    m_decompress(block_index, &m_precache_buffer[static_cast<size_t>(block_index) * m_block_size]);
+  if (!result)
+    Log_ErrorPrintf("Failed to precache block %u", block_index);
+
+  u32 remaining_blocks;
+  {
+    std::unique_lock lock(m_mutex);
+    state.store(result ? PrecacheState::Ready : PrecacheState::Failed);
+    remaining_blocks = m_precache_remaining_blocks.fetch_sub(1) - 1;
+  }
+  m_cv.notify_all();
+
+  if (remaining_blocks == 0)
+  {
+    Log_InfoPrintf("Precached %u blocks in %.2f ms", m_block_count,
+                   Common::Timer::ConvertValueToMilliseconds(Common::Timer::GetCurrentValue() - m_precache_start_time));
+  }
+
+  return true;
+}
+
+void CompressedBlockCache::PrecacheWorker()
+{
+  while (!m_precache_shutdown.load())
+  {
+    // blocks just after the reader come first, then everything else in order
+    const u32 priority_block = m_precache_priority_block.load();
+    bool claimed = false;
+    for (u32 i = 0; i < PRECACHE_PRIORITY_BLOCKS && (priority_block + i) < m_block_count; i++)
+    {
+      if (PrecacheBlock(priority_block + i))
+      {
+        claimed = true;
+        break;
+      }
+    }
+    if (claimed)
+      continue;
+
+    u32 block_index;
+    do
+    {
+      block_index = m_precache_next_block.fetch_add(1);
+      if (block_index >= m_block_count)
+        return;
+    } while (!PrecacheBlock(block_index));
+  }
+}
+
+void CompressedBlockCache::PrefetchBlock(u32 block_index, const CachedBlockPtr& block)
+{
+  const bool result = !m_prefetch_shutdown.load() && m_decompress(block_index, block->data.data());
+
+  std::unique_lock lock(m_mutex);
+  block->pending = false;
+  block->valid = result;
+  m_cv.notify_all();
+}
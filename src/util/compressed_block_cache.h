@@ -0,0 +1,104 @@
+#pragma once
+#include "common/lru_cache.h"
+#include "common/types.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class ProgressCallback;
+
+namespace cb {
+class ThreadPool;
+}
+
+// LRU cache of decompressed blocks for compressed disc images. Once reads go sequential, the blocks following them
+// are decompressed in parallel on a thread pool, so they're ready by the time the reader gets there.
+// For preloading, the whole image can instead be decompressed into memory in the background, while it's being read.
+class CompressedBlockCache
+{
+public:
+  /// Decompresses a block on a worker thread. Has to be safe to call from several workers at once.
+  using DecompressFunction = std::function<bool(u32 block_index, u8* dst)>;
+
+  CompressedBlockCache();
+  ~CompressedBlockCache();
+
+  ALWAYS_INLINE bool IsEnabled() const { return (m_cache.GetMaxCapacity() > 0 || m_precache_buffer); }
+
+  /// Sizes the cache with the parameters from CDImage::SetBlockCacheParameters(). Leaving decompress empty disables
+  /// prefetching, and the cache stays disabled entirely if both sizes are zero.
+  void Initialize(u32 block_size, u32 block_count, DecompressFunction decompress);
+
+  /// Waits for any outstanding prefetches and stops precaching, then drops all cached blocks.
+  void Clear();
+
+  /// Starts decompressing every block into memory on a thread pool. Lookups are served from it as soon as their block
+  /// is ready, and move the workers to the blocks following them. Fails if the memory can't be allocated.
+  bool StartPrecache();
+
+  /// Blocks until every block has been precached, reporting the progress. Returns false if any block failed.
+  bool WaitForPrecache(ProgressCallback* progress);
+
+  /// Copies a cached block to dst, waiting for it if a worker is still decompressing it.
+  bool Lookup(u32 block_index, u8* dst);
+
+  /// Adds a block which the reader had to decompress itself.
+  void Insert(u32 block_index, const u8* data);
+
+private:
+  struct CachedBlock
+  {
+    std::vector<u8> data;
+
+    // Protected by m_mutex. Pending blocks are still being decompressed by a worker.
+    bool pending;
+    bool valid;
+    bool prefetched;
+  };
+  using CachedBlockPtr = std::shared_ptr<CachedBlock>;
+
+  enum class PrecacheState : u8
+  {
+    Empty,
+    Decompressing,
+    Ready,
+    Failed
+  };
+
+  void QueuePrefetch(u32 block_index);
+  void PrefetchBlock(u32 block_index, const CachedBlockPtr& block);
+
+  bool LookupPrecached(u32 block_index, u8* dst);
+  bool PrecacheBlock(u32 block_index);
+  void PrecacheWorker();
+
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  LRUCache<u32, CachedBlockPtr> m_cache{0};
+  DecompressFunction m_decompress;
+  u32 m_block_size = 0;
+  u32 m_block_count = 0;
+  u32 m_prefetch_count = 0;
+  u32 m_last_block_index = static_cast<u32>(-1);
+
+  std::unique_ptr<cb::ThreadPool> m_prefetch_pool;
+  std::atomic_bool m_prefetch_shutdown{false};
+
+  // Workers claim blocks by moving them from Empty to Decompressing, the reader can claim them too.
+  std::unique_ptr<u8[]> m_precache_buffer;
+  std::unique_ptr<std::atomic<PrecacheState>[]> m_precache_states;
+  std::unique_ptr<cb::ThreadPool> m_precache_pool;
+  std::atomic<u32> m_precache_next_block{0};
+  std::atomic<u32> m_precache_priority_block{0};
+  std::atomic<u32> m_precache_remaining_blocks{0};
+  std::atomic_bool m_precache_shutdown{false};
+  u64 m_precache_start_time = 0;
+
+  u32 m_hits = 0;
+  u32 m_misses = 0;
+  u32 m_prefetch_hits = 0;
+  u32 m_prefetch_waits = 0;
+};
@@ -0,0 +1,93 @@
+#pragma once
+#include "common/types.h"
+
+// DCI is DuckStation's own compressed image format. Unique sectors are packed into small frames which are compressed
+// independently, so any sector can be read by decompressing a single frame, and frames can be decompressed in parallel.
+// Each sector on the disc maps to a unique sector through the sector map, which is how identical sectors are shared.
+// EDC/ECC doesn't compress, so it's zeroed in data sectors where it can be regenerated when the frame is decompressed.
+namespace DCI {
+
+enum : u32
+{
+  FILE_VERSION = 1u,
+  DEFAULT_SECTORS_PER_FRAME = 8u,
+  MAX_SECTORS_PER_FRAME = 256u
+};
+
+enum class Codec : u8
+{
+  Stored,
+  Deflate, // Raw deflate stream.
+  LZMA     // 5 bytes of encoded properties, then the raw LZMA stream without an end marker.
+};
+
+#pragma pack(push, 1)
+
+struct FileHeader
+{
+  u8 magic[4]; // "DCI\x1A"
+  u32 version;
+  u32 sectors_per_frame;
+  u32 lba_count;           // Length of the disc, not including the lead-out.
+  u32 sector_count;        // Number of entries in the sector map, i.e. sectors which are stored in the file.
+  u32 unique_sector_count; // Number of sectors in the frames.
+  u32 frame_count;
+  u32 track_count;
+  u32 index_count;
+  u32 subq_count;
+  u64 frame_table_offset;
+  u64 sector_map_offset; // u32 unique sector index for each stored sector.
+  u64 track_table_offset;
+  u64 index_table_offset;
+  u64 subq_table_offset;
+  u64 ecc_map_offset; // Bit for each unique sector, set if its EDC/ECC was zeroed and has to be regenerated.
+};
+static_assert(sizeof(FileHeader) == 88);
+
+struct FrameEntry
+{
+  u64 offset;
+  u32 size;
+  u8 codec;
+  u8 reserved[3];
+};
+static_assert(sizeof(FrameEntry) == 16);
+
+struct TrackEntry
+{
+  u32 track_number;
+  u32 start_lba;
+  u32 first_index;
+  u32 length;
+  u8 mode;
+  u8 control;
+  u8 reserved[2];
+};
+static_assert(sizeof(TrackEntry) == 20);
+
+struct IndexEntry
+{
+  u32 first_sector; // Offset into the sector map, if the index is stored.
+  u32 start_lba_on_disc;
+  u32 track_number;
+  u32 index_number;
+  s32 start_lba_in_track;
+  u32 length;
+  u8 mode;
+  u8 control;
+  u8 is_pregap;
+  u8 is_stored; // Pregaps which aren't in the source image and the lead-out have no sector data.
+};
+static_assert(sizeof(IndexEntry) == 28);
+
+// Sub-channel Q which differs from what would be generated from the TOC, sorted by LBA.
+struct SubChannelQEntry
+{
+  u32 lba;
+  u8 data[12];
+};
+static_assert(sizeof(SubChannelQEntry) == 16);
+
+#pragma pack(pop)
+
+} // namespace DCI
@@ -1,21 +1,78 @@
 #include "iso_reader.h"
 #include "cd_image.h"
+#include "common/file_system.h"
 #include "common/log.h"
+#include "xxhash.h"
 #include <cctype>
+#include <ctime>
+#include <mutex>
+#include <unordered_map>
 Log_SetChannel(ISOReader);
 
-static bool FilenamesEqual(const char* a, const char* b, u32 length)
+struct ISOReader::Directory
 {
-  u32 pos = 0;
-  for (; pos < length && *a != '\0' && *b != '\0'; pos++)
+  // lowercase names, files without the version
+  std::unordered_map<std::string, ISODirectoryEntry> entries;
+
+  // original names of the files, in directory order
+  std::vector<std::string> files;
+};
+
+struct ISOReader::DirectoryIndex
+{
+  std::mutex mutex;
+
+  // keyed by the location of the directory record
+  std::unordered_map<u32, std::unique_ptr<Directory>> directories;
+};
+
+namespace {
+struct FileStamp
+{
+  s64 size;
+  std::time_t modification_time;
+
+  bool operator==(const FileStamp& rhs) const
   {
-    if (std::tolower(*(a++)) != std::tolower(*(b++)))
-      return false;
+    return (size == rhs.size && modification_time == rhs.modification_time);
   }
+  bool operator!=(const FileStamp& rhs) const { return !operator==(rhs); }
+};
 
-  return true;
+struct DirectoryIndexCacheEntry
+{
+  std::string path;
+  std::string patch_path;
+  FileStamp file_stamp;
+  FileStamp patch_stamp;
+  u32 sub_image;
+  u32 track_number;
+  u64 pvd_hash;
+  std::shared_ptr<void> index;
+};
+} // namespace
+
+// game list scans and the achievements/database lookups open several readers for the same disc in a row
+static constexpr u32 MAX_CACHED_DIRECTORY_INDICES = 16;
+static std::mutex s_directory_index_cache_mutex;
+static std::vector<DirectoryIndexCacheEntry> s_directory_index_cache;
+
+static FileStamp GetFileStamp(const std::string& path)
+{
+  FILESYSTEM_STAT_DATA sd;
+  if (path.empty() || !FileSystem::StatFile(path.c_str(), &sd))
+    return FileStamp{-1, 0};
+
+  return FileStamp{sd.Size, sd.ModificationTime};
 }
 
+static std::string GetLookupName(const char* name, u32 length)
+{
+  std::string ret(name, length);
+  for (char& ch : ret)
+    ch = static_cast<char>(std::tolower(static_cast<unsigned char>(ch)));
+  return ret;
+}
 ISOReader::ISOReader() = default;
 
 ISOReader::~ISOReader() = default;
@@ -27,6 +84,39 @@ bool ISOReader::Open(CDImage* image, u32 track_number)
   if (!ReadPVD())
     return false;
 
+  // share the parsed directories with other readers of the same disc, patched images and replaced files differ from
+  // it even if the PVD matches
+  const std::string& path = image->GetFileName();
+  const std::string& patch_path = image->GetPatchFileName();
+  const FileStamp file_stamp = GetFileStamp(path);
+  const FileStamp patch_stamp = GetFileStamp(patch_path);
+  const u32 sub_image = image->GetCurrentSubImage();
+  const u64 pvd_hash = XXH64(&m_pvd, sizeof(m_pvd), 0);
+
+  std::unique_lock lock(s_directory_index_cache_mutex);
+  for (auto iter = s_directory_index_cache.begin(); iter != s_directory_index_cache.end(); ++iter)
+  {
+    if (iter->pvd_hash != pvd_hash || iter->track_number != track_number || iter->sub_image != sub_image ||
+        iter->file_stamp != file_stamp || iter->patch_stamp != patch_stamp || iter->path != path ||
+        iter->patch_path != patch_path)
+    {
+      continue;
+    }
+
+    // move to the back, so the least recently used index gets evicted first
+    DirectoryIndexCacheEntry entry = std::move(*iter);
+    s_directory_index_cache.erase(iter);
+    m_index = std::static_pointer_cast<DirectoryIndex>(entry.index);
+    s_directory_index_cache.push_back(std::move(entry));
+    return true;
+  }
+
+  if (s_directory_index_cache.size() == MAX_CACHED_DIRECTORY_INDICES)
+    s_directory_index_cache.erase(s_directory_index_cache.begin());
+
+  m_index = std::make_shared<DirectoryIndex>();
+  s_directory_index_cache.push_back(
+    DirectoryIndexCacheEntry{path, patch_path, file_stamp, patch_stamp, sub_image, track_number, pvd_hash, m_index});
   return true;
 }
 
@@ -60,8 +150,6 @@ bool ISOReader::ReadPVD()
 
 std::optional<ISOReader::ISODirectoryEntry> ISOReader::LocateFile(const char* path)
 {
-  u8 sector_buffer[SECTOR_SIZE];
-
   const ISODirectoryEntry* root_de = reinterpret_cast<const ISODirectoryEntry*>(m_pvd.root_directory_entry);
   if (*path == '\0' || std::strcmp(path, "/") == 0)
   {
@@ -70,29 +158,68 @@ std::optional<ISOReader::ISODirectoryEntry> ISOReader::LocateFile(const char* pa
   }
 
   // start at the root directory
-  return LocateFile(path, sector_buffer, root_de->location_le, root_de->length_le);
+  ISODirectoryEntry de = *root_de;
+  const char* path_component_start = path;
+  for (;;)
+  {
+    // strip any leading slashes
+    while (*path_component_start == '/' || *path_component_start == '\\')
+      path_component_start++;
+    if (*path_component_start == '\0')
+      break;
+
+    const char* path_component_end = path_component_start;
+    while (*path_component_end != '\0' && *path_component_end != '/' && *path_component_end != '\\')
+      path_component_end++;
+
+    if (!(de.flags & ISODirectoryEntryFlag_Directory))
+    {
+      // we're looking for a directory but got a file
+      Log_ErrorPrintf("Looking for directory but got file");
+      return std::nullopt;
+    }
+
+    const Directory* dir = GetDirectory(de);
+    if (!dir)
+      return std::nullopt;
+
+    const u32 path_component_length = static_cast<u32>(path_component_end - path_component_start);
+    const auto iter = dir->entries.find(GetLookupName(path_component_start, path_component_length));
+    if (iter == dir->entries.end())
+    {
+      std::string temp(path_component_start, path_component_length);
+      Log_ErrorPrintf("Path component '%s' not found", temp.c_str());
+      return std::nullopt;
+    }
+
+    de = iter->second;
+    path_component_start = path_component_end;
+  }
+
+  return de;
 }
 
-std::optional<ISOReader::ISODirectoryEntry> ISOReader::LocateFile(const char* path, u8* sector_buffer,
-                                                                  u32 directory_record_lba, u32 directory_record_size)
+const ISOReader::Directory* ISOReader::GetDirectory(const ISODirectoryEntry& de)
 {
-  if (directory_record_size == 0)
-  {
-    Log_ErrorPrintf("Directory entry record size 0 while looking for '%s'", path);
-    return std::nullopt;
-  }
+  std::unique_lock lock(m_index->mutex);
+  auto iter = m_index->directories.find(de.location_le);
+  if (iter != m_index->directories.end())
+    return iter->second.get();
 
-  // strip any leading slashes
-  const char* path_component_start = path;
-  while (*path_component_start == '/' || *path_component_start == '\\')
-    path_component_start++;
+  std::unique_ptr<Directory> dir = std::make_unique<Directory>();
+  if (!ParseDirectory(dir.get(), de.location_le, de.length_le))
+    return nullptr;
 
-  u32 path_component_length = 0;
-  const char* path_component_end = path_component_start;
-  while (*path_component_end != '\0' && *path_component_end != '/' && *path_component_end != '\\')
+  iter = m_index->directories.emplace(de.location_le, std::move(dir)).first;
+  return iter->second.get();
+}
+
+bool ISOReader::ParseDirectory(Directory* dir, u32 directory_record_lba, u32 directory_record_size)
+{
+  if (directory_record_size == 0)
   {
-    path_component_length++;
-    path_component_end++;
+    Log_ErrorPrintf("Directory entry record size 0 at LBA %u", directory_record_lba);
+    return false;
   }
 
   // start reading directory entries
@@ -100,15 +227,16 @@ std::optional<ISOReader::ISODirectoryEntry> ISOReader::LocateFile(const char* pa
   if (!m_image->Seek(m_track_number, directory_record_lba))
   {
     Log_ErrorPrintf("Seek to LBA %u failed", directory_record_lba);
-    return std::nullopt;
+    return false;
   }
 
+  u8 sector_buffer[SECTOR_SIZE];
   for (u32 i = 0; i < num_sectors; i++)
   {
     if (m_image->Read(CDImage::ReadMode::DataOnly, 1, sector_buffer) != 1)
     {
       Log_ErrorPrintf("Failed to read LBA %u", directory_record_lba + i);
-      return std::nullopt;
+      return false;
     }
 
     u32 sector_offset = 0;
@@ -129,132 +257,72 @@ std::optional<ISOReader::ISODirectoryEntry> ISOReader::LocateFile(const char* pa
       if (de->filename_length == 1 && (*de_filename == '\x0' || *de_filename == '\x1'))
         continue;
 
-      // check filename length
-      if (de->filename_length < path_component_length)
-        continue;
-
+      // directories don't have the version, the first entry with a name wins like a sequential search would
       if (de->flags & ISODirectoryEntryFlag_Directory)
       {
-        // directories don't have the version? so check the length instead
-        if (de->filename_length != path_component_length ||
-            !FilenamesEqual(de_filename, path_component_start, path_component_length))
-        {
-          continue;
-        }
+        dir->entries.emplace(GetLookupName(de_filename, de->filename_length), *de);
+        continue;
       }
-      else
+
+      // strip off terminator/file version
+      const char* terminator = static_cast<const char*>(std::memchr(de_filename, ';', de->filename_length));
+      if (!terminator)
       {
-        // compare filename
-        if (!FilenamesEqual(de_filename, path_component_start, path_component_length) ||
-            de_filename[path_component_length] != ';')
-        {
-          continue;
-        }
+        std::string filename(de_filename, de->filename_length);
+        Log_ErrorPrintf("Invalid filename '%s'", filename.c_str());
+        continue;
       }
 
-      // found it. is this the file we're looking for?
-      if (*path_component_end == '\0')
-        return *de;
-
-      // if it is a directory, recurse into it
-      if (de->flags & ISODirectoryEntryFlag_Directory)
-        return LocateFile(path_component_end, sector_buffer, de->location_le, de->length_le);
+      const u32 name_length = static_cast<u32>(terminator - de_filename);
+      if (name_length == 0)
+        continue;
 
-      // we're looking for a directory but got a file
-      Log_ErrorPrintf("Looking for directory but got file");
-      return std::nullopt;
+      if (dir->entries.emplace(GetLookupName(de_filename, name_length), *de).second)
+        dir->files.emplace_back(de_filename, name_length);
     }
   }
 
-  std::string temp(path_component_start, path_component_length);
-  Log_ErrorPrintf("Path component '%s' not found", temp.c_str());
-  return std::nullopt;
+  return true;
 }
 
 std::vector<std::string> ISOReader::GetFilesInDirectory(const char* path)
 {
   std::string base_path = path;
-  u32 directory_record_lba;
-  u32 directory_record_length;
+  ISODirectoryEntry directory_de;
   if (base_path.empty())
   {
     // root directory
-    const ISODirectoryEntry* root_de = reinterpret_cast<const ISODirectoryEntry*>(m_pvd.root_directory_entry);
-    directory_record_lba = root_de->location_le;
-    directory_record_length = root_de->length_le;
+    directory_de = *reinterpret_cast<const ISODirectoryEntry*>(m_pvd.root_directory_entry);
   }
   else
   {
-    auto directory_de = LocateFile(base_path.c_str());
-    if (!directory_de)
+    auto de = LocateFile(base_path.c_str());
+    if (!de)
     {
       Log_ErrorPrintf("Directory entry not found for '%s'", path);
       return {};
     }
 
-    if ((directory_de->flags & ISODirectoryEntryFlag_Directory) == 0)
+    if ((de->flags & ISODirectoryEntryFlag_Directory) == 0)
     {
       Log_ErrorPrintf("Path '%s' is not a directory, can't list", path);
       return {};
     }
 
-    directory_record_lba = directory_de->location_le;
-    directory_record_length = directory_de->length_le;
+    directory_de = de.value();
 
     if (base_path[base_path.size() - 1] != '/')
       base_path += '/';
   }
 
-  // start reading directory entries
-  const u32 num_sectors = (directory_record_length + (SECTOR_SIZE - 1)) / SECTOR_SIZE;
-  if (!m_image->Seek(m_track_number, directory_record_lba))
-  {
-    Log_ErrorPrintf("Seek to LBA %u failed", directory_record_lba);
+  const Directory* dir = GetDirectory(directory_de);
+  if (!dir)
     return {};
-  }
 
   std::vector<std::string> files;
-  u8 sector_buffer[SECTOR_SIZE];
-  for (u32 i = 0; i < num_sectors; i++)
-  {
-    if (m_image->Read(CDImage::ReadMode::DataOnly, 1, sector_buffer) != 1)
-    {
-      Log_ErrorPrintf("Failed to read LBA %u", directory_record_lba + i);
-      break;
-    }
-
-    u32 sector_offset = 0;
-    while ((sector_offset + sizeof(ISODirectoryEntry)) < SECTOR_SIZE)
-    {
-      const ISODirectoryEntry* de = reinterpret_cast<const ISODirectoryEntry*>(&sector_buffer[sector_offset]);
-      const char* de_filename =
-        reinterpret_cast<const char*>(&sector_buffer[sector_offset + sizeof(ISODirectoryEntry)]);
-      if ((sector_offset + de->entry_length) > SECTOR_SIZE || de->filename_length > de->entry_length ||
-          de->entry_length < sizeof(ISODirectoryEntry))
-      {
-        break;
-      }
-
-      sector_offset += de->entry_length;
-
-      // skip current/parent directory
-      if (de->filename_length == 1 && (*de_filename == '\x0' || *de_filename == '\x1'))
-        continue;
-
-      // strip off terminator/file version
-      std::string filename(de_filename, de->filename_length);
-      std::string::size_type pos = filename.rfind(';');
-      if (pos == std::string::npos)
-      {
-        Log_ErrorPrintf("Invalid filename '%s'", filename.c_str());
-        continue;
-      }
-      filename.erase(pos);
-
-      if (!filename.empty())
-        files.push_back(base_path + filename);
-    }
-  }
+  files.reserve(dir->files.size());
+  for (const std::string& filename : dir->files)
+    files.push_back(base_path + filename);
 
   return files;
 }
@@ -135,6 +135,8 @@ public:
   ALWAYS_INLINE u32 GetTrackNumber() const { return m_track_number; }
   ALWAYS_INLINE const ISOPrimaryVolumeDescriptor& GetPVD() const { return m_pvd; }
 
+  /// Opens the filesystem in the specified track. Readers opened on the same disc share their parsed directories, so
+  /// repeated lookups in the same image don't read the directory records again.
   bool Open(CDImage* image, u32 track_number);
 
   std::vector<std::string> GetFilesInDirectory(const char* path);
@@ -142,14 +144,19 @@ public:
   bool ReadFile(const char* path, std::vector<u8>* data);
 
 private:
+  struct Directory;
+  struct DirectoryIndex;
+
   bool ReadPVD();
 
   std::optional<ISODirectoryEntry> LocateFile(const char* path);
-  std::optional<ISODirectoryEntry> LocateFile(const char* path, u8* sector_buffer, u32 directory_record_lba,
-                                              u32 directory_record_size);
+  const Directory* GetDirectory(const ISODirectoryEntry& de);
+  bool ParseDirectory(Directory* dir, u32 directory_record_lba, u32 directory_record_size);
 
   CDImage* m_image;
   u32 m_track_number;
 
   ISOPrimaryVolumeDescriptor m_pvd = {};
+
+  std::shared_ptr<DirectoryIndex> m_index;
 };
\ No newline at end of file
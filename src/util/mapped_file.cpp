@@ -0,0 +1,183 @@
+#include "mapped_file.h"
+#include "common/log.h"
+#include "common/progress_callback.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <limits>
+Log_SetChannel(MappedFile);
+
+#if defined(_WIN32)
+#include "common/windows_headers.h"
+#include <io.h>
+#else
+#include <cerrno>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// How far ahead of sequential reads pages are hinted. A refill is issued once half of the window has been read.
+static constexpr u64 READAHEAD_WINDOW_SIZE = 256 * 1024;
+
+static constexpr u64 TOUCH_PAGE_SIZE = 4096;
+static constexpr u64 TOUCH_PROGRESS_CHUNK_SIZE = 4 * 1024 * 1024;
+
+MappedFile::MappedFile() = default;
+
+MappedFile::MappedFile(MappedFile&& move)
+  : m_data(move.m_data), m_size(move.m_size), m_next_read_offset(move.m_next_read_offset),
+    m_hinted_end(move.m_hinted_end)
+{
+#ifdef _WIN32
+  m_mapping_handle = move.m_mapping_handle;
+  move.m_mapping_handle = nullptr;
+#endif
+  move.m_data = nullptr;
+  move.m_size = 0;
+}
+
+MappedFile::~MappedFile()
+{
+  Unmap();
+}
+
+bool MappedFile::Map(std::FILE* fp)
+{
+  Unmap();
+
+#if defined(_WIN32)
+  const HANDLE file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(fp)));
+  LARGE_INTEGER file_size;
+  if (file_handle == INVALID_HANDLE_VALUE || !GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0 ||
+      static_cast<u64>(file_size.QuadPart) > std::numeric_limits<size_t>::max())
+  {
+    return false;
+  }
+
+#ifndef _UWP
+  HANDLE mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+#else
+  HANDLE mapping_handle = CreateFileMappingFromApp(file_handle, nullptr, PAGE_READONLY, 0, nullptr);
+#endif
+  if (!mapping_handle)
+  {
+    Log_WarningPrintf("CreateFileMapping() failed: %u", GetLastError());
+    return false;
+  }
+
+#ifndef _UWP
+  const void* data = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+#else
+  const void* data = MapViewOfFileFromApp(mapping_handle, FILE_MAP_READ, 0, 0);
+#endif
+  if (!data)
+  {
+    Log_WarningPrintf("MapViewOfFile() failed: %u", GetLastError());
+    CloseHandle(mapping_handle);
+    return false;
+  }
+
+  m_mapping_handle = mapping_handle;
+  m_data = static_cast<const u8*>(data);
+  m_size = static_cast<u64>(file_size.QuadPart);
+#else
+  const int fd = fileno(fp);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0 || st.st_size <= 0 ||
+      static_cast<u64>(st.st_size) > std::numeric_limits<size_t>::max())
+  {
+    return false;
+  }
+
+  void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+  if (data == MAP_FAILED)
+  {
+    Log_WarningPrintf("mmap() failed: %d", errno);
+    return false;
+  }
+
+  m_data = static_cast<const u8*>(data);
+  m_size = static_cast<u64>(st.st_size);
+#endif
+
+  m_next_read_offset = 0;
+  m_hinted_end = 0;
+  return true;
+}
+
+void MappedFile::Unmap()
+{
+  if (!m_data)
+    return;
+
+#if defined(_WIN32)
+  UnmapViewOfFile(m_data);
+  CloseHandle(m_mapping_handle);
+  m_mapping_handle = nullptr;
+#else
+  munmap(const_cast<u8*>(m_data), static_cast<size_t>(m_size));
+#endif
+
+  m_data = nullptr;
+  m_size = 0;
+}
+
+bool MappedFile::Read(void* dst, u64 offset, u32 size)
+{
+  if (offset >= m_size || (m_size - offset) < size)
+    return false;
+
+  // only hint once reads go sequential, isolated seeks aren't worth the syscall
+  if (offset != m_next_read_offset)
+  {
+    m_hinted_end = 0;
+  }
+  else if ((offset + (READAHEAD_WINDOW_SIZE / 2)) > m_hinted_end)
+  {
+    const u64 hint_size = std::min(READAHEAD_WINDOW_SIZE, m_size - offset);
+    HintWillNeed(offset, hint_size);
+    m_hinted_end = offset + hint_size;
+  }
+
+  std::memcpy(dst, m_data + offset, size);
+  m_next_read_offset = offset + size;
+  return true;
+}
+
+bool MappedFile::TouchAllPages(ProgressCallback* progress)
+{
+  HintWillNeed(0, m_size);
+
+  progress->SetProgressRange(static_cast<u32>((m_size + TOUCH_PROGRESS_CHUNK_SIZE - 1) / TOUCH_PROGRESS_CHUNK_SIZE));
+  progress->SetProgressValue(0);
+
+  // the sum is only there so the loads can't be optimized out
+  u8 sum = 0;
+  for (u64 chunk_start = 0; chunk_start < m_size; chunk_start += TOUCH_PROGRESS_CHUNK_SIZE)
+  {
+    if (progress->IsCancelled())
+      return false;
+
+    const u64 chunk_end = std::min(chunk_start + TOUCH_PROGRESS_CHUNK_SIZE, m_size);
+    for (u64 offset = chunk_start; offset < chunk_end; offset += TOUCH_PAGE_SIZE)
+      sum += *static_cast<const volatile u8*>(m_data + offset);
+
+    progress->IncrementProgressValue();
+  }
+
+  Log_DevPrintf("Touched %" PRIu64 " bytes (%02X)", m_size, sum);
+  return true;
+}
+
+void MappedFile::HintWillNeed(u64 offset, u64 size)
+{
+  // PrefetchVirtualMemory() needs Windows 8, so there we rely on the cache manager's own readahead.
+#ifndef _WIN32
+  // madvise() needs a page-aligned start
+  static const u64 page_mask = static_cast<u64>(sysconf(_SC_PAGESIZE)) - 1;
+  const u64 aligned_offset = offset & ~page_mask;
+  madvise(const_cast<u8*>(m_data) + aligned_offset, static_cast<size_t>(size + (offset - aligned_offset)),
+          MADV_WILLNEED);
+#endif
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "common/types.h"
+#include <cstdio>
+
+class ProgressCallback;
+
+// Read-only mapping of a whole file. Reads become copies out of the page cache, instead of seeks and reads through
+// stdio buffers.
+class MappedFile
+{
+public:
+  MappedFile();
+  MappedFile(MappedFile&& move);
+  ~MappedFile();
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ALWAYS_INLINE bool IsValid() const { return (m_data != nullptr); }
+  ALWAYS_INLINE const u8* GetData() const { return m_data; }
+  ALWAYS_INLINE u64 GetSize() const { return m_size; }
+
+  /// Maps the file which fp refers to. fp does not have to stay open afterwards.
+  bool Map(std::FILE* fp);
+  void Unmap();
+
+  /// Copies size bytes from offset. Returns false if the range is past the end of the file.
+  /// Sequential reads keep a window ahead of them hinted to the OS, so the pages are read in before they're needed.
+  bool Read(void* dst, u64 offset, u32 size);
+
+  /// Faults in every page of the file, so later reads don't have to wait on the disk.
+  bool TouchAllPages(ProgressCallback* progress);
+
+private:
+  void HintWillNeed(u64 offset, u64 size);
+
+  const u8* m_data = nullptr;
+  u64 m_size = 0;
+  u64 m_next_read_offset = 0;
+  u64 m_hinted_end = 0;
+
+#ifdef _WIN32
+  void* m_mapping_handle = nullptr;
+#endif
+};
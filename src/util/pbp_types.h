@@ -13,6 +13,7 @@ enum : u32
   TOC_NUM_ENTRIES = 102u,
   BLOCK_TABLE_NUM_ENTRIES = 32256u,
   DISC_TABLE_NUM_ENTRIES = 5u,
+  SECTORS_PER_BLOCK = 16u,
   DECOMPRESSED_BLOCK_SIZE = 37632u // 2352 bytes per sector * 16 sectors per block
 };
 
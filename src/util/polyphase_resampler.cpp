@@ -0,0 +1,272 @@
+#include "polyphase_resampler.h"
+#include "common/assert.h"
+#include "common/platform.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+
+namespace {
+struct QualityParameters
+{
+  u32 num_taps;
+  u32 phase_bits;
+  float rolloff;
+  float kaiser_beta;
+};
+} // namespace
+
+static constexpr std::array<QualityParameters, static_cast<size_t>(PolyphaseResampler::Quality::Count)>
+  s_quality_parameters = {{
+    {8, 6, 0.80f, 5.0f},  // Low
+    {16, 7, 0.88f, 7.0f}, // Medium
+    {32, 8, 0.92f, 9.0f}, // High
+  }};
+
+static double BesselI0(double x)
+{
+  // Power series, converges quickly for the beta values we use.
+  double sum = 1.0;
+  double term = 1.0;
+  const double half_x_squared = (x * 0.5) * (x * 0.5);
+  for (u32 k = 1; k < 32; k++)
+  {
+    term *= half_x_squared / static_cast<double>(k * k);
+    sum += term;
+    if (term < (sum * 1e-12))
+      break;
+  }
+
+  return sum;
+}
+
+ALWAYS_INLINE static s16 FilterSample(const s16* samples, const s16* coefficients, u32 num_taps)
+{
+#if defined(CPU_X64)
+  __m128i acc = _mm_setzero_si128();
+  for (u32 i = 0; i < num_taps; i += 8)
+  {
+    const __m128i s = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&samples[i]));
+    const __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&coefficients[i]));
+    acc = _mm_add_epi32(acc, _mm_madd_epi16(s, c));
+  }
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+  acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+  const s32 sum = _mm_cvtsi128_si32(acc);
+#elif defined(CPU_AARCH64)
+  int32x4_t acc = vdupq_n_s32(0);
+  for (u32 i = 0; i < num_taps; i += 8)
+  {
+    const int16x8_t s = vld1q_s16(&samples[i]);
+    const int16x8_t c = vld1q_s16(&coefficients[i]);
+    acc = vmlal_s16(acc, vget_low_s16(s), vget_low_s16(c));
+    acc = vmlal_high_s16(acc, s, c);
+  }
+  const s32 sum = vaddvq_s32(acc);
+#else
+  s32 sum = 0;
+  for (u32 i = 0; i < num_taps; i++)
+    sum += static_cast<s32>(samples[i]) * static_cast<s32>(coefficients[i]);
+#endif
+
+  return static_cast<s16>(std::clamp<s32>((sum + (1 << 14)) >> 15, -32768, 32767));
+}
+
+PolyphaseResampler::PolyphaseResampler() = default;
+
+PolyphaseResampler::~PolyphaseResampler() = default;
+
+void PolyphaseResampler::Configure(u32 channels, Quality quality)
+{
+  const QualityParameters& params = s_quality_parameters[static_cast<size_t>(quality)];
+  DebugAssert(params.num_taps <= MAX_TAPS && (params.num_taps % 8) == 0);
+
+  m_channels = channels;
+  m_quality = quality;
+  m_num_taps = params.num_taps;
+  m_phase_bits = params.phase_bits;
+  m_buffer.resize(channels * CHANNEL_STRIDE);
+
+  // Force the filter to be rebuilt.
+  m_cutoff = 0.0f;
+  SetRates(1, 1);
+  Reset();
+}
+
+void PolyphaseResampler::SetRates(u32 input_rate, u32 output_rate)
+{
+  const u64 step = (static_cast<u64>(input_rate) << 32) / output_rate;
+  m_step_int = static_cast<u32>(step >> 32);
+  m_step_frac = static_cast<u32>(step);
+
+  // When downsampling, the cutoff has to move down with the output's nyquist frequency.
+  const QualityParameters& params = s_quality_parameters[static_cast<size_t>(m_quality)];
+  const float cutoff =
+    params.rolloff * std::min(1.0f, static_cast<float>(output_rate) / static_cast<float>(input_rate));
+  if (cutoff != m_cutoff)
+  {
+    m_cutoff = cutoff;
+    BuildFilter();
+  }
+}
+
+void PolyphaseResampler::Reset()
+{
+  // Prime with enough silence that the first output frame is centered on the first input frame.
+  m_buffered_frames = (m_num_taps / 2) - 1;
+  m_position = 0;
+  m_position_frac = 0;
+  std::fill(m_buffer.begin(), m_buffer.end(), static_cast<s16>(0));
+}
+
+void PolyphaseResampler::BuildFilter()
+{
+  const QualityParameters& params = s_quality_parameters[static_cast<size_t>(m_quality)];
+  const u32 num_phases = 1u << m_phase_bits;
+  const double center = static_cast<double>(m_num_taps / 2 - 1);
+  const double half_width = static_cast<double>(m_num_taps / 2);
+  const double cutoff = static_cast<double>(m_cutoff);
+  const double inv_i0_beta = 1.0 / BesselI0(params.kaiser_beta);
+  constexpr double pi = 3.14159265358979323846;
+
+  m_coefficients.resize(num_phases * m_num_taps);
+
+  std::array<double, MAX_TAPS> taps;
+  for (u32 phase = 0; phase < num_phases; phase++)
+  {
+    // Phases are selected by truncating the position, so build each one for the middle of its range.
+    const double frac = (static_cast<double>(phase) + 0.5) / static_cast<double>(num_phases);
+
+    double sum = 0.0;
+    for (u32 i = 0; i < m_num_taps; i++)
+    {
+      const double t = static_cast<double>(i) - center - frac;
+      const double x = t / half_width;
+      const double window =
+        (std::abs(x) < 1.0) ? (BesselI0(params.kaiser_beta * std::sqrt(1.0 - x * x)) * inv_i0_beta) : 0.0;
+      const double sinc = (t == 0.0) ? 1.0 : (std::sin(pi * cutoff * t) / (pi * cutoff * t));
+      taps[i] = cutoff * sinc * window;
+      sum += taps[i];
+    }
+
+    // Normalize to unity gain, and put any rounding error into the largest tap so DC passes through exactly.
+    s16* coefficients = &m_coefficients[phase * m_num_taps];
+    s32 int_sum = 0;
+    u32 largest = 0;
+    for (u32 i = 0; i < m_num_taps; i++)
+    {
+      coefficients[i] = static_cast<s16>(std::lround((taps[i] / sum) * 32768.0));
+      int_sum += coefficients[i];
+      if (std::abs(coefficients[i]) > std::abs(coefficients[largest]))
+        largest = i;
+    }
+    coefficients[largest] = static_cast<s16>(std::min<s32>(coefficients[largest] + (32768 - int_sum), 32767));
+  }
+}
+
+void PolyphaseResampler::CompactBuffer()
+{
+  if (m_position >= m_buffered_frames)
+  {
+    // Downsampling can step past everything we have. The remainder is skipped from the next input.
+    m_position -= m_buffered_frames;
+    m_buffered_frames = 0;
+    return;
+  }
+
+  if (m_position == 0)
+    return;
+
+  const u32 remaining = m_buffered_frames - m_position;
+  for (u32 channel = 0; channel < m_channels; channel++)
+  {
+    s16* channel_buffer = &m_buffer[channel * CHANNEL_STRIDE];
+    std::memmove(channel_buffer, channel_buffer + m_position, sizeof(s16) * remaining);
+  }
+
+  m_buffered_frames = remaining;
+  m_position = 0;
+}
+
+void PolyphaseResampler::FillBuffer(const s16* in, u32 num_frames)
+{
+  if (m_channels == 2)
+  {
+    s16* left = &m_buffer[m_buffered_frames];
+    s16* right = &m_buffer[CHANNEL_STRIDE + m_buffered_frames];
+    for (u32 i = 0; i < num_frames; i++)
+    {
+      left[i] = in[i * 2 + 0];
+      right[i] = in[i * 2 + 1];
+    }
+  }
+  else
+  {
+    for (u32 channel = 0; channel < m_channels; channel++)
+    {
+      s16* channel_buffer = &m_buffer[channel * CHANNEL_STRIDE + m_buffered_frames];
+      for (u32 i = 0; i < num_frames; i++)
+        channel_buffer[i] = in[i * m_channels + channel];
+    }
+  }
+
+  m_buffered_frames += num_frames;
+}
+
+bool PolyphaseResampler::Process(const s16* in, u32 in_frames, s16* out, u32 out_frames, u32* in_frames_used,
+                                 u32* out_frames_generated)
+{
+  const u32 phase_shift = 32 - m_phase_bits;
+  u32 consumed = 0;
+  u32 generated = 0;
+
+  for (;;)
+  {
+    while (generated < out_frames && (m_position + m_num_taps) <= m_buffered_frames)
+    {
+      const s16* coefficients = &m_coefficients[(m_position_frac >> phase_shift) * m_num_taps];
+      for (u32 channel = 0; channel < m_channels; channel++)
+        *(out++) = FilterSample(&m_buffer[channel * CHANNEL_STRIDE + m_position], coefficients, m_num_taps);
+      generated++;
+
+      const u32 old_frac = m_position_frac;
+      m_position_frac += m_step_frac;
+      m_position += m_step_int + static_cast<u32>(m_position_frac < old_frac);
+    }
+
+    if (generated == out_frames || consumed == in_frames)
+      break;
+
+    CompactBuffer();
+
+    // Input we've already stepped over doesn't need to be buffered.
+    if (m_position > 0)
+    {
+      DebugAssert(m_buffered_frames == 0);
+      const u32 skip = std::min(m_position, in_frames - consumed);
+      m_position -= skip;
+      consumed += skip;
+      in += skip * m_channels;
+      continue;
+    }
+
+    const u32 count = std::min(in_frames - consumed, CHANNEL_STRIDE - m_buffered_frames);
+    FillBuffer(in, count);
+    consumed += count;
+    in += count * m_channels;
+  }
+
+  *in_frames_used = consumed;
+  *out_frames_generated = generated;
+  return (consumed > 0 || generated > 0);
+}
@@ -0,0 +1,64 @@
+#pragma once
+#include "common/types.h"
+#include <vector>
+
+// Windowed-sinc polyphase resampler operating directly on interleaved signed 16-bit samples.
+// Coefficients are stored as Q15 fixed point, so the filtering is done entirely in integer arithmetic.
+class PolyphaseResampler
+{
+public:
+  enum class Quality : u8
+  {
+    Low,
+    Medium,
+    High,
+    Count
+  };
+
+  PolyphaseResampler();
+  ~PolyphaseResampler();
+
+  ALWAYS_INLINE u32 GetChannels() const { return m_channels; }
+  ALWAYS_INLINE Quality GetQuality() const { return m_quality; }
+
+  void Configure(u32 channels, Quality quality);
+  void SetRates(u32 input_rate, u32 output_rate);
+  void Reset();
+
+  /// Resamples up to in_frames of input into at most out_frames of output. Input which is not consumed must be passed
+  /// again on the next call. Returns false if nothing could be consumed or produced.
+  bool Process(const s16* in, u32 in_frames, s16* out, u32 out_frames, u32* in_frames_used, u32* out_frames_generated);
+
+private:
+  enum : u32
+  {
+    MAX_TAPS = 32,
+    BUFFER_FRAMES = 1024,
+    CHANNEL_STRIDE = BUFFER_FRAMES + MAX_TAPS,
+  };
+
+  void BuildFilter();
+  void CompactBuffer();
+  void FillBuffer(const s16* in, u32 num_frames);
+
+  u32 m_channels = 0;
+  Quality m_quality = Quality::Medium;
+  u32 m_num_taps = 0;
+  u32 m_phase_bits = 0;
+  float m_cutoff = 0.0f;
+
+  // 32.32 fixed point step through the input per output frame.
+  u32 m_step_int = 1;
+  u32 m_step_frac = 0;
+
+  // Position of the first tap of the next output frame within the buffered input.
+  u32 m_position = 0;
+  u32 m_position_frac = 0;
+
+  // Input is kept deinterleaved, so each channel's taps are contiguous for the dot product.
+  u32 m_buffered_frames = 0;
+  std::vector<s16> m_buffer;
+
+  // [phase][tap], each phase padded to a multiple of 8 taps.
+  std::vector<s16> m_coefficients;
+};
@@ -0,0 +1,206 @@
+#include "time_stretcher.h"
+#include "common/assert.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// Lengths in milliseconds. Longer sequences sound smoother for music, but echo more at high tempos.
+static constexpr u32 SEQUENCE_MS = 50;
+static constexpr u32 OVERLAP_MS = 10;
+static constexpr u32 SEEK_MS = 15;
+
+// The best offset is found on every Nth position first, then refined around that.
+static constexpr u32 COARSE_SEEK_STEP = 4;
+
+static constexpr float MIN_TEMPO = 0.1f;
+static constexpr float MAX_TEMPO = 10.0f;
+
+TimeStretcher::TimeStretcher() = default;
+
+TimeStretcher::~TimeStretcher() = default;
+
+void TimeStretcher::Configure(u32 sample_rate, u32 channels)
+{
+  m_channels = channels;
+  m_sequence_frames = (sample_rate * SEQUENCE_MS) / 1000;
+  m_overlap_frames = (sample_rate * OVERLAP_MS) / 1000;
+  m_seek_frames = (sample_rate * SEEK_MS) / 1000;
+  DebugAssert(m_sequence_frames > (m_overlap_frames * 2));
+
+  m_input.resize((m_seek_frames + m_sequence_frames) * 2 * channels);
+  m_overlap_buffer.resize(m_overlap_frames * channels);
+  m_output.resize(m_sequence_frames * channels);
+  Reset();
+}
+
+void TimeStretcher::SetTempo(float tempo)
+{
+  m_tempo = std::clamp(tempo, MIN_TEMPO, MAX_TEMPO);
+}
+
+void TimeStretcher::Reset()
+{
+  m_skip_fraction = 0.0;
+  m_pending_skip_frames = 0;
+  m_input_frames = 0;
+  m_first_sequence = true;
+  m_output_frames = 0;
+  m_output_position = 0;
+  std::fill(m_overlap_buffer.begin(), m_overlap_buffer.end(), static_cast<s16>(0));
+}
+
+s64 TimeStretcher::GetOverlapCorrelation(u32 offset) const
+{
+  const s16* input = &m_input[offset * m_channels];
+  const u32 num_samples = m_overlap_frames * m_channels;
+  s64 sum = 0;
+  for (u32 i = 0; i < num_samples; i++)
+    sum += static_cast<s32>(m_overlap_buffer[i]) * static_cast<s32>(input[i]);
+
+  return sum;
+}
+
+s64 TimeStretcher::GetOverlapEnergy(u32 offset) const
+{
+  const s16* input = &m_input[offset * m_channels];
+  const u32 num_samples = m_overlap_frames * m_channels;
+  s64 sum = 0;
+  for (u32 i = 0; i < num_samples; i++)
+    sum += static_cast<s32>(input[i]) * static_cast<s32>(input[i]);
+
+  return sum;
+}
+
+u32 TimeStretcher::FindBestOverlapOffset() const
+{
+  // Normalized cross-correlation between the previous sequence's tail and the candidate position.
+  const auto GetScore = [this](u32 offset) {
+    return static_cast<double>(GetOverlapCorrelation(offset)) /
+           std::sqrt(static_cast<double>(GetOverlapEnergy(offset)) + 1.0);
+  };
+
+  u32 best_offset = 0;
+  double best_score = GetScore(0);
+  for (u32 offset = COARSE_SEEK_STEP; offset < m_seek_frames; offset += COARSE_SEEK_STEP)
+  {
+    const double score = GetScore(offset);
+    if (score > best_score)
+    {
+      best_score = score;
+      best_offset = offset;
+    }
+  }
+
+  const u32 coarse_offset = best_offset;
+  const u32 refine_start = (coarse_offset >= COARSE_SEEK_STEP) ? (coarse_offset - COARSE_SEEK_STEP + 1) : 0;
+  const u32 refine_end = std::min(coarse_offset + COARSE_SEEK_STEP, m_seek_frames);
+  for (u32 offset = refine_start; offset < refine_end; offset++)
+  {
+    if (offset == coarse_offset)
+      continue;
+
+    const double score = GetScore(offset);
+    if (score > best_score)
+    {
+      best_score = score;
+      best_offset = offset;
+    }
+  }
+
+  return best_offset;
+}
+
+void TimeStretcher::ProcessSequence()
+{
+  const u32 offset = m_first_sequence ? 0 : FindBestOverlapOffset();
+  const s16* input = &m_input[offset * m_channels];
+  s16* output = m_output.data();
+  m_first_sequence = false;
+
+  // Cross-fade from the tail of the previous sequence.
+  const s32 overlap = static_cast<s32>(m_overlap_frames);
+  for (s32 i = 0; i < overlap; i++)
+  {
+    for (u32 channel = 0; channel < m_channels; channel++)
+    {
+      const u32 index = static_cast<u32>(i) * m_channels + channel;
+      output[index] = static_cast<s16>((static_cast<s32>(m_overlap_buffer[index]) * (overlap - i) +
+                                        static_cast<s32>(input[index]) * i) /
+                                       overlap);
+    }
+  }
+
+  // Middle is passed through untouched, and the tail is kept for the next cross-fade.
+  const u32 middle_frames = m_sequence_frames - (m_overlap_frames * 2);
+  std::memcpy(&output[m_overlap_frames * m_channels], &input[m_overlap_frames * m_channels],
+              sizeof(s16) * middle_frames * m_channels);
+  std::memcpy(m_overlap_buffer.data(), &input[(m_sequence_frames - m_overlap_frames) * m_channels],
+              sizeof(s16) * m_overlap_frames * m_channels);
+
+  m_output_frames = m_sequence_frames - m_overlap_frames;
+  m_output_position = 0;
+
+  // Step through the input at the tempo, keeping the fractional part so the average rate is exact.
+  const double skip = static_cast<double>(m_tempo) * static_cast<double>(m_output_frames) + m_skip_fraction;
+  const u32 skip_frames = static_cast<u32>(skip);
+  m_skip_fraction = skip - static_cast<double>(skip_frames);
+  if (skip_frames >= m_input_frames)
+  {
+    m_pending_skip_frames = skip_frames - m_input_frames;
+    m_input_frames = 0;
+  }
+  else
+  {
+    m_input_frames -= skip_frames;
+    std::memmove(m_input.data(), &m_input[skip_frames * m_channels], sizeof(s16) * m_input_frames * m_channels);
+  }
+}
+
+bool TimeStretcher::Process(const s16* in, u32 in_frames, s16* out, u32 out_frames, u32* in_frames_used,
+                            u32* out_frames_generated)
+{
+  const u32 input_capacity = static_cast<u32>(m_input.size()) / m_channels;
+  const u32 required_input_frames = m_seek_frames + m_sequence_frames;
+  u32 consumed = 0;
+  u32 generated = 0;
+
+  for (;;)
+  {
+    if (m_output_position < m_output_frames)
+    {
+      const u32 count = std::min(out_frames - generated, m_output_frames - m_output_position);
+      std::memcpy(&out[generated * m_channels], &m_output[m_output_position * m_channels],
+                  sizeof(s16) * count * m_channels);
+      m_output_position += count;
+      generated += count;
+      if (generated == out_frames)
+        break;
+    }
+
+    if (m_input_frames >= required_input_frames)
+    {
+      ProcessSequence();
+      continue;
+    }
+
+    if (consumed == in_frames)
+      break;
+
+    if (m_pending_skip_frames > 0)
+    {
+      const u32 count = std::min(m_pending_skip_frames, in_frames - consumed);
+      m_pending_skip_frames -= count;
+      consumed += count;
+      continue;
+    }
+
+    const u32 count = std::min(in_frames - consumed, input_capacity - m_input_frames);
+    std::memcpy(&m_input[m_input_frames * m_channels], &in[consumed * m_channels], sizeof(s16) * count * m_channels);
+    m_input_frames += count;
+    consumed += count;
+  }
+
+  *in_frames_used = consumed;
+  *out_frames_generated = generated;
+  return (consumed > 0 || generated > 0);
+}
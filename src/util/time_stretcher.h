@@ -0,0 +1,52 @@
+#pragma once
+#include "common/types.h"
+#include <vector>
+
+// WSOLA (waveform similarity overlap-add) time stretcher, operating on interleaved signed 16-bit samples.
+// Changes the tempo of the input without changing its pitch, by splicing together overlapping sequences at the points
+// where the waveforms line up best.
+class TimeStretcher
+{
+public:
+  TimeStretcher();
+  ~TimeStretcher();
+
+  ALWAYS_INLINE u32 GetChannels() const { return m_channels; }
+  ALWAYS_INLINE float GetTempo() const { return m_tempo; }
+
+  void Configure(u32 sample_rate, u32 channels);
+  void SetTempo(float tempo);
+  void Reset();
+
+  /// Stretches up to in_frames of input into at most out_frames of output. Input which is not consumed must be passed
+  /// again on the next call. Returns false if nothing could be consumed or produced.
+  bool Process(const s16* in, u32 in_frames, s16* out, u32 out_frames, u32* in_frames_used, u32* out_frames_generated);
+
+private:
+  u32 FindBestOverlapOffset() const;
+  s64 GetOverlapCorrelation(u32 offset) const;
+  s64 GetOverlapEnergy(u32 offset) const;
+  void ProcessSequence();
+
+  u32 m_channels = 0;
+  u32 m_sequence_frames = 0;
+  u32 m_overlap_frames = 0;
+  u32 m_seek_frames = 0;
+
+  float m_tempo = 1.0f;
+  double m_skip_fraction = 0.0;
+
+  // Input frames which still have to be skipped, when the tempo steps past what we've buffered.
+  u32 m_pending_skip_frames = 0;
+
+  std::vector<s16> m_input;
+  u32 m_input_frames = 0;
+
+  // Tail of the previous sequence, which the next one is cross-faded with.
+  std::vector<s16> m_overlap_buffer;
+  bool m_first_sequence = true;
+
+  std::vector<s16> m_output;
+  u32 m_output_frames = 0;
+  u32 m_output_position = 0;
+};